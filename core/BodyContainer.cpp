@@ -27,6 +27,59 @@ Body::id_t BodyContainer::insert(shared_ptr<Body>& b){
 	return b->id;
 }
 
+Body::id_t BodyContainer::insertBulk(const std::vector<shared_ptr<Body> >& bb){
+	const shared_ptr<Scene>& scene=Omega::instance().getScene();
+	const Body::id_t first=body.size();
+	if(bb.empty()) return first;
+	body.reserve(body.size()+bb.size());
+	FOREACH(const shared_ptr<Body>& b, bb){
+		b->iterBorn=scene->iter;
+		b->timeBorn=scene->time;
+		b->id=body.size();
+		body.push_back(b);
+	}
+	scene->doSort = true;
+	// Notify ForceContainer about the highest new id only
+	scene->forces.addMaxId(body.size()-1);
+	return first;
+}
+
+Body::id_t BodyContainer::insertAtId(const shared_ptr<Body>& b, Body::id_t id){
+	if(id<0) throw std::invalid_argument("BodyContainer::insertAtId: negative id.");
+	if((size_t)id>=body.size()) body.resize(id+1);
+	else if(body[id]) throw std::runtime_error("BodyContainer::insertAtId: body #"+boost::lexical_cast<string>(id)+" already exists.");
+	const shared_ptr<Scene>& scene=Omega::instance().getScene();
+	b->iterBorn=scene->iter;
+	b->timeBorn=scene->time;
+	b->id=id;
+	body[id]=b;
+	scene->doSort=true;
+	scene->forces.addMaxId(id);
+	return id;
+}
+
+void BodyContainer::renumber(const std::vector<Body::id_t>& newIds){
+	assert(newIds.size()==body.size());
+	Body::id_t maxId=-1;
+	FOREACH(Body::id_t id, newIds) maxId=max(maxId,id);
+	ContainerT renumbered(maxId+1);
+	for(size_t id=0; id<body.size(); id++){
+		const shared_ptr<Body>& b=body[id];
+		if(!b) continue;
+		assert(newIds[id]>=0 && !renumbered[newIds[id]]);
+		b->id=newIds[id];
+		if(b->clumpId!=Body::ID_NONE) b->clumpId=newIds[b->clumpId];
+		if(b->shape && b->isClump()){
+			Clump::MemberMap& members=YADE_PTR_CAST<Clump>(b->shape)->members;
+			Clump::MemberMap remapped;
+			FOREACH(const Clump::MemberMap::value_type& m, members) remapped[newIds[m.first]]=m.second;
+			members.swap(remapped);
+		}
+		renumbered[b->id]=b;
+	}
+	body.swap(renumbered);
+}
+
 bool BodyContainer::erase(Body::id_t id, bool eraseClumpMembers){//default is false (as before)
 	if(!body[id]) return false;
 	const shared_ptr<Body>& b=Body::byId(id);
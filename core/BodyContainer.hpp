@@ -54,6 +54,10 @@ class BodyContainer: public Serializable{
 		BodyContainer() {};
 		virtual ~BodyContainer() {};
 		Body::id_t insert(shared_ptr<Body>&);
+		// insert many bodies at once, growing the container and ForceContainer only once; returns id of the first one
+		Body::id_t insertBulk(const std::vector<shared_ptr<Body> >&);
+		// insert body with given id, extending the container if needed; the slot must be empty (used to keep global ids across MPI processes)
+		Body::id_t insertAtId(const shared_ptr<Body>& b, Body::id_t id);
 		void clear();
 		iterator begin() {
 			iterator temp(body.begin()); temp.end=body.end();
@@ -68,6 +72,8 @@ class BodyContainer: public Serializable{
 
 		bool exists(Body::id_t id) const { return (id>=0) && ((size_t)id<body.size()) && ((bool)body[id]); }
 		bool erase(Body::id_t id, bool eraseClumpMembers);
+		//! Move body with id i to newIds[i] (updating Body::id, Body::clumpId and clump members); erased bodies must be mapped to -1. Interactions must be renumbered separately, see InteractionContainer::renumber.
+		void renumber(const std::vector<Body::id_t>& newIds);
 		
 		REGISTER_CLASS_AND_BASE(BodyContainer,Serializable);
 		REGISTER_ATTRIBUTES(Serializable,(body));
@@ -81,6 +81,27 @@ std::string Dispatcher_indexToClassName(int idx){
 	throw runtime_error("No class with index "+boost::lexical_cast<string>(idx)+" found (top-level indexable is "+topName+")");
 }
 
+/*! Return one instance of each class deriving from topIndexable (the top-level indexable itself excluded), used to resolve dense dispatch tables for all class indices.
+Creating the instances assigns indices to classes which were not instantiated before; like Dispatcher_indexToClassName, this is slow and should be only called at setup.
+*/
+template<class topIndexable>
+std::vector<shared_ptr<topIndexable> > Dispatcher_indexablePrototypes(){
+	std::vector<shared_ptr<topIndexable> > ret;
+	boost::scoped_ptr<topIndexable> top(new topIndexable);
+	std::string topName=top->getClassName();
+	typedef std::pair<string,DynlibDescriptor> classItemType;
+	FOREACH(classItemType clss, Omega::instance().getDynlibsDescriptor()){
+		if(!Omega::instance().isInheritingFrom_recursive(clss.first,topName)) continue;
+		shared_ptr<topIndexable> inst=YADE_PTR_DYN_CAST<topIndexable>(ClassFactory::instance().createShared(clss.first));
+		if(inst && inst->getClassIndex()>=0) ret.push_back(inst);
+	}
+	return ret;
+}
+
+//! Return the highest class index assigned in the hierarchy of topIndexable
+template<class topIndexable>
+int Dispatcher_maxClassIndex(){ static boost::scoped_ptr<topIndexable> top(new topIndexable); return top->getMaxCurrentlyUsedClassIndex(); }
+
 //! Return class index of given indexable
 template<typename TopIndexable>
 int Indexable_getClassIndex(const shared_ptr<TopIndexable> i){return i->getClassIndex();}
@@ -149,6 +170,12 @@ class Dispatcher1D : public Dispatcher,
 		typedef DynLibDispatcher<TYPELIST_1(baseClass),FunctorType,typename FunctorType::ReturnType,typename FunctorType::ArgumentTypes,autoSymmetry> dispatcherBase;
 
 		shared_ptr<FunctorType> getFunctor(shared_ptr<baseClass> arg){ return dispatcherBase::getExecutor(arg); }
+		/*! (Re)build the dense dispatch table if functors or class indices changed since it was built; call before dispatching, never from parallel sections. */
+		void updateDispatchTable(){
+			if(dispatcherBase::dispatchTableValid(Dispatcher_maxClassIndex<baseClass>())) return;
+			const std::vector<shared_ptr<baseClass> > protos(Dispatcher_indexablePrototypes<baseClass>());
+			dispatcherBase::buildDispatchTable1D(protos,Dispatcher_maxClassIndex<baseClass>());
+		}
     boost::python::dict dump(bool convertIndicesToNames){
       boost::python::dict ret;
 			FOREACH(const DynLibDispatcher_Item1D& item, dispatcherBase::dataDispatchMatrix1D()){
@@ -200,6 +227,13 @@ class Dispatcher2D : public Dispatcher,
 		typedef FunctorType functorType;
 		typedef DynLibDispatcher<TYPELIST_2(baseClass1,baseClass2),FunctorType,typename FunctorType::ReturnType,typename FunctorType::ArgumentTypes,autoSymmetry> dispatcherBase;
 		shared_ptr<FunctorType> getFunctor(shared_ptr<baseClass1> arg1, shared_ptr<baseClass2> arg2){ return dispatcherBase::getExecutor(arg1,arg2); }
+		/*! (Re)build the dense dispatch table if functors or class indices changed since it was built; call before dispatching, never from parallel sections. */
+		void updateDispatchTable(){
+			if(dispatcherBase::dispatchTableValid(Dispatcher_maxClassIndex<baseClass1>(),Dispatcher_maxClassIndex<baseClass2>())) return;
+			const std::vector<shared_ptr<baseClass1> > protos1(Dispatcher_indexablePrototypes<baseClass1>());
+			const std::vector<shared_ptr<baseClass2> > protos2(Dispatcher_indexablePrototypes<baseClass2>());
+			dispatcherBase::buildDispatchTable2D(protos1,protos2,Dispatcher_maxClassIndex<baseClass1>(),Dispatcher_maxClassIndex<baseClass2>());
+		}
     boost::python::dict dump(bool convertIndicesToNames){
       boost::python::dict ret;
 			FOREACH(const DynLibDispatcher_Item2D& item, dispatcherBase::dataDispatchMatrix2D()){
@@ -5,6 +5,16 @@
 namespace py=boost::python;
 
 class EnergyTracker: public Serializable{
+	// exact parts of energies in the deterministic mode, indexed by thread and energy id (see setExact)
+	std::vector<std::vector<ExactSum<Real> > > exactParts;
+	static int threadNum(){
+		#ifdef YADE_OPENMP
+			return omp_get_thread_num();
+		#else
+			return 0;
+		#endif
+	}
+	void resetExact(int id){ FOREACH(std::vector<ExactSum<Real> >& v, exactParts) v[id].reset(); }
 	public:
 	~EnergyTracker();
 	void findId(const std::string& name, int& id, bool reset=false, bool newIfNotFound=true){
@@ -14,33 +24,68 @@ class EnergyTracker: public Serializable{
 			#ifdef YADE_OPENMP
 				#pragma omp critical
 			#endif
-				{ energies.resize(energies.size()+1); id=energies.size()-1; resetStep.resize(id+1); resetStep[id]=reset; names[name]=id; assert(id<(int)energies.size()); assert(id>=0); }
+				{ energies.resize(energies.size()+1); id=energies.size()-1; resetStep.resize(id+1); resetStep[id]=reset; names[name]=id; assert(id<(int)energies.size()); assert(id>=0); FOREACH(std::vector<ExactSum<Real> >& v, exactParts) v.resize(energies.size()); }
 		}
 	}
 	// set value of the accumulator; note: must NOT be called from parallel sections!
 	void set(const Real& val, const std::string& name, int &id){
 		if(id<0) findId(name,id,/* do not reset value that is set directly */ false);
 		energies.set(id,val);
+		if(exact) resetExact(id);
 	}
 	// add value to the accumulator; safely called from parallel sections
 	void add(const Real& val, const std::string& name, int &id, bool reset=false){
 		if(id<0) findId(name,id,reset);
-		energies.add(id,val);
+		// resettable energies keep their last value in steps where they are not evaluated
+		if(reset && skipResettables) return;
+		if(exact) exactParts[threadNum()][id].add(val);
+		else energies.add(id,val);
+	}
+	// value of one energy; must NOT be called from parallel sections
+	Real get(int id) const {
+		if(!exact) return energies.get(id);
+		ExactSum<Real> sum;
+		FOREACH(const std::vector<ExactSum<Real> >& v, exactParts) sum+=v[id];
+		return energies.get(id)+sum.get();
+	}
+	/* Switch exact summation, which gives the same values regardless of the number of threads (called by Scene at the beginning of every step, according to Scene::deterministic).
+	Current values are moved to the first thread's accumulator, where they stay until reset. */
+	void setExact(bool e){
+		if(e==exact) return;
+		size_t sz=energies.size();
+		for(size_t id=0; id<sz; id++) energies.set(id,get(id));
+		exactParts.clear();
+		#ifdef YADE_OPENMP
+			if(e) exactParts.resize(omp_get_max_threads(),std::vector<ExactSum<Real> >(sz));
+		#else
+			if(e) exactParts.resize(1,std::vector<ExactSum<Real> >(sz));
+		#endif
+		// new energies are usually created from parallel sections; reserve space so that other threads do not write to relocated memory
+		FOREACH(std::vector<ExactSum<Real> >& v, exactParts) v.reserve(max((size_t)32,2*sz));
+		exact=e;
+	}
+	// saved values are those of energies
+	void preSave(EnergyTracker&){
+		if(!exact) return;
+		size_t sz=energies.size();
+		for(size_t id=0; id<sz; id++){ energies.set(id,get(id)); resetExact(id); }
 	}
+	// whether resettable energies are evaluated in step iter; called by ForceResetter, which updates skipResettables accordingly
+	bool resettablesDue(long iter) const { return interval<=1 || iter%interval==0; }
 	Real getItem_py(const std::string& name){
 		int id=-1; findId(name,id,false,false); 
 		if (id<0) {PyErr_SetString(PyExc_KeyError,("Unknown energy name '"+name+"'.").c_str());  py::throw_error_already_set(); }
-		return energies.get(id);
+		return get(id);
 	}
 	void setItem_py(const std::string& name, Real val){
 		int id=-1; set(val,name,id);
 	}
-	void clear(){ energies.clear(); names.clear(); resetStep.clear();}
-	void resetResettables(){ size_t sz=energies.size(); for(size_t id=0; id<sz; id++){ if(resetStep[id]) energies.reset(id); } }
+	void clear(){ energies.clear(); names.clear(); resetStep.clear(); FOREACH(std::vector<ExactSum<Real> >& v, exactParts) v.clear(); }
+	void resetResettables(){ skipResettables=false; size_t sz=energies.size(); for(size_t id=0; id<sz; id++){ if(resetStep[id]){ energies.reset(id); if(exact) resetExact(id); } } }
 
-	Real total() const { Real ret=0; size_t sz=energies.size(); for(size_t id=0; id<sz; id++) ret+=energies.get(id); return ret; };
+	Real total() const { Real ret=0; size_t sz=energies.size(); for(size_t id=0; id<sz; id++) ret+=get(id); return ret; };
 	py::list keys_py() const { py::list ret; FOREACH(pairStringInt p, names) ret.append(p.first); return ret; };
-	py::list items_py() const { py::list ret; FOREACH(pairStringInt p, names) ret.append(py::make_tuple(p.first,energies.get(p.second))); return ret; };
+	py::list items_py() const { py::list ret; FOREACH(pairStringInt p, names) ret.append(py::make_tuple(p.first,get(p.second))); return ret; };
 	py::dict perThreadData() const {
 		py::dict ret;
 		std::vector<std::vector<Real> > dta=energies.getPerThreadData();
@@ -55,6 +100,9 @@ class EnergyTracker: public Serializable{
 		((OpenMPArrayAccumulator<Real>,energies,,,"Energy values, in linear array"))
 		((mapStringInt,names,,Attr::hidden,"Associate textual name to an index in the energies array."))
 		((vector<bool>,resetStep,,Attr::hidden,"Whether the respective energy value should be reset at every step."))
+		((long,interval,1,,"Evaluate resettable (instantaneous) energies, such as kinetic or elastic potential energy, only every *interval* steps; their last value is kept in-between. Incremental energies (dissipation, work of external fields) are still accumulated at every step. Requires :yref:`ForceResetter` in the engine loop."))
+		((bool,exact,false,(Attr::readonly|Attr::noSave),"Whether values are summed exactly, so that they do not depend on the number of threads; set from :yref:`O.deterministic<Omega.deterministic>`."))
+		((bool,skipResettables,false,(Attr::hidden|Attr::noSave),"Set by :yref:`ForceResetter` in steps where resettable energies are not evaluated (see :yref:`interval<EnergyTracker.interval>`); adding to resettable energies is a no-op then."))
 		,/*ctor*/
 		,/*py*/
 			.def("__getitem__",&EnergyTracker::getItem_py,"Get energy value for given name.")
@@ -35,6 +35,10 @@ class Engine: public Serializable{
 			LOG_FATAL("Engine "<<getClassName()<<" calling virtual method Engine::action(). Please submit bug report at http://bugs.launchpad.net/yade.");
 			throw std::logic_error("Engine::action() called.");
 		}
+		/*! Update body ids stored in the engine after bodies were renumbered (see SpatialRenumberer); newIds[i] is the new id of body i, or -1 if it was removed.
+		The default implementation does nothing; engines keeping ids or data indexed by id should override it.
+		*/
+		virtual void renumberBodies(const std::vector<int>& newIds){}
 	private:
 		// py access funcs	
 		TimingInfo::delta timingInfo_nsec_get(){return timingInfo.nsec;};
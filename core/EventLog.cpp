@@ -0,0 +1,186 @@
+// 2026 © Yade developers
+#include<core/EventLog.hpp>
+#include<core/Omega.hpp>
+#include<core/Scene.hpp>
+#include<boost/thread/thread.hpp>
+#include<boost/thread/condition_variable.hpp>
+#include<boost/filesystem/operations.hpp>
+#include<boost/lexical_cast.hpp>
+#include<deque>
+#include<fstream>
+
+CREATE_LOGGER(EventLog);
+
+namespace{
+	struct EventLess{
+		bool operator()(const EventLog::Event& a, const EventLog::Event& b) const {
+			if(a.iter!=b.iter) return a.iter<b.iter;
+			if(a.source!=b.source) return a.source<b.source;
+			if(a.id1!=b.id1) return a.id1<b.id1;
+			if(a.id2!=b.id2) return a.id2<b.id2;
+			return a.type<b.type;
+		}
+	};
+}
+
+/* Background thread appending flushed events to files; jobs are written in the order they were submitted. */
+class EventLogWriter{
+	public:
+	struct Job{
+		vector<EventLog::Event> events;
+		string fileName;
+		vector<string> names;
+		vector<std::pair<string,bool> > textFiles;
+	};
+	private:
+	std::deque<shared_ptr<Job> > jobs;
+	shared_ptr<boost::thread> thread;
+	boost::mutex mutex;
+	boost::condition_variable jobAdded, jobDone;
+	bool busy, stopping;
+	void write(const Job& job){
+		if(!job.fileName.empty()){
+			const bool exists=boost::filesystem::exists(job.fileName) && boost::filesystem::file_size(job.fileName)>0;
+			std::ofstream out(job.fileName.c_str(),std::ios::binary|std::ios::app);
+			if(!exists){
+				boost::uint32_t head[2]={1,sizeof(EventLog::Event)};
+				out.write("YADEEVT1",8); out.write((const char*)head,sizeof(head));
+			}
+			if(!job.events.empty()) out.write((const char*)&job.events[0],job.events.size()*sizeof(EventLog::Event));
+			if(!out) LOG_ERROR("Error writing events to "<<job.fileName);
+			if(!job.names.empty()){
+				std::ofstream src((job.fileName+".sources").c_str(),std::ios::trunc);
+				FOREACH(const string& n, job.names) src<<n<<endl;
+			}
+		}
+		for(size_t s=0; s<job.textFiles.size(); s++){
+			const string& f=job.textFiles[s].first;
+			if(f.empty()) continue;
+			std::ofstream file(f.c_str(),job.textFiles[s].second ? std::ios::trunc : std::ios::app);
+			// same columns as crack files written formerly by Law2_ScGeom_JCFpmPhys_JointedCohesiveFrictionalPM
+			if(file.tellp()==0){ file<<"i p0 p1 p2 t s norm0 norm1 norm2"<<endl; }
+			FOREACH(const EventLog::Event& e, job.events){
+				if(e.source!=(int)s) continue;
+				file<<e.iter<<" "<<boost::lexical_cast<string>(e.pos[0])<<" "<<boost::lexical_cast<string>(e.pos[1])<<" "<<boost::lexical_cast<string>(e.pos[2])<<" "<<e.type<<" "<<boost::lexical_cast<string>(e.size)<<" "<<boost::lexical_cast<string>(e.normal[0])<<" "<<boost::lexical_cast<string>(e.normal[1])<<" "<<boost::lexical_cast<string>(e.normal[2])<<endl;
+			}
+		}
+	}
+	void work(){
+		while(true){
+			shared_ptr<Job> job;
+			{
+				boost::mutex::scoped_lock lock(mutex);
+				while(jobs.empty() && !stopping) jobAdded.wait(lock);
+				if(jobs.empty()) return;
+				job=jobs.front(); jobs.pop_front(); busy=true;
+			}
+			write(*job);
+			boost::mutex::scoped_lock lock(mutex);
+			busy=false; jobDone.notify_all();
+		}
+	}
+	public:
+	EventLogWriter(): busy(false), stopping(false){ thread=shared_ptr<boost::thread>(new boost::thread(boost::bind(&EventLogWriter::work,this))); }
+	~EventLogWriter(){
+		{ boost::mutex::scoped_lock lock(mutex); stopping=true; jobAdded.notify_all(); }
+		thread->join();
+	}
+	void submit(const shared_ptr<Job>& job){ boost::mutex::scoped_lock lock(mutex); jobs.push_back(job); jobAdded.notify_one(); }
+	void wait(){ boost::mutex::scoped_lock lock(mutex); while(!jobs.empty() || busy) jobDone.wait(lock); }
+	DECLARE_LOGGER;
+};
+CREATE_LOGGER(EventLogWriter);
+
+void EventLog::initBuffers(){
+	#ifdef YADE_OPENMP
+		buffers.resize(omp_get_max_threads());
+	#else
+		buffers.resize(1);
+	#endif
+}
+
+// pending events are written before the writer thread exits
+EventLog::~EventLog(){}
+
+void EventLog::findSource(const string& name, int& id, const string& textFile, bool truncate){
+	#ifdef YADE_OPENMP
+		#pragma omp critical(EventLogSources)
+	#endif
+	{
+		boost::mutex::scoped_lock lock(storeMutex);
+		vector<string>::iterator it=std::find(names.begin(),names.end(),name);
+		if(it!=names.end()) id=it-names.begin();
+		else { id=names.size(); names.push_back(name); textFiles.push_back(std::make_pair(string(),false)); }
+		if(!textFile.empty() && textFiles[id].first!=textFile) textFiles[id]=std::make_pair(textFile,truncate);
+	}
+}
+
+namespace{
+	EventLog::Event makeEvent(long iter, Real time, int source, int type, int id1, int id2, const Vector3r& pos, const Vector3r& normal, Real size, Real energy){
+		EventLog::Event e;
+		e.iter=iter; e.time=time; e.source=source; e.type=type; e.id1=id1; e.id2=id2;
+		for(int i=0; i<3; i++){ e.pos[i]=pos[i]; e.normal[i]=normal[i]; }
+		e.size=size; e.energy=energy;
+		return e;
+	}
+}
+
+void EventLog::push(long iter, Real time, int source, int type, int id1, int id2, const Vector3r& pos, const Vector3r& normal, Real size, Real energy){
+	push(makeEvent(iter,time,source,type,id1,id2,pos,normal,size,energy));
+}
+
+void EventLog::flush(){
+	shared_ptr<EventLogWriter::Job> job(new EventLogWriter::Job);
+	vector<Event>& batch=job->events;
+	FOREACH(ThreadBuffer& b, buffers){ batch.insert(batch.end(),b.events.begin(),b.events.end()); b.events.clear(); }
+	{
+		boost::mutex::scoped_lock lock(overflowMutex);
+		batch.insert(batch.end(),overflow.begin(),overflow.end()); overflow.clear();
+	}
+	#ifdef YADE_OPENMP
+		if((int)buffers.size()<omp_get_max_threads()) buffers.resize(omp_get_max_threads());
+	#endif
+	if(batch.empty()) return;
+	std::sort(batch.begin(),batch.end(),EventLess());
+	boost::mutex::scoped_lock lock(storeMutex);
+	if(keepInMemory) stored.insert(stored.end(),batch.begin(),batch.end());
+	bool hasText=false;
+	for(size_t s=0; s<textFiles.size(); s++) if(!textFiles[s].first.empty()) hasText=true;
+	if(fileName.empty() && !hasText) return;
+	job->fileName=fileName;
+	job->names=names; // rewritten with every job, the list is short
+	job->textFiles=textFiles;
+	for(size_t s=0; s<textFiles.size(); s++) textFiles[s].second=false; // truncate only once
+	if(!writer) writer=shared_ptr<EventLogWriter>(new EventLogWriter);
+	writer->submit(job);
+}
+
+void EventLog::waitForWriter(){
+	shared_ptr<EventLogWriter> w;
+	{ boost::mutex::scoped_lock lock(storeMutex); w=writer; }
+	if(w) w->wait();
+}
+
+void EventLog::clear(){ boost::mutex::scoped_lock lock(storeMutex); stored.clear(); }
+
+long EventLog::size() const { boost::mutex::scoped_lock lock(storeMutex); return stored.size(); }
+
+vector<EventLog::Event> EventLog::events(int source) const {
+	boost::mutex::scoped_lock lock(storeMutex);
+	if(source<0) return stored;
+	vector<Event> ret;
+	FOREACH(const Event& e, stored) if(e.source==source) ret.push_back(e);
+	return ret;
+}
+
+boost::python::object EventLog::pyRaw(int source) const {
+	vector<Event> ee=events(source);
+	return boost::python::str(ee.empty() ? "" : (const char*)&ee[0],ee.size()*sizeof(Event));
+}
+
+void EventLog::pyPush(const string& source, int type, int id1, int id2, const Vector3r& pos, const Vector3r& normal, Real size, Real energy){
+	const shared_ptr<Scene>& scene=Omega::instance().getScene();
+	int id=-1; findSource(source,id);
+	// the python thread may run concurrently with the simulation loop, which owns the per-thread buffers
+	pushShared(makeEvent(scene->iter,scene->time,id,type,id1,id2,pos,normal,size,energy));
+}
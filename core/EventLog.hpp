@@ -0,0 +1,80 @@
+// 2026 © Yade developers
+#pragma once
+#include<lib/serialization/Serializable.hpp>
+#include<boost/cstdint.hpp>
+#include<boost/thread/mutex.hpp>
+#ifdef YADE_OPENMP
+	#include<omp.h>
+#endif
+
+class EventLogWriter;
+
+/*! Discrete events (broken bonds, cracks, ...) reported by constitutive laws, in compact fixed-size records.
+
+Records are pushed to per-thread buffers without any locking, so that laws can report them from inside the parallel InteractionLoop. At the end of every step, Scene calls flush(), which merges the buffers in a deterministic order (the order of threads does not matter), keeps the events in memory and hands them to a background thread writing files. Laws never touch the filesystem.
+
+Binary file: "YADEEVT1", uint32 version(=1), uint32 record size, then records (Event, little-endian); names of sources are in fileName.sources, one per line, line number being the source index.
+*/
+class EventLog: public Serializable{
+	public:
+		struct Event{
+			boost::int64_t iter; double time;
+			boost::int32_t source, type, id1, id2;
+			double pos[3], normal[3], size, energy;
+		};
+		//! find (or create) index of source name; id is cached by the caller, like in EnergyTracker::findId; textFile, if given, receives events of this source in the legacy crack text format (truncated first if truncate is set)
+		void findSource(const string& name, int& id, const string& textFile="", bool truncate=false);
+		//! store event in the buffer of the current thread; safe to call from parallel sections of the simulation loop (other threads must use pushShared)
+		void push(const Event& e){
+			#ifdef YADE_OPENMP
+				const size_t t=omp_get_thread_num();
+				if(t<buffers.size()){ buffers[t].events.push_back(e); return; }
+				// threads added after the last flush (omp_set_num_threads) go to the shared buffer
+				pushShared(e);
+			#else
+				buffers[0].events.push_back(e);
+			#endif
+		}
+		void push(long iter, Real time, int source, int type, int id1, int id2, const Vector3r& pos, const Vector3r& normal, Real size, Real energy);
+		//! store event in the shared buffer, under a lock; for threads other than those of the simulation loop (e.g. python)
+		void pushShared(const Event& e){ boost::mutex::scoped_lock lock(overflowMutex); overflow.push_back(e); }
+		//! merge per-thread buffers, store and write events; must NOT be called concurrently with push
+		void flush();
+		//! block until the background writer has written all flushed events
+		void waitForWriter();
+		void clear();
+		long size() const;
+		//! copy of stored events matching source (all if source<0)
+		vector<Event> events(int source=-1) const;
+		~EventLog();
+	private:
+		struct ThreadBuffer{ vector<Event> events; char pad[64]; }; // padding keeps buffer headers of threads in different cache lines
+		vector<ThreadBuffer> buffers;
+		vector<Event> overflow;
+		boost::mutex overflowMutex;
+		vector<Event> stored;
+		vector<string> names;
+		vector<std::pair<string,bool> > textFiles; // file name and truncation flag for each source
+		mutable boost::mutex storeMutex;
+		shared_ptr<EventLogWriter> writer;
+		void initBuffers();
+		boost::python::object pyRaw(int source) const;
+		boost::python::list pySources() const { boost::mutex::scoped_lock lock(storeMutex); boost::python::list ret; FOREACH(const string& n, names) ret.append(n); return ret; }
+		void pyPush(const string& source, int type, int id1, int id2, const Vector3r& pos, const Vector3r& normal, Real size, Real energy);
+	public:
+	DECLARE_LOGGER;
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(EventLog,Serializable,"Log of discrete events, such as bonds broken in :yref:`Law2_ScGeom_JCFpmPhys_JointedCohesiveFrictionalPM`, accessible as :yref:`O.events<Omega.events>`. Each event has iteration, time, source (name of the reporting law), type (meaning defined by the source), ids of the two bodies, position, normal, size and energy. Events are collected by all threads without locking and merged at the end of each step (sorted by source and ids, so that the order does not depend on threads); they can be kept in memory (see :yref:`yade.eventlog.arrays` to get them as numpy arrays) and/or written to a binary file by a background thread (read with :yref:`yade.eventlog.read`). Stored events are not saved with the simulation.",
+		((string,fileName,"",,"Binary file where events are appended (by a background thread); empty for no file. Source names are written to fileName.sources."))
+		((bool,keepInMemory,true,,"Keep events in memory, for :yref:`yade.eventlog.arrays`."))
+		,/*ctor*/ initBuffers();
+		,/*py*/
+		.def("__len__",&EventLog::size,"Number of events stored in memory.")
+		.def("sources",&EventLog::pySources,"Names of sources, in the order of their indices (the ``source`` field of events).")
+		.def("clear",&EventLog::clear,"Remove events stored in memory (files are not touched).")
+		.def("flush",&EventLog::flush,"Merge events reported in the current step; done automatically at the end of every step. Only call it when the simulation is not running (or from a :yref:`PyRunner`).")
+		.def("waitForWriter",&EventLog::waitForWriter,"Block until all events are written to files.")
+		.def("push",&EventLog::pyPush,(boost::python::arg("source"),boost::python::arg("type")=0,boost::python::arg("id1")=-1,boost::python::arg("id2")=-1,boost::python::arg("pos")=Vector3r::Zero(),boost::python::arg("normal")=Vector3r::Zero(),boost::python::arg("size")=0,boost::python::arg("energy")=0),"Report event from python (with current iteration and time); it is stored at the next flush.")
+		.def("_raw",&EventLog::pyRaw,(boost::python::arg("source")=-1),"Stored events of given source (all for -1) as binary string of records; use :yref:`yade.eventlog.arrays` instead.")
+	);
+};
+REGISTER_SERIALIZABLE(EventLog);
@@ -38,6 +38,16 @@ BOOST_STATIC_ASSERT(sizeof(Vector3r)==3*sizeof(Real));
  *
  * The non-parallel flavor has the same interface, but sync() is no-op and synchronization
  * is not enforced at all.
+ *
+ * In the deterministic mode (Scene::deterministic), per-thread sums are not used, since their value
+ * depends on how contributions were distributed between threads. Every contribution is recorded
+ * instead, together with the engine phase (nextPhase) and the ids of the interaction being processed
+ * (setOrderKey); sync() sums contributions of each body in the order of (phase, id1, id2), so that
+ * the result is bitwise the same for any number of threads and any scheduling. This requires that
+ * contributions to one body with the same (phase, id1, id2) come from one thread, i.e. that engines
+ * adding forces from parallel loops call setOrderKey for every item of the loop (one contribution
+ * per body and engine, as in GravityEngine, needs no key). Otherwise sync() reports the phase
+ * (ambiguousPhase), and Scene warns about the engine.
  */
 
 //! This is the parallel flavor of ForceContainer
@@ -58,6 +68,91 @@ class ForceContainer{
 		boost::mutex globalMutex;
 		Vector3r _zero;
 
+		// deterministic mode
+		enum { F_FORCE=0, F_TORQUE, F_MOVE, F_ROT };
+		struct Contribution{ long phase; Body::id_t id, key1, key2; short kind, thread; Vector3r val; };
+		struct compContribution{ bool operator()(const Contribution& a, const Contribution& b) const { return a.phase<b.phase || (a.phase==b.phase && (a.key1<b.key1 || (a.key1==b.key1 && a.key2<b.key2))); } };
+		// interaction being processed by each thread; padded to avoid false sharing, since it is written for every interaction
+		struct OrderKey{ Body::id_t key1, key2; char pad[64-2*sizeof(Body::id_t)]; };
+		bool deterministic;
+		long phase, _ambiguousPhase;
+		std::vector<OrderKey> _orderKey;
+		std::vector<std::vector<Contribution> > _contribs;
+		std::vector<Contribution> _sortedContribs;
+		std::vector<size_t> _contribStart;
+		// per-thread histograms of contributions by body id, then write positions of each thread
+		std::vector<std::vector<size_t> > _contribPos;
+		std::vector<size_t> _blockStart;
+		inline void record(Body::id_t id, int kind, const Vector3r& val){
+			const int thread=omp_get_thread_num(); const OrderKey& k=_orderKey[thread];
+			const Contribution c={phase,id,k.key1,k.key2,(short)kind,(short)thread,val};
+			_contribs[thread].push_back(c);
+		}
+		// sort contributions of one body; lists are short and mostly sorted already, and insertion sort keeps the order of contributions from the same interaction
+		static void sortContributions(Contribution* begin, Contribution* end){
+			compContribution comp;
+			for(Contribution* i=begin+1; i<end; i++){
+				const Contribution c=*i; Contribution* j=i;
+				for(; j>begin && comp(c,*(j-1)); j--) *j=*(j-1);
+				*j=c;
+			}
+		}
+		void syncDeterministic(){
+			// bucket contributions by body id, keeping their order within each thread (counting sort)
+			// histogram of each thread's contributions
+			_contribPos.resize(nThreads);
+			size_t nContribs=0;
+			for(int t=0; t<nThreads; t++) nContribs+=_contribs[t].size();
+			#pragma omp parallel for schedule(static)
+			for(int t=0; t<nThreads; t++){
+				_contribPos[t].assign(size,0);
+				FOREACH(const Contribution& c, _contribs[t]) _contribPos[t][c.id]++;
+			}
+			// prefix sum over (id, thread), blocked by id: block totals, their prefix sum, then positions within blocks
+			_contribStart.resize(size+1); _contribStart[size]=nContribs;
+			_blockStart.assign(nThreads+1,0);
+			#pragma omp parallel num_threads(nThreads)
+			{
+				const int nBlocks=omp_get_num_threads(), block=omp_get_thread_num();
+				const size_t lo=size*block/nBlocks, hi=size*(block+1)/nBlocks;
+				size_t sum=0;
+				for(size_t id=lo; id<hi; id++){ for(int t=0; t<nThreads; t++) sum+=_contribPos[t][id]; }
+				_blockStart[block+1]=sum;
+				#pragma omp barrier
+				#pragma omp single
+				for(int b=0; b<nBlocks; b++) _blockStart[b+1]+=_blockStart[b];
+				size_t pos=_blockStart[block];
+				for(size_t id=lo; id<hi; id++){
+					_contribStart[id]=pos;
+					for(int t=0; t<nThreads; t++){ const size_t n=_contribPos[t][id]; _contribPos[t][id]=pos; pos+=n; }
+				}
+			}
+			// scatter; each thread writes to its own positions
+			_sortedContribs.resize(nContribs);
+			#pragma omp parallel for schedule(static)
+			for(int t=0; t<nThreads; t++){ FOREACH(const Contribution& c, _contribs[t]) _sortedContribs[_contribPos[t][c.id]++]=c; }
+			// sum each body separately, in the order of (phase, id1, id2); the result does not depend on which thread sums which body
+			// equal keys from different threads mean the order depends on scheduling; remember the earliest such phase
+			long ambiguous=std::numeric_limits<long>::max();
+			#pragma omp parallel for schedule(static) reduction(min:ambiguous)
+			for(long id=0; id<(long)size; id++){
+				Vector3r sum[4]={Vector3r::Zero(),Vector3r::Zero(),Vector3r::Zero(),Vector3r::Zero()};
+				if(_contribStart[id+1]>_contribStart[id]){
+					Contribution* begin=&_sortedContribs[_contribStart[id]]; Contribution* end=begin+(_contribStart[id+1]-_contribStart[id]);
+					sortContributions(begin,end);
+					compContribution comp;
+					for(Contribution* c=begin; c<end; c++){
+						sum[c->kind]+=c->val;
+						if(c>begin && c->thread!=(c-1)->thread && !comp(*(c-1),*c) && c->phase<ambiguous) ambiguous=c->phase;
+					}
+				}
+				_force[id]=sum[F_FORCE]; _torque[id]=sum[F_TORQUE];
+				if (permForceUsed) {_force[id]+=_permForce[id]; _torque[id]+=_permTorque[id];}
+				if(moveRotUsed){ _move[id]=sum[F_MOVE]; _rot[id]=sum[F_ROT]; }
+			}
+			if(ambiguous<std::numeric_limits<long>::max() && _ambiguousPhase<0) _ambiguousPhase=ambiguous;
+		}
+
 		inline void ensureSize(Body::id_t id, int threadN){
 			assert(nThreads>omp_get_thread_num());
 			const Body::id_t idMaxTmp = max(id, _maxId[threadN]);
@@ -73,23 +168,25 @@ class ForceContainer{
 		// dummy function to avoid template resolution failure
 		friend class boost::serialization::access; template<class ArchiveT> void serialize(ArchiveT & ar, unsigned int version){}
 	public:
-		ForceContainer(): size(0), syncedSizes(true),synced(true),moveRotUsed(false),permForceUsed(false),_zero(Vector3r::Zero()),syncCount(0),lastReset(0){
+		ForceContainer(): size(0), syncedSizes(true),synced(true),moveRotUsed(false),permForceUsed(false),_zero(Vector3r::Zero()),deterministic(false),phase(0),_ambiguousPhase(-1),syncCount(0),lastReset(0){
 			nThreads=omp_get_max_threads();
 			for(int i=0; i<nThreads; i++){
 				_forceData.push_back(vvector()); _torqueData.push_back(vvector());
 				_moveData.push_back(vvector());  _rotData.push_back(vvector());
 				sizeOfThreads.push_back(0);
 				_maxId.push_back(0);
+				_contribs.push_back(std::vector<Contribution>());
 			}
+			_orderKey.resize(nThreads); clearOrderKeys();
 		}
 		const Vector3r& getForce(Body::id_t id)         { ensureSynced(); return ((size_t)id<size)?_force[id]:_zero; }
-		void  addForce(Body::id_t id, const Vector3r& f){ ensureSize(id,omp_get_thread_num()); synced=false;   _forceData[omp_get_thread_num()][id]+=f;}
+		void  addForce(Body::id_t id, const Vector3r& f){ ensureSize(id,omp_get_thread_num()); synced=false; if(deterministic) record(id,F_FORCE,f); else _forceData[omp_get_thread_num()][id]+=f;}
 		const Vector3r& getTorque(Body::id_t id)        { ensureSynced(); return ((size_t)id<size)?_torque[id]:_zero; }
-		void addTorque(Body::id_t id, const Vector3r& t){ ensureSize(id,omp_get_thread_num()); synced=false;   _torqueData[omp_get_thread_num()][id]+=t;}
+		void addTorque(Body::id_t id, const Vector3r& t){ ensureSize(id,omp_get_thread_num()); synced=false; if(deterministic) record(id,F_TORQUE,t); else _torqueData[omp_get_thread_num()][id]+=t;}
 		const Vector3r& getMove(Body::id_t id)          { ensureSynced(); return ((size_t)id<size)?_move[id]:_zero; }
-		void  addMove(Body::id_t id, const Vector3r& m) { ensureSize(id,omp_get_thread_num()); synced=false; moveRotUsed=true; _moveData[omp_get_thread_num()][id]+=m;}
+		void  addMove(Body::id_t id, const Vector3r& m) { ensureSize(id,omp_get_thread_num()); synced=false; moveRotUsed=true; if(deterministic) record(id,F_MOVE,m); else _moveData[omp_get_thread_num()][id]+=m;}
 		const Vector3r& getRot(Body::id_t id)           { ensureSynced(); return ((size_t)id<size)?_rot[id]:_zero; }
-		void  addRot(Body::id_t id, const Vector3r& r)  { ensureSize(id,omp_get_thread_num()); synced=false; moveRotUsed=true; _rotData[omp_get_thread_num()][id]+=r;}
+		void  addRot(Body::id_t id, const Vector3r& r)  { ensureSize(id,omp_get_thread_num()); synced=false; moveRotUsed=true; if(deterministic) record(id,F_ROT,r); else _rotData[omp_get_thread_num()][id]+=r;}
 		void  addMaxId(Body::id_t id)                   { _maxId[omp_get_thread_num()]=id;}
 
 		void  addPermForce(Body::id_t id, const Vector3r& f){ ensureSize(id,-1); synced=false;   _permForce[id]=f; permForceUsed=true;}
@@ -108,10 +205,11 @@ class ForceContainer{
 		/* To be benchmarked: sum thread data in getForce/getTorque upon request for each body individually instead of by the sync() function globally */
 		// this function is used from python so that running simulation is not slowed down by sync'ing on occasions
 		// since Vector3r writes are not atomic, it might (rarely) return wrong value, if the computation is running meanwhile
-		Vector3r getForceSingle (Body::id_t id){ Vector3r ret(Vector3r::Zero()); for(int t=0; t<nThreads; t++){ ret+=((size_t)id<sizeOfThreads[t])?_forceData [t][id]:_zero; } if (permForceUsed) ret+=_permForce[id]; return ret; }
-		Vector3r getTorqueSingle(Body::id_t id){ Vector3r ret(Vector3r::Zero()); for(int t=0; t<nThreads; t++){ ret+=((size_t)id<sizeOfThreads[t])?_torqueData[t][id]:_zero; } if (permForceUsed) ret+=_permTorque[id]; return ret; }
-		Vector3r getMoveSingle  (Body::id_t id){ Vector3r ret(Vector3r::Zero()); for(int t=0; t<nThreads; t++){ ret+=((size_t)id<sizeOfThreads[t])?_moveData  [t][id]:_zero; } return ret; }
-		Vector3r getRotSingle   (Body::id_t id){ Vector3r ret(Vector3r::Zero()); for(int t=0; t<nThreads; t++){ ret+=((size_t)id<sizeOfThreads[t])?_rotData   [t][id]:_zero; } return ret; }
+		// in the deterministic mode, contributions are only summed by sync(), and values of the last sync() are returned (which include permanent forces)
+		Vector3r getForceSingle (Body::id_t id){ if(deterministic) return ((size_t)id<size)?_force[id]:_zero; Vector3r ret(Vector3r::Zero()); for(int t=0; t<nThreads; t++){ ret+=((size_t)id<sizeOfThreads[t])?_forceData [t][id]:_zero; } if (permForceUsed) ret+=_permForce[id]; return ret; }
+		Vector3r getTorqueSingle(Body::id_t id){ if(deterministic) return ((size_t)id<size)?_torque[id]:_zero; Vector3r ret(Vector3r::Zero()); for(int t=0; t<nThreads; t++){ ret+=((size_t)id<sizeOfThreads[t])?_torqueData[t][id]:_zero; } if (permForceUsed) ret+=_permTorque[id]; return ret; }
+		Vector3r getMoveSingle  (Body::id_t id){ if(deterministic) return ((size_t)id<size)?_move[id]:_zero; Vector3r ret(Vector3r::Zero()); for(int t=0; t<nThreads; t++){ ret+=((size_t)id<sizeOfThreads[t])?_moveData  [t][id]:_zero; } return ret; }
+		Vector3r getRotSingle   (Body::id_t id){ if(deterministic) return ((size_t)id<size)?_rot[id]:_zero; Vector3r ret(Vector3r::Zero()); for(int t=0; t<nThreads; t++){ ret+=((size_t)id<sizeOfThreads[t])?_rotData   [t][id]:_zero; } return ret; }
 		
 		inline void syncSizesOfContainers() {
 			if (syncedSizes) return;
@@ -144,6 +242,7 @@ class ForceContainer{
 			
 			syncSizesOfContainers();
 
+			if(deterministic){ syncDeterministic(); synced=true; syncCount++; return; }
 			for(long id=0; id<(long)size; id++){
 				Vector3r sumF(Vector3r::Zero()), sumT(Vector3r::Zero());
 				for(int thread=0; thread<nThreads; thread++){ sumF+=_forceData[thread][id]; sumT+=_torqueData[thread][id];}
@@ -183,6 +282,7 @@ class ForceContainer{
 		void reset(long iter, bool resetAll=false){
 			syncSizesOfContainers();
 			for(int thread=0; thread<nThreads; thread++){
+				_contribs[thread].clear();
 				memset(&_forceData [thread][0],0,sizeof(Vector3r)*sizeOfThreads[thread]);
 				memset(&_torqueData[thread][0],0,sizeof(Vector3r)*sizeOfThreads[thread]);
 				if(moveRotUsed){
@@ -205,10 +305,36 @@ class ForceContainer{
 			moveRotUsed=false;
 			lastReset=iter;
 		}
+		//! Move permanent forces and torques to new body ids (see BodyContainer::renumber); other forces are reset, since they refer to the old ids
+		void renumber(const std::vector<Body::id_t>& newIds){
+			if(permForceUsed){
+				if(newIds.size()>_permForce.size()) resizePerm(newIds.size());
+				vvector f(_permForce.size(),Vector3r::Zero()), t(_permTorque.size(),Vector3r::Zero());
+				for(size_t id=0; id<newIds.size(); id++) if(newIds[id]>=0){ f[newIds[id]]=_permForce[id]; t[newIds[id]]=_permTorque[id]; }
+				_permForce.swap(f); _permTorque.swap(t);
+			}
+			reset(lastReset);
+		}
+		/*! Switch the deterministic mode; pending contributions are summed in the old mode first.
+		Called by Scene at the beginning of every step, according to Scene::deterministic. */
+		void setDeterministic(bool d){
+			if(d==deterministic) return;
+			sync();
+			deterministic=d;
+		}
+		//! Contributions recorded from now on come after those recorded before (called by Scene before every engine in the deterministic mode)
+		long nextPhase(){ return ++phase; }
+		//! Earliest phase in which contributions to one body could not be ordered (see the class description), or -1; resets the value
+		long takeAmbiguousPhase(){ long ret=_ambiguousPhase; _ambiguousPhase=-1; return ret; }
+		//! Contributions of the calling thread come from interaction id1+id2 (set by InteractionLoop in the deterministic mode)
+		void setOrderKey(Body::id_t id1, Body::id_t id2){ OrderKey& k=_orderKey[omp_get_thread_num()]; k.key1=min(id1,id2); k.key2=max(id1,id2); }
+		//! Contributions of all threads come from no particular interaction; must NOT be called from parallel sections
+		void clearOrderKeys(){ for(int t=0; t<nThreads; t++){ _orderKey[t].key1=_orderKey[t].key2=-1; } }
 		//! say for how many threads we have allocated space
 		const int& getNumAllocatedThreads() const {return nThreads;}
 		const bool& getMoveRotUsed() const {return moveRotUsed;}
 		const bool& getPermForceUsed() const {return permForceUsed;}
+		const bool& getDeterministic() const {return deterministic;}
 };
 
 #else
@@ -222,7 +348,7 @@ class ForceContainer {
 		std::vector<Vector3r> _permForce, _permTorque;
 		Body::id_t _maxId;
 		size_t size;
-		bool moveRotUsed, permForceUsed;
+		bool moveRotUsed, permForceUsed, deterministic;
 		inline void ensureSize(Body::id_t id){ 
 			const Body::id_t idMaxTmp = max(id, _maxId);
 			_maxId = 0;
@@ -235,7 +361,7 @@ class ForceContainer {
 		// dummy function to avoid template resolution failure
 		friend class boost::serialization::access; template<class ArchiveT> void serialize(ArchiveT & ar, unsigned int version){}
 	public:
-		ForceContainer(): _maxId(0), size(0), moveRotUsed(false), permForceUsed(false), syncCount(0), lastReset(0){}
+		ForceContainer(): _maxId(0), size(0), moveRotUsed(false), permForceUsed(false), deterministic(false), syncCount(0), lastReset(0){}
 		const Vector3r& getForce(Body::id_t id){ensureSize(id); return _force[id];}
 		void  addForce(Body::id_t id,const Vector3r& f){ensureSize(id); _force[id]+=f;}
 		const Vector3r& getTorque(Body::id_t id){ensureSize(id); return _torque[id];}
@@ -310,9 +436,26 @@ class ForceContainer {
 			_rot.resize(newSize,Vector3r::Zero());
 			size=newSize;
 		}
+		//! Move permanent forces and torques to new body ids (see BodyContainer::renumber); other forces are reset, since they refer to the old ids
+		void renumber(const std::vector<Body::id_t>& newIds){
+			if(permForceUsed){
+				if(newIds.size()>size) resize(newIds.size());
+				std::vector<Vector3r> f(size,Vector3r::Zero()), t(size,Vector3r::Zero());
+				for(size_t id=0; id<newIds.size(); id++) if(newIds[id]>=0){ f[newIds[id]]=_permForce[id]; t[newIds[id]]=_permTorque[id]; }
+				_permForce.swap(f); _permTorque.swap(t);
+			}
+			reset(lastReset);
+		}
+		// contributions are always summed in the order they come in the non-parallel flavor, hence deterministic
+		void setDeterministic(bool d){ deterministic=d; }
+		long nextPhase(){ return 0; }
+		long takeAmbiguousPhase(){ return -1; }
+		void setOrderKey(Body::id_t id1, Body::id_t id2){}
+		void clearOrderKeys(){}
 		const int getNumAllocatedThreads() const {return 1;}
 		const bool& getMoveRotUsed() const {return moveRotUsed;}
 		const bool& getPermForceUsed() const {return permForceUsed;}
+		const bool& getDeterministic() const {return deterministic;}
 };
 
 #endif
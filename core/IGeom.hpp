@@ -11,6 +11,7 @@
 #include<lib/base/Math.hpp>
 #include<lib/serialization/Serializable.hpp>
 #include<lib/multimethods/Indexable.hpp>
+#include<lib/base/PoolAllocator.hpp>
 #include<core/Dispatcher.hpp>
 
 class IGeom : public Serializable, public Indexable
@@ -8,6 +8,15 @@
 	#include<omp.h>
 #endif
 CREATE_LOGGER(InteractionContainer);
+
+// compare interactions by (lower id, higher id), which is the order of Body::intrs traversal
+struct compPtrInteractionMinMax{
+	bool operator() (const shared_ptr<Interaction>& i1, const shared_ptr<Interaction>& i2) const {
+		const Body::id_t a1=min(i1->getId1(),i1->getId2()), a2=min(i2->getId1(),i2->getId2());
+		return a1<a2 || (a1==a2 && max(i1->getId1(),i1->getId2())<max(i2->getId1(),i2->getId2()));
+	}
+};
+
 // begin internal functions
 
 bool InteractionContainer::insert(const shared_ptr<Interaction>& i){
@@ -28,6 +37,7 @@ bool InteractionContainer::insert(const shared_ptr<Interaction>& i){
 	if(!b1->intrs.insert(Body::MapId2IntrT::value_type(id2,i)).second) return false; // already exists
 	if(!b2->intrs.insert(Body::MapId2IntrT::value_type(id1,i)).second) return false; 
 	
+	if(sortedSize==currSize && displaced.empty() && (currSize==0 || compPtrInteractionMinMax()(linIntrs[currSize-1],i))) sortedSize++;
 	linIntrs.resize(++currSize); // currSize updated
 	linIntrs[currSize-1]=i; // assign last element
 	i->linIx=currSize-1; // store the index back-reference in the interaction (so that it knows how to erase/move itself)
@@ -46,7 +56,8 @@ void InteractionContainer::clear(){
 		if (b) b->intrs.clear(); // delete interactions from bodies
 	}
 	linIntrs.clear(); // clear the linear container
-	currSize=0;
+	currSize=sortedSize=0;
+	displaced.clear();
 	dirty=true;
 }
 
@@ -82,10 +93,13 @@ bool InteractionContainer::erase(Body::id_t id1,Body::id_t id2, int linPos){
 	if(linIx<0) {
 		LOG_ERROR("InteractionContainer::erase: attempt to delete interaction with a deleted body (the definition of linPos in the call to erase() should fix the problem) for  ##"+boost::lexical_cast<string>(id1)+"+"+boost::lexical_cast<string>(id2));
 		return false;}
+	// the last element leaves the sorted part if it was in it
+	if(sortedSize==currSize) sortedSize--;
 	// iid is not the last element; we have to move last one to its place
 	if (linIx<(int)currSize-1) {
 		linIntrs[linIx]=linIntrs[currSize-1];
 		linIntrs[linIx]->linIx=linIx; // update the back-reference inside the interaction
+		if((size_t)linIx<sortedSize) displaced.push_back(linIx);
 	}
 	// in either case, last element can be removed now
 	linIntrs.resize(--currSize); // currSize updated
@@ -140,6 +154,58 @@ struct compPtrInteraction{
 	}
 };
 
+void InteractionContainer::renumber(const std::vector<Body::id_t>& newIds){
+	assert(bodies);
+	boost::mutex::scoped_lock lock(drawloopmutex);
+	FOREACH(const shared_ptr<Body>& b, *bodies) if(b) b->intrs.clear();
+	ContainerT renumbered; renumbered.reserve(currSize);
+	for(size_t linPos=0; linPos<currSize; linPos++){
+		const shared_ptr<Interaction>& I=linIntrs[linPos];
+		// interactions of erased bodies, not yet removed by the collider, are dropped
+		if(newIds[I->id1]<0 || newIds[I->id2]<0) continue;
+		I->id1=newIds[I->id1]; I->id2=newIds[I->id2];
+		renumbered.push_back(I);
+	}
+	std::sort(renumbered.begin(),renumbered.end(),compPtrInteractionMinMax());
+	linIntrs.swap(renumbered);
+	currSize=sortedSize=linIntrs.size();
+	displaced.clear();
+	for(size_t linPos=0; linPos<currSize; linPos++){
+		const shared_ptr<Interaction>& I=linIntrs[linPos];
+		I->linIx=linPos;
+		(*bodies)[I->id1]->intrs[I->id2]=I;
+		(*bodies)[I->id2]->intrs[I->id1]=I;
+	}
+}
+
+void InteractionContainer::sortByIds(){
+	if(sortedSize==currSize && displaced.empty()) return;
+	boost::mutex::scoped_lock lock(drawloopmutex);
+	// first position whose interaction may change
+	size_t firstChanged=sortedSize;
+	if(!displaced.empty()){
+		// move displaced interactions out of the sorted part, keeping the order of the rest; they are sorted with the tail
+		vector<char> isDisplaced(sortedSize,0);
+		FOREACH(size_t linPos, displaced) if(linPos<sortedSize){ isDisplaced[linPos]=1; firstChanged=min(firstChanged,linPos); }
+		ContainerT moved;
+		size_t j=firstChanged;
+		for(size_t linPos=firstChanged; linPos<sortedSize; linPos++){
+			if(isDisplaced[linPos]) moved.push_back(linIntrs[linPos]);
+			else linIntrs[j++]=linIntrs[linPos];
+		}
+		std::copy(moved.begin(),moved.end(),linIntrs.begin()+j);
+		sortedSize=j;
+		displaced.clear();
+	}
+	const ContainerT::iterator sorted=linIntrs.begin()+sortedSize, end=linIntrs.begin()+currSize;
+	std::sort(sorted,end,compPtrInteractionMinMax());
+	// interactions before the first merged one keep their place
+	if(sorted!=end) firstChanged=min(firstChanged,(size_t)(std::upper_bound(linIntrs.begin(),sorted,*sorted,compPtrInteractionMinMax())-linIntrs.begin()));
+	std::inplace_merge(linIntrs.begin(),sorted,end,compPtrInteractionMinMax());
+	for(size_t linPos=firstChanged; linPos<currSize; linPos++) linIntrs[linPos]->linIx=linPos;
+	sortedSize=currSize;
+}
+
 void InteractionContainer::preSave(InteractionContainer&){
 	FOREACH(const shared_ptr<Interaction>& I, *this){
 		if(I->geom || I->phys) interaction.push_back(I);
@@ -50,11 +50,14 @@ class InteractionContainer: public Serializable{
 		shared_ptr<Interaction> empty;
 		// used only during serialization/deserialization
 		vector<shared_ptr<Interaction> > interaction;
+		// linIntrs[0..sortedSize) is sorted by (lower id, higher id), except for the displaced positions, where erase moved the last interaction; interactions from sortedSize on were appended in arbitrary order
+		size_t sortedSize;
+		vector<size_t> displaced;
 	public:
 		// flag for notifying the collider that persistent data should be invalidated
 		bool dirty;
 		// required by the class factory... :-|
-		InteractionContainer(): currSize(0),dirty(false),serializeSorted(false),iterColliderLastRun(-1){
+		InteractionContainer(): currSize(0),sortedSize(0),dirty(false),serializeSorted(false),iterColliderLastRun(-1){
 			bodies=NULL;
 // 			#ifdef YADE_OPENMP
 // 				threadsPendingErase.resize(omp_get_max_threads());
@@ -85,6 +88,11 @@ class InteractionContainer: public Serializable{
 
 		//! Erase all non-real (in term of Interaction::isReal()) interactions
 		void eraseNonReal();
+		//! Update ids of interactions after BodyContainer::renumber, and sort them by (lower,higher) new id so that linear traversal follows the body order
+		void renumber(const std::vector<Body::id_t>& newIds);
+		//! Sort interactions by (lower id, higher id), if insertions or erasures changed the order; the order is then independent of threads which inserted them (used in the deterministic mode, see Scene::deterministic)
+		//! Only interactions appended or moved since the last call are sorted, and merged with the rest.
+		void sortByIds();
 
 		// mutual exclusion to avoid crashes in the rendering loop
 		boost::mutex drawloopmutex;
@@ -17,6 +17,10 @@
 #include<lib/multimethods/Indexable.hpp>
 #include<boost/algorithm/string.hpp>
 #include<boost/thread/mutex.hpp>
+#include<boost/bind.hpp>
+#ifdef YADE_OPENMP
+	#include<omp.h>
+#endif
 
 #include<lib/serialization/ObjectIO.hpp>
 
@@ -42,7 +46,10 @@ SINGLETON_SELF(Omega);
 
 const map<string,DynlibDescriptor>& Omega::getDynlibsDescriptor(){return dynlibs;}
 
-const shared_ptr<Scene>& Omega::getScene(){return scenes.at(currentSceneNb);}
+// scene being advanced by Omega::runScenes in this thread, if any
+static __thread const shared_ptr<Scene>* threadScene=NULL;
+
+const shared_ptr<Scene>& Omega::getScene(){return threadScene ? *threadScene : scenes.at(currentSceneNb);}
 void Omega::resetCurrentScene(){ RenderMutexLock lock; scenes.at(currentSceneNb) = shared_ptr<Scene>(new Scene);}
 void Omega::resetScene(){ resetCurrentScene(); }//RenderMutexLock lock; scene = shared_ptr<Scene>(new Scene);}
 void Omega::resetAllScenes(){
@@ -63,6 +70,53 @@ void Omega::switchToScene(int i) {
 	currentSceneNb=i;
 }
 
+namespace {
+	// scenes shared by workers of Omega::runScenes, which take them one by one
+	struct SceneQueue{
+		vector<shared_ptr<Scene> > scenes; vector<int> ids;
+		size_t next; string error; boost::mutex mutex;
+		SceneQueue(): next(0){}
+	};
+	void runScenesWorker(SceneQueue* q, long nSteps, Real duration){
+		#ifdef YADE_OPENMP
+			// scenes are small, parallelism is over scenes; this also keeps getScene() valid in parallel sections
+			omp_set_num_threads(1);
+		#endif
+		while(true){
+			size_t i;
+			{ boost::mutex::scoped_lock lock(q->mutex); if(q->next>=q->scenes.size() || !q->error.empty()) return; i=q->next++; }
+			const shared_ptr<Scene>& scene=q->scenes[i];
+			threadScene=&scene;
+			try{
+				scene->subStepping=false;
+				long iter0=scene->iter; Real time0=scene->time;
+				while((nSteps<0 || scene->iter-iter0<nSteps) && (duration<0 || scene->time-time0<duration)) scene->moveToNextTimeStep();
+			} catch(std::exception& e){
+				boost::mutex::scoped_lock lock(q->mutex);
+				if(q->error.empty()) q->error="Scene #"+boost::lexical_cast<string>(q->ids[i])+": "+e.what();
+			}
+			threadScene=NULL;
+		}
+	}
+}
+
+void Omega::runScenes(const vector<int>& ids, long nSteps, Real duration, int nThreads){
+	if(nSteps<0 && duration<0) throw invalid_argument("Omega::runScenes: number of steps or duration must be given.");
+	if(isRunning()) throw runtime_error("Omega::runScenes: the simulation is running.");
+	SceneQueue q;
+	FOREACH(int i, ids){
+		if(i<0 || i>=(int)scenes.size()) throw invalid_argument("Omega::runScenes: scene #"+boost::lexical_cast<string>(i)+" has not been created.");
+		if(std::find(q.scenes.begin(),q.scenes.end(),scenes[i])!=q.scenes.end()) throw invalid_argument("Omega::runScenes: scene #"+boost::lexical_cast<string>(i)+" given more than once.");
+		q.scenes.push_back(scenes[i]); q.ids.push_back(i);
+	}
+	if(nThreads<=0) nThreads=boost::thread::hardware_concurrency();
+	nThreads=max(1,min(nThreads,(int)q.scenes.size()));
+	boost::thread_group workers;
+	for(int t=0; t<nThreads; t++) workers.create_thread(boost::bind(runScenesWorker,&q,nSteps,duration));
+	workers.join_all();
+	if(!q.error.empty()) throw runtime_error(q.error);
+}
+
 
 
 Real Omega::getRealTime(){ return (boost::posix_time::microsec_clock::local_time()-startupLocalTime).total_milliseconds()/1e3; }
@@ -76,6 +130,7 @@ void Omega::initTemps(){
 }
 
 void Omega::cleanupTemps(){
+  memPrefetched.clear();
   boost::filesystem::path tmpPath(tmpFileDir);
   boost::filesystem::remove_all(tmpPath);
 }
@@ -130,15 +185,26 @@ void Omega::pause(){
 
 bool Omega::isRunning(){ if(simulationLoop) return simulationLoop->looping(); else return false; }
 
+namespace{
+	struct NumAncestorsLess{
+		const map<string,DynlibDescriptor>& dynlibs;
+		NumAncestorsLess(const map<string,DynlibDescriptor>& d): dynlibs(d){}
+		bool operator()(const string& a, const string& b) const { return dynlibs.find(a)->second.allBaseClasses.size()<dynlibs.find(b)->second.allBaseClasses.size(); }
+	};
+}
+
 void Omega::buildDynlibDatabase(const vector<string>& dynlibsList){	
 	LOG_DEBUG("called with "<<dynlibsList.size()<<" plugins.");
 	boost::python::object wrapperScope=boost::python::import("yade.wrapper");
-	std::list<string> pythonables;
+	// every class is instantiated only once; instances are kept for base class lookup and python registration below
+	map<string,shared_ptr<Factorable> > instances;
+	std::vector<string> pythonables;
 	FOREACH(string name, dynlibsList){
 		shared_ptr<Factorable> f;
 		try {
 			LOG_DEBUG("Factoring plugin "<<name);
 			f = ClassFactory::instance().createShared(name);
+			instances[name]=f;
 			dynlibs[name].isSerializable = ((YADE_PTR_DYN_CAST<Serializable>(f)).get()!=0);
 			for(int i=0;i<f->getBaseClassNumber();i++){
 				dynlibs[name].baseClasses.insert(f->getBaseClassName(i));
@@ -150,28 +216,6 @@ void Omega::buildDynlibDatabase(const vector<string>& dynlibsList){
 			 * when a class is not factorable, it is OK to skip it; */	
 		}
 	}
-	// handle Serializable specially
-	//Serializable().pyRegisterClass(wrapperScope);
-	/* python classes must be registered such that base classes come before derived ones;
-	for now, just loop until we succeed; proper solution will be to build graphs of classes
-	and traverse it from the top. It will be done once all classes are pythonable. */
-	for(int i=0; i<100 && pythonables.size()>0; i++){
-		if(getenv("YADE_DEBUG")) cerr<<endl<<"[[[ Round "<<i<<" ]]]: ";
-		std::list<string> done;
-		for(std::list<string>::iterator I=pythonables.begin(); I!=pythonables.end(); ){
-			shared_ptr<Serializable> s=boost::static_pointer_cast<Serializable>(ClassFactory::instance().createShared(*I));
-			try{
-				if(getenv("YADE_DEBUG")) cerr<<"{{"<<*I<<"}}";
-				s->pyRegisterClass(wrapperScope);
-				std::list<string>::iterator prev=I++;
-				pythonables.erase(prev);
-			} catch (...){
-				if(getenv("YADE_DEBUG")){ cerr<<"["<<*I<<"]"; PyErr_Print(); }
-				boost::python::handle_exception();
-				I++;
-			}
-		}
-	}
 
 	map<string,DynlibDescriptor>::iterator dli    = dynlibs.begin();
 	map<string,DynlibDescriptor>::iterator dliEnd = dynlibs.end();
@@ -183,26 +227,62 @@ void Omega::buildDynlibDatabase(const vector<string>& dynlibsList){
 			if (name=="Dispatcher1D" || name=="Dispatcher2D") (*dli).second.baseClasses.insert("Dispatcher");
 			else if (name=="Functor1D" || name=="Functor2D") (*dli).second.baseClasses.insert("Functor");
 			else if (name=="Serializable") (*dli).second.baseClasses.insert("Factorable");
-			else if (name!="Factorable" && name!="Indexable") {
+			else if (name!="Factorable" && name!="Indexable" && instances.count(name)==0) {
 				shared_ptr<Factorable> f = ClassFactory::instance().createShared(name);
+				instances[name]=f;
 				for(int i=0;i<f->getBaseClassNumber();i++)
 					dynlibs[name].baseClasses.insert(f->getBaseClassName(i));
 			}
 		}
 	}
+	// precompute the transitive closure, so that isInheritingFrom_recursive is a single lookup
+	for(dli=dynlibs.begin(); dli!=dynlibs.end(); ++dli) collectAllBaseClasses(dli->first);
+
+	/* python classes must be registered such that base classes come before derived ones;
+	a base class has strictly less ancestors than its derived classes, so sorting by their number gives a valid order.
+	The loop is kept for classes which still fail (it should finish in the first round). */
+	std::stable_sort(pythonables.begin(),pythonables.end(),NumAncestorsLess(dynlibs));
+	std::list<string> toRegister(pythonables.begin(),pythonables.end());
+	for(int i=0; i<100 && toRegister.size()>0; i++){
+		if(getenv("YADE_DEBUG")) cerr<<endl<<"[[[ Round "<<i<<" ]]]: ";
+		for(std::list<string>::iterator I=toRegister.begin(); I!=toRegister.end(); ){
+			shared_ptr<Serializable> s=boost::static_pointer_cast<Serializable>(instances[*I]);
+			try{
+				if(getenv("YADE_DEBUG")) cerr<<"{{"<<*I<<"}}";
+				s->pyRegisterClass(wrapperScope);
+				std::list<string>::iterator prev=I++;
+				toRegister.erase(prev);
+			} catch (...){
+				if(getenv("YADE_DEBUG")){ cerr<<"["<<*I<<"]"; PyErr_Print(); }
+				boost::python::handle_exception();
+				I++;
+			}
+		}
+	}
 }
 
+const set<string>& Omega::collectAllBaseClasses(const string& name){
+	static const set<string> none;
+	map<string,DynlibDescriptor>::iterator I=dynlibs.find(name);
+	if(I==dynlibs.end()) return none; // pseudo-bases such as Factorable
+	DynlibDescriptor& d=I->second;
+	if(d.allBaseClasses.empty() && !d.baseClasses.empty()){
+		FOREACH(const string& parent, d.baseClasses){
+			d.allBaseClasses.insert(parent);
+			if(parent==name) continue;
+			const set<string>& grand=collectAllBaseClasses(parent);
+			d.allBaseClasses.insert(grand.begin(),grand.end());
+		}
+	}
+	return d.allBaseClasses;
+}
 
 bool Omega::isInheritingFrom(const string& className, const string& baseClassName){
 	return (dynlibs[className].baseClasses.find(baseClassName)!=dynlibs[className].baseClasses.end());
 }
 
 bool Omega::isInheritingFrom_recursive(const string& className, const string& baseClassName){
-	if (dynlibs[className].baseClasses.find(baseClassName)!=dynlibs[className].baseClasses.end()) return true;
-	FOREACH(const string& parent,dynlibs[className].baseClasses){
-		if(isInheritingFrom_recursive(parent,baseClassName)) return true;
-	}
-	return false;
+	return (dynlibs[className].allBaseClasses.find(baseClassName)!=dynlibs[className].allBaseClasses.end());
 }
 
 void Omega::loadPlugins(vector<string> pluginFiles){
@@ -227,6 +307,17 @@ void Omega::loadPlugins(vector<string> pluginFiles){
 	buildDynlibDatabase(vector<string>(plugins.begin(),plugins.end()));
 }
 
+void Omega::prefetchMemSaved(const string& f){
+	if(memSavedSimulations.count(f)==0) throw runtime_error("Cannot prefetch nonexistent memory-saved simulation "+f);
+	// deserialized in this thread: it creates engines and touches static data of some classes, which must not overlap with anything else
+	shared_ptr<Scene> scene;
+	istringstream iss(memSavedSimulations[f]);
+	yade::ObjectIO::load<decltype(scene),boost::archive::binary_iarchive>(iss,"scene",scene);
+	memPrefetched[f]=scene;
+}
+
+void Omega::dropMemPrefetch(const string& f){ memPrefetched.erase(f); }
+
 void Omega::loadSimulation(const string& f, bool quiet){
 	bool isMem=boost::algorithm::starts_with(f,":memory:");
 	if(!isMem && !boost::filesystem::exists(f)) throw runtime_error("Simulation file to load doesn't exist: "+f);
@@ -236,15 +327,23 @@ void Omega::loadSimulation(const string& f, bool quiet){
 	//shared_ptr<Scene> scene = getScene();
 	shared_ptr<Scene>& scene = scenes[currentSceneNb];
 	//shared_ptr<Scene>& scene = getScene();
+	// the prefetched copy is used once
+	shared_ptr<Scene> prefetched;
+	if(isMem && memPrefetched.count(f)>0){ prefetched=memPrefetched[f]; memPrefetched.erase(f); }
 	{
 		stop(); // stop current simulation if running
-		resetScene();
-		RenderMutexLock lock;
-		if(isMem){
-			istringstream iss(memSavedSimulations[f]);
-			yade::ObjectIO::load<decltype(scene),boost::archive::binary_iarchive>(iss,"scene",scene);
+		if(prefetched){
+			RenderMutexLock lock;
+			scene=prefetched;
 		} else {
-			yade::ObjectIO::load(f,"scene",scene);
+			resetScene();
+			RenderMutexLock lock;
+			if(isMem){
+				istringstream iss(memSavedSimulations[f]);
+				yade::ObjectIO::load<decltype(scene),boost::archive::binary_iarchive>(iss,"scene",scene);
+			} else {
+				yade::ObjectIO::load(f,"scene",scene);
+			}
 		}
 	}
 	if(scene->getClassName()!="Scene") throw logic_error("Wrong file format (scene is not a Scene!?) in "+f);
@@ -263,6 +362,7 @@ void Omega::saveSimulation(const string& f, bool quiet){
 	//shared_ptr<Scene>& scene = getScene();
 	if(boost::algorithm::starts_with(f,":memory:")){
 		if(memSavedSimulations.count(f)>0 && !quiet) LOG_INFO("Overwriting in-memory saved simulation "<<f);
+		dropMemPrefetch(f); // the prefetched copy is of the old data
 		ostringstream oss;
 		yade::ObjectIO::save<decltype(scene),boost::archive::binary_oarchive>(oss,"scene",scene);
 		memSavedSimulations[f]=oss.str();
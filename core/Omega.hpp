@@ -34,6 +34,7 @@ class ThreadRunner;
 
 struct DynlibDescriptor{
 	set<string> baseClasses;
+	set<string> allBaseClasses; // transitive closure of baseClasses, filled by Omega::buildDynlibDatabase
 	bool isSerializable;
 };
 
@@ -42,6 +43,7 @@ class Omega: public Singleton<Omega>{
 	SimulationFlow simulationFlow_;
 	map<string,DynlibDescriptor> dynlibs; // FIXME : should store that in ClassFactory ?
 	void buildDynlibDatabase(const vector<string>& dynlibsList); // FIXME - maybe in ClassFactory ?
+	const set<string>& collectAllBaseClasses(const string& name);
 	
 	vector<shared_ptr<Scene> > scenes;
 	int currentSceneNb;
@@ -50,6 +52,8 @@ class Omega: public Singleton<Omega>{
   boost::posix_time::ptime startupLocalTime;
 
 	map<string,string> memSavedSimulations;
+	// scenes deserialized in advance from memSavedSimulations, so that the next load of them is immediate
+	map<string,shared_ptr<Scene> > memPrefetched;
 
 	// to avoid accessing simulation when it is being loaded (should avoid crashes with the UI)
 	boost::mutex loadingSimulationMutex;
@@ -66,6 +70,10 @@ class Omega: public Singleton<Omega>{
 		void cleanupTemps();
 		const map<string,DynlibDescriptor>& getDynlibsDescriptor();
 		void loadPlugins(vector<string> pluginFiles);
+		//! deserialize a copy of memory-saved simulation f now, so that the next load of f only swaps it in
+		void prefetchMemSaved(const string& f);
+		//! forget the prefetched copy of f
+		void dropMemPrefetch(const string& f);
 		bool isInheritingFrom(const string& className, const string& baseClassName );
 		bool isInheritingFrom_recursive(const string& className, const string& baseClassName );
 		void createSimulationLoop();
@@ -95,6 +103,8 @@ class Omega: public Singleton<Omega>{
 		const shared_ptr<Scene>& getScene();
 		int addScene();
 		void switchToScene(int i);
+		/*! Advance scenes with numbers ids concurrently, each of them in one thread at a time (with OpenMP disabled inside), by nSteps steps or by duration of simulation time, whichever comes first (negative values are ignored). nThreads<=0 uses all cores. getScene() returns the scene being advanced in the thread advancing it. Returns when all scenes are done; the first exception from any of them is re-thrown as runtime_error. */
+		void runScenes(const vector<int>& ids, long nSteps, Real duration, int nThreads);
 		//! Return unique temporary filename. May be deleted by the user; if not, will be deleted at shutdown.
 		string tmpFilename();
 		Real getRealTime();
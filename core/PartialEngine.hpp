@@ -14,6 +14,9 @@
 class PartialEngine: public Engine{
 	public:
 		virtual ~PartialEngine() {};
+		virtual void renumberBodies(const std::vector<Body::id_t>& newIds){
+			for(size_t i=0; i<ids.size(); i++) if(ids[i]>=0 && ids[i]<(int)newIds.size()) ids[i]=newIds[ids[i]];
+		}
 	YADE_CLASS_BASE_DOC_ATTRS(PartialEngine,Engine,"Engine affecting only particular bodies in the simulation, defined by *ids*.",
 		((std::vector<int>,ids,,,":yref:`Ids<Body::id>` of bodies affected by this PartialEngine."))
 	);
@@ -86,6 +86,7 @@ void Scene::moveToNextTimeStep(){
 		subStep=0;
 		// ** 1. ** prologue
 		if(isPeriodic) cell->integrateAndUpdate(dt);
+		forces.setDeterministic(deterministic); energy->setExact(deterministic); phaseEngines.clear();
 		//forces.reset(); // uncomment if ForceResetter is removed
 		const bool TimingInfo_enabled=TimingInfo::enabled; // cache the value, so that when it is changed inside the step, the engine that was just running doesn't get bogus values
 		TimingInfo::delta last=TimingInfo::getNow(); // actually does something only if TimingInfo::enabled, no need to put the condition here
@@ -93,6 +94,7 @@ void Scene::moveToNextTimeStep(){
 		FOREACH(const shared_ptr<Engine>& e, engines){
 			e->scene=this;
 			if(e->dead || !e->isActivated()) continue;
+			if(deterministic) nextForcePhase(e.get());
 			e->action();
 			if(TimingInfo_enabled) {TimingInfo::delta now=TimingInfo::getNow(); e->timingInfo.nsec+=now-last; e->timingInfo.nExec+=1; last=now;}
 		}
@@ -111,6 +113,9 @@ void Scene::moveToNextTimeStep(){
 			prevTime = timeNow;
 		}
 		
+		// events reported by (possibly parallel) engines are merged once per step
+		events->flush();
+		if(deterministic) checkForceOrder();
 		iter++;
 		time+=dt;
 		subStep=-1;
@@ -125,11 +130,11 @@ void Scene::moveToNextTimeStep(){
 		for(int subs=subStep; subs<=maxSubStep; subs++){
 			assert(subs>=-1 && subs<=(int)engines.size());
 			// ** 1. ** prologue
-			if(subs==-1){ if(isPeriodic) cell->integrateAndUpdate(dt); }
+			if(subs==-1){ if(isPeriodic) cell->integrateAndUpdate(dt); forces.setDeterministic(deterministic); energy->setExact(deterministic); phaseEngines.clear(); }
 			// ** 2. ** engines
-			else if(subs>=0 && subs<(int)engines.size()){ const shared_ptr<Engine>& e(engines[subs]); e->scene=this; if(!e->dead && e->isActivated()) e->action(); }
+			else if(subs>=0 && subs<(int)engines.size()){ const shared_ptr<Engine>& e(engines[subs]); e->scene=this; if(!e->dead && e->isActivated()){ if(deterministic) nextForcePhase(e.get()); e->action(); } }
 			// ** 3. ** epilogue
-			else if(subs==(int)engines.size()){ iter++; time+=dt; /* gives -1 along with the increment afterwards */ subStep=-2; }
+			else if(subs==(int)engines.size()){ events->flush(); if(deterministic) checkForceOrder(); iter++; time+=dt; /* gives -1 along with the increment afterwards */ subStep=-2; }
 			// (?!)
 			else { /* never reached */ assert(false); }
 		}
@@ -139,6 +144,15 @@ void Scene::moveToNextTimeStep(){
 
 
 
+void Scene::checkForceOrder(){
+	const long phase=forces.takeAmbiguousPhase();
+	if(phase<0 || forceOrderWarned) return;
+	forceOrderWarned=true;
+	const long ix=phase-phaseBase;
+	const string name=(ix>=0 && ix<(long)phaseEngines.size()) ? phaseEngines[ix]->getClassName() : string("(unknown engine)");
+	LOG_WARN("O.deterministic: "<<name<<" adds forces to the same body from several threads without ForceContainer::setOrderKey; results may depend on the number of threads (use ompThreads=1 for this engine to avoid it).");
+}
+
 shared_ptr<Engine> Scene::engineByName(const string& s){
 	FOREACH(shared_ptr<Engine> e, engines){
 		if(e->getClassName()==s) return e;
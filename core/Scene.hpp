@@ -19,6 +19,7 @@
 #include<core/ForceContainer.hpp>
 #include<core/InteractionContainer.hpp>
 #include<core/EnergyTracker.hpp>
+#include<core/EventLog.hpp>
 
 #ifndef HOST_NAME_MAX
 #define HOST_NAME_MAX 255 
@@ -82,6 +83,13 @@ class Scene: public Serializable{
 		void setCompressionNegative(bool d){ if(d) flags|=COMPRESSION_NEGATIVE; else flags&=~(COMPRESSION_NEGATIVE); }
 		boost::posix_time::ptime prevTime; //Time value on the previous step
 
+		// deterministic mode: engines run in this step, indexed by force phase minus phaseBase (see ForceContainer::nextPhase), to name the engine in warnings
+		std::vector<Engine*> phaseEngines;
+		long phaseBase;
+		bool forceOrderWarned;
+		void nextForcePhase(Engine* e){ if(phaseEngines.empty()) phaseBase=forces.nextPhase(); else forces.nextPhase(); phaseEngines.push_back(e); }
+		void checkForceOrder();
+
 	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(Scene,Serializable,"Object comprising the whole simulation.",
 		((Real,dt,1e-8,,"Current timestep for integration."))
 		((long,iter,0,Attr::readonly,"Current iteration (computational step) number"))
@@ -93,6 +101,7 @@ class Scene: public Serializable{
 		((Real,stopAtTime,0,,"Time after which to stop the simulation"))
 		((bool,isPeriodic,false,Attr::readonly,"Whether periodic boundary conditions are active."))
 		((bool,trackEnergy,false,Attr::readonly,"Whether energies are being traced."))
+		((bool,deterministic,false,,"Sum forces and energies in an order which does not depend on the number of threads, so that trajectories are bitwise reproducible (see :yref:`O.deterministic<Omega.deterministic>`)."))
 		((bool,doSort,false,Attr::readonly,"Used, when new body is added to the scene."))
 		((bool,runInternalConsistencyChecks,true,Attr::hidden,"Run internal consistency check, right before the very first simulation step."))
 		((Body::id_t,selectedBody,-1,,"Id of body that is selected by the user"))
@@ -105,6 +114,7 @@ class Scene: public Serializable{
 		((shared_ptr<BodyContainer>,bodies,new BodyContainer,Attr::hidden,"Bodies contained in the scene."))
 		((shared_ptr<InteractionContainer>,interactions,new InteractionContainer,Attr::hidden,"All interactions between bodies."))
 		((shared_ptr<EnergyTracker>,energy,new EnergyTracker,Attr::hidden,"Energy values, if energy tracking is enabled."))
+		((shared_ptr<EventLog>,events,new EventLog,Attr::hidden,"Discrete events (broken bonds, ...) reported by engines and functors."))
 		((vector<shared_ptr<Material> >,materials,,Attr::hidden,"Container of shared materials. Add elements using Scene::addMaterial, not directly. Do NOT remove elements from here unless you know what you are doing!"))
 		((shared_ptr<Bound>,bound,,Attr::hidden,"Bounding box of the scene (only used for rendering and initialized if needed)."))
 
@@ -116,6 +126,7 @@ class Scene: public Serializable{
 			fillDefaultTags();
 			interactions->postLoad__calledFromScene(bodies);
 			SpeedElements.Zero();
+			phaseBase=0; forceOrderWarned=false;
 		,
 		/* py */
 		.add_property("localCoords",&Scene::usesLocalCoords,"Whether local coordianate system is used on interactions (set by :yref:`IGeomFunctor`).")
@@ -12,16 +12,9 @@
 #include<lib/multimethods/Indexable.hpp>
 #include<core/Dispatcher.hpp>
 
-#define BV_FUNCTOR_CACHE
-
-class BoundFunctor;
-
 class Shape: public Serializable, public Indexable {
 	public:
 		~Shape() {}; // vtable
-		#ifdef BV_FUNCTOR_CACHE
-			shared_ptr<BoundFunctor> boundFunctor;
-		#endif
 
 	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(Shape,Serializable,"Geometry of a body",
 		((Vector3r,color,Vector3r(1,1,1),,"Color for rendering (normalized RGB)."))
@@ -6,6 +6,7 @@
 #include<core/Cell.hpp>
 #include<core/Dispatcher.hpp>
 #include<core/EnergyTracker.hpp>
+#include<core/EventLog.hpp>
 #include<core/Engine.hpp>
 #include<core/FileGenerator.hpp>
 #include<core/Functor.hpp>
@@ -31,7 +32,7 @@
 	BOOST_CLASS_EXPORT(InteractionContainer);
 #endif
 
-YADE_PLUGIN((Body)(Bound)(Cell)(Dispatcher)(EnergyTracker)(Engine)(FileGenerator)(Functor)(GlobalEngine)(Interaction)(IGeom)(IPhys)(Material)(PartialEngine)(Shape)(State)(TimeStepper));
+YADE_PLUGIN((Body)(Bound)(Cell)(Dispatcher)(EnergyTracker)(Engine)(EventLog)(FileGenerator)(Functor)(GlobalEngine)(Interaction)(IGeom)(IPhys)(Material)(PartialEngine)(Shape)(State)(TimeStepper));
 
 EnergyTracker::~EnergyTracker(){} // vtable
 
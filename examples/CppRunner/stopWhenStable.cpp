@@ -0,0 +1,16 @@
+// Callback for CppRunner: stop the simulation when the packing is stable.
+// params[0] is the unbalanced force threshold, params[1] receives the last unbalanced force.
+//
+// compile with (adjust paths to yade sources and add -DYADE_OPENMP if yade uses OpenMP):
+//   g++ -shared -fPIC -O2 -std=c++0x -I/path/to/yade/source -I/usr/include/eigen3 $(python-config --includes) stopWhenStable.cpp -o stopWhenStable.so
+#include<core/Scene.hpp>
+#include<core/Omega.hpp>
+#include<pkg/common/CppRunner.hpp>
+#include<pkg/dem/Shop.hpp>
+
+extern "C" void yadeCallback(Scene* scene, CppRunner* runner){
+	if(runner->params.size()<2) runner->params.resize(2,0.);
+	Real unb=Shop::unbalancedForce(/*useMaxForce*/false,scene);
+	runner->params[1]=unb;
+	if(unb<runner->params[0]) scene->stopAtIter=scene->iter+1;
+}
@@ -0,0 +1,22 @@
+# encoding: utf-8
+# Deposit spheres under gravity and stop when the packing is stable; the stop criterion is compiled C++ code (stopWhenStable.cpp) called every step by CppRunner, instead of a PyRunner.
+from yade import pack
+import os
+
+lib=os.path.join(os.path.dirname(os.path.abspath(__file__)),'stopWhenStable.so')
+if not os.path.exists(lib): raise RuntimeError('Compile stopWhenStable.cpp first, see instructions at its top.')
+
+O.bodies.append(geom.facetBox((.5,.5,.5),(.5,.5,.5),wallMask=31))
+sp=pack.SpherePack()
+sp.makeCloud((0,0,0),(1,1,1),rMean=.04,rRelFuzz=.5)
+sp.toSimulation()
+O.engines=[
+	ForceResetter(),
+	InsertionSortCollider([Bo1_Sphere_Aabb(),Bo1_Facet_Aabb()]),
+	InteractionLoop([Ig2_Sphere_Sphere_ScGeom(),Ig2_Facet_Sphere_ScGeom()],[Ip2_FrictMat_FrictMat_FrictPhys()],[Law2_ScGeom_FrictPhys_CundallStrack()]),
+	NewtonIntegrator(gravity=(0,0,-9.81),damping=.4),
+	CppRunner(library=lib,iterPeriod=1,params=[.01,0],label='stopper')
+]
+O.dt=.5*PWaveTimeStep()
+O.run(); O.wait()
+print 'Stopped at iteration',O.iter,'with unbalanced force',stopper.params[1]
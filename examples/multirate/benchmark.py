@@ -0,0 +1,37 @@
+# encoding: utf-8
+# 2026 © Yade developers
+"""
+Compare single-rate (GlobalStiffnessTimeStepper) and multi-rate (MultiRateTimeStepper) integration
+of the same deposit with a wide size distribution (few fines among coarse grains).
+The script prints the wall-clock time needed to simulate the same virtual time with both.
+"""
+from yade import pack,timing
+import time
+
+def setup(multiRate):
+	O.reset()
+	sp=pack.SpherePack()
+	# coarse grains, and 5% of fines 10 times smaller
+	sp.makeCloud((0,0,0),(1,1,2),rMean=.04,rRelFuzz=.2,num=2000,seed=1)
+	sp.makeCloud((0,0,0),(1,1,2),rMean=.004,rRelFuzz=.2,num=100,seed=2)
+	O.bodies.append([utils.wall(0,axis=2,sense=1)]+[utils.sphere(c,r) for c,r in sp])
+	O.engines=[
+		ForceResetter(),
+		InsertionSortCollider([Bo1_Sphere_Aabb(),Bo1_Wall_Aabb()],verletDist=-.1),
+		InteractionLoop(
+			[Ig2_Sphere_Sphere_ScGeom(),Ig2_Wall_Sphere_ScGeom()],
+			[Ip2_FrictMat_FrictMat_FrictPhys()],
+			[Law2_ScGeom_FrictPhys_CundallStrack()]
+		),
+		(MultiRateTimeStepper(nLevels=4,timeStepUpdateInterval=100) if multiRate else GlobalStiffnessTimeStepper(timeStepUpdateInterval=100)),
+		NewtonIntegrator(damping=.3,gravity=(0,0,-9.81)),
+	]
+	O.dt=.5*utils.PWaveTimeStep()
+
+tEnd=.5
+for multiRate in (False,True):
+	setup(multiRate)
+	t0=time.time()
+	while O.time<tEnd: O.run(1000,True)
+	print ('multi-rate' if multiRate else 'single-rate'),': %d steps, %.2f s wall clock, unbalanced force %g'%(O.iter,time.time()-t0,utils.unbalancedForce())
+	if multiRate: print 'bodies per level:',O.engines[3].levelCounts
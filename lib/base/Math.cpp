@@ -9,6 +9,7 @@ template<> const Real Math<Real>::DEG_TO_RAD = Math<Real>::PI/180.0;
 template<> const Real Math<Real>::RAD_TO_DEG = 180.0/Math<Real>::PI;
 
 template<> int ZeroInitializer<int>(){ return (int)0; }
+template<> long ZeroInitializer<long>(){ return (long)0; }
 template<> Real ZeroInitializer<Real>(){ return (Real)0; }
 
 #ifdef YADE_MASK_ARBITRARY
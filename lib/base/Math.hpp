@@ -135,6 +135,7 @@ using Eigen::Quaternion;
 // template specialization will help us here
 template<typename EigenMatrix> EigenMatrix ZeroInitializer(){ return EigenMatrix::Zero(); };
 template<> int ZeroInitializer<int>();
+template<> long ZeroInitializer<long>();
 template<> Real ZeroInitializer<Real>();
 
 // io
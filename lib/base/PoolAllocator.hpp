@@ -0,0 +1,118 @@
+// 2026 © Yade developers
+#pragma once
+
+#include<boost/make_shared.hpp>
+#include<boost/thread/tss.hpp>
+#include<boost/thread/mutex.hpp>
+#include<algorithm>
+#include<atomic>
+#include<new>
+#include<vector>
+
+/* Counters of all pool allocations, summed over types and threads. Each thread (OpenMP, ThreadRunner, runScenes workers...)
+counts in its own counters, which are summed when read; they can be read at any time, also while other threads allocate. */
+struct PoolStats{
+	enum{ ALLOCATED=0, // blocks obtained from operator new
+		REUSED,         // blocks taken from a free list
+		RELEASED,       // blocks returned to a free list
+		FREED,          // blocks given back with operator delete (free list full, or its thread exited)
+		N_COUNTERS };
+	// counters of one thread; only that thread writes them, relaxed atomics make reading them from other threads safe
+	struct ThreadCounters{
+		std::atomic<long> n[N_COUNTERS];
+		ThreadCounters(){ for(int i=0; i<N_COUNTERS; i++) n[i].store(0,std::memory_order_relaxed); instance().attach(this); }
+		~ThreadCounters(){ instance().detach(this); if(cached()==this) cached()=NULL; }
+	};
+	static void count(int counter){
+		ThreadCounters* c=cached();
+		if(!c){ if(!counters().get()) counters().reset(new ThreadCounters); c=cached()=counters().get(); }
+		c->n[counter].store(c->n[counter].load(std::memory_order_relaxed)+1,std::memory_order_relaxed);
+	}
+	// sum over all threads since the last reset
+	long get(int counter){ boost::mutex::scoped_lock lock(mutex); return total(counter)-base[counter]; }
+	void reset(){ boost::mutex::scoped_lock lock(mutex); for(int i=0; i<N_COUNTERS; i++) base[i]=total(i); }
+	// never deleted, since threads may exit during static destruction
+	static PoolStats& instance(){ static PoolStats* stats=new PoolStats; return *stats; }
+	private:
+		boost::mutex mutex;
+		std::vector<ThreadCounters*> live;
+		// counts of threads which exited, and totals at the last reset
+		long exited[N_COUNTERS], base[N_COUNTERS];
+		PoolStats(){ for(int i=0; i<N_COUNTERS; i++) exited[i]=base[i]=0; }
+		long total(int counter){
+			long sum=exited[counter];
+			for(size_t i=0; i<live.size(); i++) sum+=live[i]->n[counter].load(std::memory_order_relaxed);
+			return sum;
+		}
+		void attach(ThreadCounters* c){ boost::mutex::scoped_lock lock(mutex); live.push_back(c); }
+		void detach(ThreadCounters* c){
+			boost::mutex::scoped_lock lock(mutex);
+			for(int i=0; i<N_COUNTERS; i++) exited[i]+=c->n[i].load(std::memory_order_relaxed);
+			live.erase(std::remove(live.begin(),live.end(),c),live.end());
+		}
+		static ThreadCounters*& cached(){ static __thread ThreadCounters* c=NULL; return c; }
+		static boost::thread_specific_ptr<ThreadCounters>& counters(){ static boost::thread_specific_ptr<ThreadCounters>* c=new boost::thread_specific_ptr<ThreadCounters>; return *c; }
+};
+
+/* Allocator keeping freed blocks in per-type, per-thread free lists, for objects which are created and destroyed
+at high rate, such as IGeom and IPhys of short-lived contacts. A block freed by another thread than the one which
+allocated it joins the free list of the freeing thread. Each list holds at most maxFree blocks, further blocks are
+deleted right away; the list is deleted when its thread exits (ThreadRunner and OpenMP threads come and go).
+
+Use through pooledShared<T>(), which places the shared_ptr control block and the object in one pooled block.
+*/
+template<class T>
+class PoolAllocator{
+	// free list of one thread; a free block stores pointer to the next one
+	struct FreeList{
+		void* head; size_t size;
+		FreeList(): head(NULL), size(0){}
+		~FreeList(){
+			while(head){ void* p=head; head=*static_cast<void**>(p); ::operator delete(p); PoolStats::count(PoolStats::FREED); }
+			// deallocations later during this thread's exit must not use the deleted list
+			if(cached()==this) cached()=NULL;
+		}
+	};
+	// fast access to the list of this thread, owned by lists()
+	static FreeList*& cached(){ static __thread FreeList* l=NULL; return l; }
+	// never deleted, since blocks may be deallocated during static destruction
+	static boost::thread_specific_ptr<FreeList>& lists(){ static boost::thread_specific_ptr<FreeList>* l=new boost::thread_specific_ptr<FreeList>; return *l; }
+	static FreeList& freeList(){
+		FreeList*& l=cached();
+		if(!l){ if(!lists().get()) lists().reset(new FreeList); l=lists().get(); }
+		return *l;
+	}
+	public:
+		// maximum number of free blocks kept per thread
+		static const size_t maxFree=1<<16;
+		typedef T value_type; typedef T* pointer; typedef const T* const_pointer; typedef T& reference; typedef const T& const_reference;
+		typedef std::size_t size_type; typedef std::ptrdiff_t difference_type;
+		template<class U> struct rebind{ typedef PoolAllocator<U> other; };
+		PoolAllocator(){}
+		template<class U> PoolAllocator(const PoolAllocator<U>&){}
+		pointer address(reference x) const { return &x; }
+		const_pointer address(const_reference x) const { return &x; }
+		size_type max_size() const { return size_type(-1)/sizeof(T); }
+		void construct(pointer p, const T& val){ new((void*)p) T(val); }
+		void destroy(pointer p){ p->~T(); }
+		pointer allocate(size_type n, const void* =0){
+			if(n!=1) return static_cast<pointer>(::operator new(n*sizeof(T)));
+			FreeList& l=freeList();
+			if(l.head){ void* p=l.head; l.head=*static_cast<void**>(p); l.size--; PoolStats::count(PoolStats::REUSED); return static_cast<pointer>(p); }
+			PoolStats::count(PoolStats::ALLOCATED);
+			return static_cast<pointer>(::operator new(std::max(sizeof(T),sizeof(void*))));
+		}
+		void deallocate(pointer p, size_type n){
+			if(n!=1){ ::operator delete((void*)p); return; }
+			FreeList& l=freeList();
+			if(l.size>=maxFree){ ::operator delete((void*)p); PoolStats::count(PoolStats::FREED); return; }
+			*reinterpret_cast<void**>(p)=l.head; l.head=(void*)p; l.size++;
+			PoolStats::count(PoolStats::RELEASED);
+		}
+};
+template<class T, class U> bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&){ return true; }
+template<class T, class U> bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&){ return false; }
+
+//! Return new default-constructed instance of T allocated from the pool; use as drop-in for shared_ptr<T>(new T)
+template<class T>
+boost::shared_ptr<T> pooledShared(){ return boost::allocate_shared<T>(PoolAllocator<T>()); }
@@ -7,6 +7,61 @@
 #include <boost/serialization/split_free.hpp>
 #include <cstdlib>
 #include <unistd.h>
+#include <limits>
+#include <cmath>
+
+/* Exact sum of floating-point numbers, independent of the order of additions (hence of how they are distributed between threads).
+
+The sum is kept as fixed-point number spanning the whole exponent range of T, in base-2^32 digits stored in 64-bit integers;
+each addition touches only the few digits covered by the mantissa, and carries are propagated once per 2^30 additions.
+It is used for energies in the deterministic mode (Scene::deterministic), where per-thread floating-point sums would depend on the number of threads.
+*/
+template<typename T>
+class ExactSum{
+	enum { digitBits=32 };
+	// exponent of the least significant bit of the smallest denormal
+	static const int minExp=std::numeric_limits<T>::min_exponent-std::numeric_limits<T>::digits;
+	static const int nDigits=(std::numeric_limits<T>::max_exponent-minExp)/digitBits+2;
+	int64_t digits[nDigits];
+	long nAdded;
+	// bring all digits but the last one to [0,2^32)
+	static void normalize(int64_t* d){
+		for(int k=0; k<nDigits-1; k++){
+			int64_t carry=d[k]/(int64_t(1)<<digitBits);
+			if(d[k]-carry*(int64_t(1)<<digitBits)<0) carry--;
+			d[k]-=carry*(int64_t(1)<<digitBits); d[k+1]+=carry;
+		}
+	}
+	public:
+		ExactSum(){ reset(); }
+		void reset(){ memset(digits,0,sizeof(digits)); nAdded=0; }
+		void add(const T& x){
+			if(x==0) return;
+			int e; std::frexp(x,&e); // |x|<2^e
+			T rest=std::abs(x);
+			for(int k=(e-1-minExp)/digitBits; rest>0; k--){
+				// value of digit k; exact, since the mantissa of rest is only shifted
+				const T d=std::floor(std::ldexp(rest,-(minExp+k*digitBits)));
+				rest-=std::ldexp(d,minExp+k*digitBits);
+				digits[k]+=(x>0?int64_t(d):-int64_t(d));
+			}
+			if(++nAdded>=(1L<<30)){ normalize(digits); nAdded=0; }
+		}
+		void operator+=(const ExactSum& other){
+			int64_t d[nDigits]; memcpy(d,other.digits,sizeof(d)); normalize(d); normalize(digits);
+			for(int k=0; k<nDigits; k++) digits[k]+=d[k];
+			nAdded=1;
+		}
+		// value rounded to T; normalized digits are unique for each exact sum, hence the result is the same for the same set of numbers added
+		T get() const {
+			int64_t d[nDigits]; memcpy(d,digits,sizeof(d)); normalize(d);
+			bool negative=(d[nDigits-1]<0);
+			if(negative){ for(int k=0; k<nDigits; k++) d[k]=-d[k]; normalize(d); }
+			T ret=0;
+			for(int k=0; k<nDigits; k++) if(d[k]!=0) ret+=std::ldexp(T(d[k]),minExp+k*digitBits);
+			return negative?-ret:ret;
+		}
+};
 
 #ifdef YADE_OPENMP
 #include "omp.h"
@@ -144,6 +144,17 @@ class DynLibDispatcher
 	MatrixType callBacks;		// multidimensional matrix that stores functors ( 1D, 2D, 3D, 4D, ....)
 	MatrixIntType callBacksInfo;	// multidimensional matrix for extra information about functors in the matrix
 						// currently used to remember if it is reversed functor
+
+	/* Dense dispatch table, resolved for all pairs of class indices by buildDispatchTable1D/2D (at engine setup),
+	so that lookups never walk the class hierarchy at runtime; flattened, [ix1] for 1D and [ix1*dispatchTableN2+ix2] for 2D.
+	dispatchTableInfo holds the callBacksInfo value (0 or 1) for resolved functors, DISPATCH_NONE for undefined dispatch
+	and DISPATCH_UNRESOLVED for ambiguous dispatch, which is looked up again (and reported) only if really needed.
+	Indices outside the table (classes created after the table was built) fall back to locate*.
+	The table is invalidated whenever functors are added or the matrix is cleared. */
+	enum { DISPATCH_NONE=-1, DISPATCH_UNRESOLVED=-2 };
+	std::vector<shared_ptr<Executor> > dispatchTable;
+	std::vector<signed char> dispatchTableInfo;
+	int dispatchTableN1, dispatchTableN2;
 						
 	// ParmNReal is defined to avoid ambigious function call for different dimensions of multimethod
 	typedef Loki::FunctorImpl<ResultType, TList > Impl;
@@ -175,7 +186,50 @@ class DynLibDispatcher
 			clearMatrix();
 		};
 		  
-		void clearMatrix(){ callBacks.clear(); callBacksInfo.clear(); }
+		void clearMatrix(){ callBacks.clear(); callBacksInfo.clear(); invalidateDispatchTable(); }
+
+		void invalidateDispatchTable(){ dispatchTable.clear(); dispatchTableInfo.clear(); dispatchTableN1=dispatchTableN2=0; }
+		/*! Whether the dense table covers all class indices up to maxIx1 (and maxIx2, for 2D). */
+		bool dispatchTableValid(int maxIx1, int maxIx2=0) const { return dispatchTableN1==maxIx1+1 && dispatchTableN2==maxIx2+1; }
+
+		/*! Resolve dispatch for all classes given as prototypes (one instance per class index; other instances are ignored) and store it in the dense table. */
+		void buildDispatchTable1D(const std::vector<shared_ptr<BaseClass1> >& protos, int maxIx1){
+			invalidateDispatchTable();
+			if(callBacks.size()<(size_t)maxIx1+1) callBacks.resize(maxIx1+1);
+			if(callBacksInfo.size()<(size_t)maxIx1+1) callBacksInfo.resize(maxIx1+1);
+			std::vector<shared_ptr<Executor> > table(maxIx1+1); std::vector<signed char> info(maxIx1+1,(signed char)DISPATCH_NONE);
+			FOREACH(shared_ptr<BaseClass1> p, protos){
+				int ix1=p->getClassIndex(); if(ix1<0 || ix1>maxIx1) continue;
+				if(locateMultivirtualFunctor1D(ix1,p)){ table[ix1]=callBacks[ix1]; info[ix1]=0; }
+			}
+			dispatchTable.swap(table); dispatchTableInfo.swap(info); dispatchTableN1=maxIx1+1; dispatchTableN2=1;
+		}
+		void buildDispatchTable2D(const std::vector<shared_ptr<BaseClass1> >& protos1, const std::vector<shared_ptr<BaseClass2> >& protos2, int maxIx1, int maxIx2){
+			invalidateDispatchTable();
+			const int N1=maxIx1+1, N2=maxIx2+1;
+			if(callBacks.size()<(size_t)N1) callBacks.resize(N1);
+			if(callBacksInfo.size()<(size_t)N1) callBacksInfo.resize(N1);
+			for(Iterator2 ci=callBacks.begin(); ci!=callBacks.end(); ++ci) if(ci->size()<(size_t)N2) ci->resize(N2);
+			for(IteratorInfo2 cii=callBacksInfo.begin(); cii!=callBacksInfo.end(); ++cii) if(cii->size()<(size_t)N2) cii->resize(N2);
+			std::vector<shared_ptr<Executor> > table(N1*N2); std::vector<signed char> info(N1*N2,(signed char)DISPATCH_NONE);
+			FOREACH(shared_ptr<BaseClass1> p1, protos1){
+				const int i1=p1->getClassIndex(); if(i1<0 || i1>maxIx1) continue;
+				FOREACH(shared_ptr<BaseClass2> p2, protos2){
+					const int i2=p2->getClassIndex(); if(i2<0 || i2>maxIx2) continue;
+					int ix1, ix2; const size_t k=i1*N2+i2;
+					const bool direct=(bool)callBacks[i1][i2];
+					try{
+						if(!locateMultivirtualFunctor2D(ix1,ix2,p1,p2,/*reportAmbiguous*/false)) continue;
+					} catch(std::runtime_error&){
+						// locate may have cached the first of the ambiguous candidates; drop it so that the ambiguity is reported when really dispatched
+						if(!direct) callBacks[i1][i2].reset();
+						info[k]=DISPATCH_UNRESOLVED; continue;
+					}
+					table[k]=callBacks[ix1][ix2]; info[k]=(signed char)callBacksInfo[ix1][ix2];
+				}
+			}
+			dispatchTable.swap(table); dispatchTableInfo.swap(info); dispatchTableN1=N1; dispatchTableN2=N2;
+		}
 
 		shared_ptr<Executor> getExecutor(shared_ptr<BaseClass1>& arg1){
 		  	int ix1;
@@ -194,7 +248,12 @@ class DynLibDispatcher
 		shared_ptr<Executor> getFunctor1D(shared_ptr<BaseClass1>& base1){ return getExecutor(base1); }
 		/* Return pointer to the functor for two base classes given. Swap is true if the dispatch objects should be swapped before calling Executor::go. */
 		shared_ptr<Executor> getFunctor2D(shared_ptr<BaseClass1>& base1, shared_ptr<BaseClass2>& base2, bool& swap){
-			int ix1, ix2;
+			int ix1=base1->getClassIndex(), ix2=base2->getClassIndex();
+			if(ix1>=0 && ix1<dispatchTableN1 && ix2>=0 && ix2<dispatchTableN2){
+				const size_t k=ix1*dispatchTableN2+ix2; const signed char info=dispatchTableInfo[k];
+				if(info==DISPATCH_NONE) return shared_ptr<Executor>();
+				if(info!=DISPATCH_UNRESOLVED){ swap=(bool)info; return dispatchTable[k]; }
+			}
 			if(!locateMultivirtualFunctor2D(ix1,ix2,base1,base2)) return shared_ptr<Executor>();
 			swap=(bool)(callBacksInfo[ix1][ix2]);
 			return callBacks[ix1][ix2];
@@ -248,6 +307,7 @@ class DynLibDispatcher
 			callBacks.resize( maxCurrentIndex+1 );	// make sure that there is a place for new Functor
 
 			callBacks[index] = executor;
+			invalidateDispatchTable();
 						
 			#if 0
 				cerr <<" New class added to DynLibDispatcher 1D: " << libName << endl;
@@ -316,6 +376,8 @@ class DynLibDispatcher
 				callBacksInfo	[index1][index2] = 0;
 			}
 
+			invalidateDispatchTable();
+
 			#if 0
 				cerr <<"Added new 2d functor "<<executor->getClassName()<<", callBacks size is "<<callBacks.size()<<","<<(callBacks.size()>0?callBacks[0].size():0)<<endl;
 			#endif
@@ -323,8 +385,10 @@ class DynLibDispatcher
 		
 
 		bool locateMultivirtualFunctor1D(int& index, shared_ptr<BaseClass1>& base) {
-			if(callBacks.empty()) return false;
 			index = base->getClassIndex();
+			// callBacks[index] is valid for all functors resolved in the dense table
+			if(index>=0 && index<dispatchTableN1) return dispatchTableInfo[index]!=DISPATCH_NONE;
+			if(callBacks.empty()) return false;
 			assert( index >= 0 && (unsigned int)( index ) < callBacks.size());
 			if(callBacks[index]) return true;
 			
@@ -353,11 +417,17 @@ class DynLibDispatcher
 			return false; // FIXME - this line should be not needed
 		}
 
-		bool locateMultivirtualFunctor2D(int& index1, int& index2, shared_ptr<BaseClass1>& base1,shared_ptr<BaseClass2>& base2) {
+		bool locateMultivirtualFunctor2D(int& index1, int& index2, shared_ptr<BaseClass1>& base1,shared_ptr<BaseClass2>& base2, bool reportAmbiguous=true) {
 			//#define _DISP_TRACE(msg) cerr<<"@DT@"<<__LINE__<<" "<<msg<<endl;
 			#define _DISP_TRACE(msg)
-			if(callBacks.empty()) return false;
 			index1=base1->getClassIndex(); index2 = base2->getClassIndex();
+			// callBacks[index1][index2] is valid for all functors resolved in the dense table
+			if(index1>=0 && index1<dispatchTableN1 && index2>=0 && index2<dispatchTableN2){
+				const signed char info=dispatchTableInfo[index1*dispatchTableN2+index2];
+				if(info==DISPATCH_NONE) return false;
+				if(info!=DISPATCH_UNRESOLVED) return true;
+			}
+			if(callBacks.empty()) return false;
 			assert(index1>=0); assert(index2>=0); 
 			assert((unsigned int)(index1)<callBacks.size()); assert((unsigned int)(index2)<callBacks[index1].size());
 			_DISP_TRACE("arg1: "<<base1->getClassName()<<"="<<index1<<"; arg2: "<<base2->getClassName()<<"="<<index2)
@@ -394,8 +464,11 @@ class DynLibDispatcher
 					distTooBig=false;
 					if(callBacks[ix1][ix2]){
 						if(foundIx1!=-1 && callBacks[foundIx1][foundIx2]!=callBacks[ix1][ix2]){ // we found a callback, but there already was one at this distance and it was different from the current one
-							cerr<<__FILE__<<":"<<__LINE__<<": ambiguous 2d dispatch ("<<"arg1="<<base1->getClassName()<<", arg2="<<base2->getClassName()<<", distance="<<dist<<"), dispatch matrix:"<<endl;
-							dumpDispatchMatrix2D(cerr,"AMBIGUOUS: "); throw runtime_error("Ambiguous dispatch.");
+							if(reportAmbiguous){
+								cerr<<__FILE__<<":"<<__LINE__<<": ambiguous 2d dispatch ("<<"arg1="<<base1->getClassName()<<", arg2="<<base2->getClassName()<<", distance="<<dist<<"), dispatch matrix:"<<endl;
+								dumpDispatchMatrix2D(cerr,"AMBIGUOUS: ");
+							}
+							throw runtime_error("Ambiguous dispatch.");
 						}
 						foundIx1=ix1; foundIx2=ix2;
 						callBacks[index1][index2]=callBacks[ix1][ix2]; callBacksInfo[index1][index2]=callBacksInfo[ix1][ix2];
@@ -16,6 +16,8 @@
 #include <sstream>
 #include "basicVTKwritter.hpp"
 //#include <utility>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
 
 namespace CGT
 {
@@ -189,6 +191,38 @@ bool KinematicLocalisationAnalyser::DefToFile(const char* state_file1, const cha
 	return 0;
 }
 
+static void loadStateFile(TriaxialState* state, string file_name, bool usebz2, bool* loaded)
+{
+	*loaded = state->from_file(file_name.c_str(), usebz2);
+}
+
+int KinematicLocalisationAnalyser::DefToFileSequence(const char* base_name, int first, int last, int step, const char* output_base, bool usebz2)
+{
+	consecutive = false;
+	bz2 = usebz2;
+	if (step<=0 || first+step>last) return 0;
+	if (!TS0) TS0 = new(TriaxialState);
+	if (!TS1->from_file((string(base_name)+_itoa(first)).c_str(), bz2)) return 0;
+	//each state is read once: the final state of an increment is the initial state of the next one, and the following state is loaded in the background while the current increment is processed
+	TriaxialState* next = new(TriaxialState);
+	next->NO_ZERO_ID = TS1->NO_ZERO_ID;
+	bool loaded = false;
+	boost::thread loader(boost::bind(&loadStateFile, next, string(base_name)+_itoa(first+step), bz2, &loaded));
+	int written = 0;
+	for (int n=first+step; n<=last; n+=step) {
+		loader.join();
+		if (!loaded) {cerr << "Error loading " << base_name << n << endl; break;}
+		TriaxialState* recycled = TS0;
+		TS0 = TS1; TS1 = next; next = recycled;
+		if (n+step<=last) loader = boost::thread(boost::bind(&loadStateFile, next, string(base_name)+_itoa(n+step), bz2, &loaded));
+		DefToFile((string(output_base)+_itoa(n)+".vtk").c_str());
+		++written;
+	}
+	if (loader.joinable()) loader.join();
+	delete(next);
+	return written;
+}
+
 bool KinematicLocalisationAnalyser::DefToFile(const char* output_file_name)
 {
 	computeParticlesDeformation();
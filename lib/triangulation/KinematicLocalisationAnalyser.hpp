@@ -60,6 +60,8 @@ class KinematicLocalisationAnalyser
 		///Write the averaged deformation on each grain in a file (vertices and cells lists included in the file), no need to call computeParticlesDeformation()
 		bool DefToFile (const char* output_file_name = "deformations");
 		bool DefToFile (const char* state_file1, const char* state_file0, const char* output_file_name="deformation.vtk", bool usebz2=false);
+		///Write deformations of all increments between states base_name+first, base_name+(first+step), ... up to base_name+last to output_base+n.vtk; returns the number of files written
+		int DefToFileSequence (const char* base_name, int first, int last, int step=1, const char* output_base="deformation", bool usebz2=false);
 		///Save/Load states using bz2 compression
 		bool bz2;
 		ofstream& ContactDistributionToFile ( ofstream& output_file );
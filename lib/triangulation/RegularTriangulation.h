@@ -16,6 +16,7 @@
 #include <CGAL/Triangulation_cell_base_with_info_3.h>
 #include <CGAL/Delaunay_triangulation_3.h>
 #include <CGAL/circulator.h>
+#include <CGAL/spatial_sort.h>
 #include <CGAL/number_utils.h>
 #include <boost/static_assert.hpp>
 
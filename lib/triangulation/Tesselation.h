@@ -79,6 +79,7 @@ public:
 	VectorCell cellHandles;//for speedup of global loops, iterating on this vector is faster than cellIterator++
 	bool redirected;//is vertexHandles filled with current vertex pointers? 
 	bool computed;
+	int ompThreads;//number of threads used in compute() and computeVolumes(), all available threads if <=0
 
 	_Tesselation(void);
 	_Tesselation(RTriangulation &T);// : Tri(&T) { Calcule(); }
@@ -86,6 +87,8 @@ public:
 	
 	///Insert a sphere
 	VertexHandle insert(Real x, Real y, Real z, Real rad, unsigned int id, bool isFictious = false);
+	///Insert many spheres at once, using spatial sorting and locate hints (much faster than insert() in a loop), returns the number of vertices created
+	unsigned int insertSpheres(const std::vector<Sphere>& spheres, const std::vector<unsigned int>& ids);
 	/// move a spheres
 	VertexHandle move (Real x, Real y, Real z, Real rad, unsigned int id);
 	///Fill a vector with vertexHandles[i] = handle of vertex with id=i for fast access
@@ -104,6 +107,7 @@ public:
 	static Segment  Dual	(FiniteFacetsIterator &facet);	//G�n�re le segment dual d'une facette finie
 	static Real	Volume	(FiniteCellsIterator cell);
 	inline void 	AssignPartialVolume	(FiniteEdgesIterator& ed_it);
+	std::pair<Real,Real> PartialVolumes	(const FiniteEdgesIterator& ed_it) const;//volumes assigned by AssignPartialVolume to both vertices of the edge, without modifying them
 	double		computeVFacetArea (FiniteEdgesIterator ed_it);
 	void		ResetVCellVolumes	(void);
 	void		computeVolumes		(void);//compute volume each voronoi cell
@@ -9,6 +9,10 @@
 //FIXME: handle that a better way
 #define MAX_ID 200000
 
+#ifdef YADE_OPENMP
+#include <omp.h>
+#endif
+
 namespace CGT {
 
 using std::cerr;
@@ -24,6 +28,7 @@ _Tesselation<TT>::_Tesselation ( void )
 	Tri = new RTriangulation;
 	Tes = Tri;
 	computed=false;
+	ompThreads=0;
 	maxId = -1;
 	TotalFiniteVoronoiVolume=0;
 	area=0;
@@ -34,7 +39,7 @@ _Tesselation<TT>::_Tesselation ( void )
 	vertexHandles.resize(MAX_ID+1,NULL);
 }
 template<class TT>
-_Tesselation<TT>::_Tesselation ( RTriangulation &T ) : Tri ( &T ), Tes ( &T ), computed ( false )
+_Tesselation<TT>::_Tesselation ( RTriangulation &T ) : Tri ( &T ), Tes ( &T ), computed ( false ), ompThreads ( 0 )
 {
 	std::cout << "Tesselation(RTriangulation &T)" << std::endl;
 	compute();
@@ -70,6 +75,46 @@ typename _Tesselation<TT>::VertexHandle _Tesselation<TT>::insert ( Real x, Real
 	else cout << id <<  " : Vh==NULL!!"<< " id=" << id << " Point=" << Point ( x,y,z ) << " rad=" << rad << endl;
 	return Vh;
 }
+//spatial sort traits for pairs (sphere pointer, id), so that spheres and ids are sorted without copies
+template<class Gt>
+struct SphereIdSortTraits : public Gt {
+	typedef std::pair<const Sphere*,unsigned int> Point_3;
+	struct Less_x_3 { bool operator()(const Point_3& p,const Point_3& q) const { return typename Gt::Less_x_3()(*(p.first),*(q.first)); } };
+	struct Less_y_3 { bool operator()(const Point_3& p,const Point_3& q) const { return typename Gt::Less_y_3()(*(p.first),*(q.first)); } };
+	struct Less_z_3 { bool operator()(const Point_3& p,const Point_3& q) const { return typename Gt::Less_z_3()(*(p.first),*(q.first)); } };
+	Less_x_3 less_x_3_object() const {return Less_x_3();}
+	Less_y_3 less_y_3_object() const {return Less_y_3();}
+	Less_z_3 less_z_3_object() const {return Less_z_3();}
+};
+
+template<class TT>
+unsigned int _Tesselation<TT>::insertSpheres ( const std::vector<Sphere>& spheres, const std::vector<unsigned int>& ids )
+{
+	assert(spheres.size()==ids.size());
+	typedef std::pair<const Sphere*,unsigned int> SphereId;
+	std::vector<SphereId> sorted; sorted.reserve(spheres.size());
+	unsigned int idMax=0;
+	for (unsigned int k=0; k<spheres.size(); k++) {sorted.push_back(SphereId(&spheres[k],ids[k])); idMax=max(idMax,ids[k]);}
+	if (vertexHandles.size()<=idMax) vertexHandles.resize(idMax+1,NULL);
+	//shuffling first keeps the biased randomized insertion order of CGAL's own insert(begin,end)
+	std::random_shuffle(sorted.begin(),sorted.end());
+	CGAL::spatial_sort(sorted.begin(),sorted.end(),SphereIdSortTraits<typename RTriangulation::Geom_traits>());
+	CellHandle hint;
+	unsigned int inserted=0;
+	for (typename std::vector<SphereId>::const_iterator p=sorted.begin(); p!=sorted.end(); ++p) {
+		LocateType lt; int li, lj;
+		CellHandle c = Tri->locate(*(p->first),lt,li,lj,hint);
+		VertexHandle v = Tri->insert(*(p->first),lt,c,li,lj);
+		if (v==VertexHandle()) {hint=c; continue;}//hidden sphere
+		v->info().setId(p->second);
+		vertexHandles[p->second]=v;
+		maxId = std::max(maxId,(int) p->second);
+		hint=v->cell();
+		++inserted;
+	}
+	return inserted;
+}
+
 template<class TT>
 typename _Tesselation<TT>::VertexHandle _Tesselation<TT>::move ( Real x, Real y, Real z, Real rad, unsigned int id )
 {
@@ -148,10 +193,17 @@ template<class TT>
 void _Tesselation<TT>::compute ()
 {
 	if (!redirected) redirect();
+	//cells are listed first, so that circumcenters can be computed in parallel
+	VectorCell cells; cells.reserve(Tri->number_of_finite_cells());
 	FiniteCellsIterator cellEnd = Tri->finite_cells_end();
-	for ( FiniteCellsIterator cell = Tri->finite_cells_begin(); cell != cellEnd; cell++ )
+	for ( FiniteCellsIterator cell = Tri->finite_cells_begin(); cell != cellEnd; cell++ ) cells.push_back(cell);
+	const long size=cells.size();
+	#ifdef YADE_OPENMP
+	#pragma omp parallel for num_threads(ompThreads>0 ? ompThreads : omp_get_max_threads())
+	#endif
+	for ( long k=0; k<size; k++ )
 	{
-
+		const CellHandle& cell = cells[k];
 		const Sphere& S0 = cell->vertex ( 0 )->point();
 		const Sphere& S1 = cell->vertex ( 1 )->point();
 		const Sphere& S2 = cell->vertex ( 2 )->point();
@@ -200,39 +252,41 @@ double _Tesselation<TT>::computeVFacetArea ( FiniteEdgesIterator ed_it )
 template<class TT>
 void _Tesselation<TT>::AssignPartialVolume ( FiniteEdgesIterator& ed_it )
 {
-	//EdgeIterator ed_it
+	const std::pair<Real,Real> vols = PartialVolumes ( ed_it );
+	ed_it->first->vertex ( ed_it->second )->info().v() += vols.first;
+	ed_it->first->vertex ( ed_it->third )->info().v() += vols.second;
+	TotalFiniteVoronoiVolume += vols.first+vols.second;
+}
+
+template<class TT>
+std::pair<Real,Real> _Tesselation<TT>::PartialVolumes ( const FiniteEdgesIterator& ed_it ) const
+{
+	//contributions of the edge to the Voronoi volumes of both vertices; nothing is modified, hence safe to run concurrently
+	std::pair<Real,Real> vols(0,0);
 	CellCirculator cell0=Tri->incident_cells ( *ed_it );
 	CellCirculator cell2=cell0;
 	if ( Tri->is_infinite ( cell2 ) )
 	{
 		++cell2;
 		while ( Tri->is_infinite ( cell2 ) && cell2!=cell0 ) ++cell2;
-		if ( cell2==cell0 ) return;
+		if ( cell2==cell0 ) return vols;
 	}
 	cell0=cell2++;
 	CellCirculator cell1=cell2++;
-	bool isFictious1 = ( ed_it->first )->vertex ( ed_it->second )->info().isFictious;
-	bool isFictious2 = ( ed_it->first )->vertex ( ed_it->third )->info().isFictious;
-	Real r;
+	const VertexHandle& v1 = ed_it->first->vertex ( ed_it->second );
+	const VertexHandle& v2 = ed_it->first->vertex ( ed_it->third );
+	bool isFictious1 = v1->info().isFictious;
+	bool isFictious2 = v2->info().isFictious;
 	while ( cell2!=cell0 )
 	{
 		if ( !Tri->is_infinite ( cell1 )  && !Tri->is_infinite ( cell2 ) )
 		{
-			if ( !isFictious1 )
-			{
-				r = std::abs ( ( Tetrahedron ( ed_it->first->vertex ( ed_it->second )->point(), cell0->info(), cell1->info(), cell2->info() ) ).volume() );
-				( ed_it->first )->vertex ( ed_it->second )->info().v() += r;
-				TotalFiniteVoronoiVolume+=r;
-			}
-			if ( !isFictious2 )
-			{
-				r = std::abs ( ( Tetrahedron ( ed_it->first->vertex ( ed_it->third )->point(), cell0->info(),  cell1->info(), cell2->info() ) ).volume() );
-				ed_it->first->vertex ( ed_it->third )->info().v() +=r;
-				TotalFiniteVoronoiVolume+=r;
-			}
+			if ( !isFictious1 ) vols.first += std::abs ( ( Tetrahedron ( v1->point(), cell0->info(), cell1->info(), cell2->info() ) ).volume() );
+			if ( !isFictious2 ) vols.second += std::abs ( ( Tetrahedron ( v2->point(), cell0->info(), cell1->info(), cell2->info() ) ).volume() );
 		}
 		++cell1; ++cell2;
 	}
+	return vols;
 }
 
 template<class TT>
@@ -248,9 +302,20 @@ void _Tesselation<TT>::computeVolumes ( void )
 {
 	if ( !computed ) compute();
 	ResetVCellVolumes();
-	for ( FiniteEdgesIterator ed_it=Tri->finite_edges_begin(); ed_it!=Tri->finite_edges_end();ed_it++ )
-	{
-		AssignPartialVolume ( ed_it );
+	//partial volumes of each edge are computed in parallel, then summed per vertex serially since edges share vertices
+	std::vector<FiniteEdgesIterator> edges; edges.reserve(Tri->number_of_finite_edges());
+	for ( FiniteEdgesIterator ed_it=Tri->finite_edges_begin(); ed_it!=Tri->finite_edges_end();ed_it++ ) edges.push_back(ed_it);
+	const long size=edges.size();
+	std::vector<std::pair<Real,Real> > partial(size);
+	#ifdef YADE_OPENMP
+	#pragma omp parallel for num_threads(ompThreads>0 ? ompThreads : omp_get_max_threads())
+	#endif
+	for ( long k=0; k<size; k++ ) partial[k]=PartialVolumes ( edges[k] );
+	for ( long k=0; k<size; k++ ) {
+		const FiniteEdgesIterator& ed_it = edges[k];
+		ed_it->first->vertex ( ed_it->second )->info().v() += partial[k].first;
+		ed_it->first->vertex ( ed_it->third )->info().v() += partial[k].second;
+		TotalFiniteVoronoiVolume += partial[k].first+partial[k].second;
 	}
 	//FIXME: find a way to compute a volume correctly for spheres of the boarders.
 }
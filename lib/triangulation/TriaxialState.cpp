@@ -13,9 +13,31 @@
 #include<boost/iostreams/filtering_stream.hpp>
 #include<boost/iostreams/filter/bzip2.hpp>
 #include<boost/iostreams/device/file.hpp>
+#include<boost/iostreams/device/mapped_file.hpp>
+#include<boost/iostreams/device/back_inserter.hpp>
+#include<boost/iostreams/copy.hpp>
+#include<cstring>
+#include<cctype>
+#include<stdint.h>
+#include<sstream>
 
 namespace CGT {
 
+namespace {
+	const char binaryMagic[8] = {'Y','A','D','E','T','S','0','1'};
+	//fixed-size records of the binary state files
+	struct BinaryGrain { int64_t id; double pos[3]; double rad; double trans[3]; double rot[3]; int64_t isSphere; };
+	struct BinaryContact { int64_t id1, id2; double normal[3], position[3], old_fn, old_fs[3], fn, fs[3], frictional_work; int64_t status; };
+	inline long readInt (const char*& p) {char* e; long v=strtol(p,&e,10); p=e; return v;}
+	inline Real readReal (const char*& p) {char* e; Real v=strtod(p,&e); p=e; return v;}
+	//text records are whitespace-separated tokens, like for operator>>; line breaks have no meaning
+	inline const char* skipSpace (const char* p, const char* end) {while (p<end && isspace(*p)) ++p; return p;}
+	inline const char* skipTokens (const char* p, const char* end, int n) {
+		for (int k=0; k<n; ++k) {p=skipSpace(p, end); while (p<end && !isspace(*p)) ++p;}
+		return skipSpace(p, end);}
+	const int grainTokens = 12, contactTokens = 18;
+}
+
 TriaxialState::TriaxialState(void) : NO_ZERO_ID(false), filter_distance(-0.1), tesselated(false) {}
 
 TriaxialState::~TriaxialState(void)
@@ -61,6 +83,23 @@ Real TriaxialState::find_parameter (const char* parameter_name, boost::iostreams
 	return value;
 }
 
+Real TriaxialState::find_parameter (const char* parameter_name, std::istream& file)
+{
+	string buffer;
+	Real value;
+	file >> buffer;
+	bool test = (buffer == string(parameter_name));
+	while (!test)
+	{
+		buffer.clear();
+		file >> buffer;
+		test = ( buffer == string(parameter_name) || file.eof());
+	}
+	if (!file.eof()) file >> value;
+	else value = 0;
+	return value;
+}
+
 Real TriaxialState::find_parameter (const char* parameter_name, const char* filename)
 {
 	ifstream statefile (filename);
@@ -114,14 +153,15 @@ TriaxialState::Tesselation& TriaxialState::Tesselate (void)
 	if (!tesselated)
 	{
 		Tes.Clear();
-		GrainIterator git = grains_begin();
 		GrainIterator last = grains_end();
-		Tes.vertexHandles.resize(grains.size()+ NO_ZERO_ID ? 1 : 0);
-		for (; git!=last; ++git) {
-			if (git->id != -1 /*&& git->isSphere*/)	Tes.vertexHandles[git->id] = Tes.insert(git->sphere.x(), git->sphere.y(), git->sphere.z(), git->sphere.weight(),git->id,!git->isSphere);
-			//vh->->info() = git->translation; FIXME : this could define displacements in the triangulation itself
-//			cerr << "Tes.insert(git->sphere.x(), git->sphere.y(), git->sphere.z(), git->sphere.weight(), git->id);" << endl;
-		}
+		vector<Sphere> spheres; vector<unsigned int> ids;
+		spheres.reserve(grains.size()); ids.reserve(grains.size());
+		for (GrainIterator git = grains_begin(); git!=last; ++git)
+			if (git->id != -1 /*&& git->isSphere*/) {spheres.push_back(Sphere(git->sphere.point(), pow(git->sphere.weight(),2))); ids.push_back(git->id);}
+		//spatially sorted insertion, much faster than inserting grains in the order of their ids
+		Tes.insertSpheres(spheres, ids);
+		for (GrainIterator git = grains_begin(); git!=last; ++git)
+			if (git->id != -1 && Tes.vertexHandles[git->id]!=NULL) Tes.vertexHandles[git->id]->info().isFictious = !git->isSphere;
 		Tes.redirected = true;//vertexHandle has been filled here, no need to do it again
 		tesselated = true;
 		cerr << "Triangulated Grains : " << Tes.Triangulation().number_of_vertices() << endl;
@@ -157,38 +197,40 @@ bool TriaxialState::inside(Point p)
 bool TriaxialState::from_file(const char* filename, bool bz2)
 {
 	reset();
-	
-//	// Don't use bzipped files
-//	// 	cout << filename << endl;
-//	ifstream Statefile(filename);
-// 	if (!Statefile.is_open()) {
-// 		cout << "Error opening files";
-// 		return false;
-// 	}
-	
-//	// Use bzipped files
-	
-	boost::iostreams::filtering_istream Statefile;
-	if (bz2) {
-		Statefile.push(boost::iostreams::bzip2_decompressor());
-		Statefile.push(boost::iostreams::file_source(string(filename)+".bz2"));}
-	else Statefile.push(boost::iostreams::file_source(string(filename)));
-	if(!Statefile.good()) {cerr << "Error opening files"; return false;}
-	
-	long Idg;
-	long Ns=0;//number of spheres (excluding fictious ones))
-	Statefile >> Ng;
-	//Real x, y, z, rad; //coordonn�es/rayon
-	//Real tx, ty, tz;
-	Point pos(CGAL::ORIGIN);
-	mean_radius=0;
-	CVector trans, rot;
-	Real rad; //coordonn�es/rayon
-	bool isSphere;
+	try {
+		if (bz2) {
+			boost::iostreams::filtering_istream Statefile;
+			Statefile.push(boost::iostreams::bzip2_decompressor());
+			Statefile.push(boost::iostreams::file_source(string(filename)+".bz2"));
+			if(!Statefile.good()) {cerr << "Error opening files"; return false;}
+			string content;
+			boost::iostreams::copy(Statefile, boost::iostreams::back_inserter(content));
+			const char* begin = content.data();
+			if (content.size()>=8 && !memcmp(begin,binaryMagic,8)) return parseBinary(begin, begin+content.size());
+			return parseText(begin, begin+content.size());
+		}
+		//uncompressed files are mapped rather than read, pages are loaded while parsing
+		boost::iostreams::mapped_file_source Statefile(filename);
+		const char* begin = Statefile.data();
+		if (Statefile.size()>=8 && !memcmp(begin,binaryMagic,8)) return parseBinary(begin, begin+Statefile.size());
+		//strtod needs a delimiter after the last number, the mapping may end right after it
+		if (Statefile.size()>0 && !isspace(begin[Statefile.size()-1])) {
+			string content(begin, Statefile.size());
+			return parseText(content.c_str(), content.c_str()+content.size());}
+		return parseText(begin, begin+Statefile.size());
+	} catch (std::exception& e) {
+		cerr << "Error opening files (" << e.what() << ")" << endl;
+		return false;
+	}
+}
 
+bool TriaxialState::parseText(const char* begin, const char* end)
+{
+	const char* p = begin;
+	Ng = readInt(p);
+	p = skipSpace(p, end);
 
 	grains.resize(Ng+1);
-	//cout << "Ngrains =" << Ng << endl;
 	if (NO_ZERO_ID) {
 		GrainIterator git= grains.begin();
 		git->id=0;
@@ -196,60 +238,70 @@ bool TriaxialState::from_file(const char* filename, bool bz2)
 		git->translation = CGAL::NULL_VECTOR;
 		git->rotation = CGAL::NULL_VECTOR;
 	}
-
-	long i= NO_ZERO_ID ? 1 : 0;
-
-	for (; i <= Ng ; ++i) {
-		Statefile >> Idg >> pos >> rad >> trans >> rot  >> isSphere;
-		grains[Idg].id = Idg;
-		grains[Idg].sphere = Sphere(pos, rad);
-		grains[Idg].translation = trans;
-		grains[Idg].rotation = rot;
-		grains[Idg].isSphere = isSphere;
-
-		box.base = Point(min(box.base.x(), pos.x()-rad),
-						 min(box.base.y(), pos.y()-rad),
-						 min(box.base.z(), pos.z()-rad));
-		box.sommet = Point(max(box.sommet.x(), pos.x()+rad),
-						   max(box.sommet.y(), pos.y()+rad),
-						   max(box.sommet.z(), pos.z()+rad));
-		if (isSphere) {mean_radius += grains[Idg].sphere.weight(); ++Ns;}
-		//cout << "Idg: "<< Idg << " sphere: " << grains[Idg].sphere << " trans: " << grains[Idg].translation << endl;
+	//find where records start by skipping tokens (cheap), then convert them in parallel
+	long first = NO_ZERO_ID ? 1 : 0;
+	vector<const char*> records(Ng+2-first);
+	for (unsigned long i=0; i<records.size(); ++i) {records[i]=p; if (i+1<records.size()) p=skipTokens(p, end, grainTokens);}
+	long failed = 0;//number of bad records, summed over threads
+	#ifdef YADE_OPENMP
+	#pragma omp parallel for schedule(static) reduction(+:failed)
+	#endif
+	for (long i=0; i<(long)records.size()-1; ++i) {
+		const char* q = records[i];
+		long Idg = readInt(q);
+		Real v[10];
+		for (int k=0; k<10; ++k) v[k]=readReal(q);
+		bool isSphere = readInt(q);
+		//every token must have been consumed as a number
+		if (skipSpace(q, end)!=records[i+1] || Idg<0 || Idg>Ng) {++failed; continue;}
+		Grain& g = grains[Idg];
+		g.id = Idg;
+		g.sphere = Sphere(Point(v[0],v[1],v[2]), v[3]);
+		g.translation = CVector(v[4],v[5],v[6]);
+		g.rotation = CVector(v[7],v[8],v[9]);
+		g.isSphere = isSphere;
 	}
-	mean_radius /= Ns;//rayon moyen
-	//cout << filename << " loaded : " << Ng << " grains with mean radius = " << mean_radius << endl;
-
-	long id1, id2;
-	int stat;
-	CVector c_pos, normal, old_fs, fs;
-	Real old_fn, fn, frictional_work;
-	Statefile >> Nc;
+	if (failed) {cerr << "Error reading grains" << endl; return false;}
+	setBoxAndMeanRadius();
+
+	const char* q = p;
+	Nc = readInt(p);
+	if (p==q || Nc<0) {cerr << "Error reading contacts" << endl; return false;}
+	p = skipSpace(p, end);
+	records.resize(Nc+1);
+	for (long i=0; i<=Nc; ++i) {records[i]=p; if (i<Nc) p=skipTokens(p, end, contactTokens);}
 	contacts.resize(Nc);
-
+	#ifdef YADE_OPENMP
+	#pragma omp parallel for schedule(static) reduction(+:failed)
+	#endif
 	for (long i=0 ; i < Nc ; ++i) {
+		const char* q = records[i];
+		long id1 = readInt(q), id2 = readInt(q);
+		Real v[15];//normal (recomputed below), position, old_fn, old_fs, fn, fs, frictional_work
+		for (int k=0; k<15; ++k) v[k]=readReal(q);
+		int stat = readInt(q);
+		if (skipSpace(q, end)!=records[i+1] || id1<0 || id1>Ng || id2<0 || id2>Ng) {++failed; contacts[i]=NULL; continue;}
 		Contact* c = new Contact;
-		Statefile >> id1 >> id2 >> normal >> c_pos >> old_fn >> old_fs >> fn >> fs >> frictional_work >> stat;
-		
-		normal = (grains[id2].sphere.point()-grains[id1].sphere.point());
-		normal = normal/sqrt(pow(normal.x(),2)+pow(normal.y(),2)+pow(normal.z(),2));
+		CVector normal = (grains[id2].sphere.point()-grains[id1].sphere.point());
+		c->normal = normal/sqrt(normal.squared_length());
 		c->grain1 = &(grains[id1]);
 		c->grain2 = &(grains[id2]);
-		grains[id1].contacts.push_back(c);
-		grains[id2].contacts.push_back(c);
-		c->normal = normal;
-		c->position = c_pos;
-		c->old_fn = old_fn;
-		c->old_fs = old_fs;
-		c->fn = fn;
-		c->fs = fs;
-		c->frictional_work = frictional_work;
+		c->position = CVector(v[3],v[4],v[5]);
+		c->old_fn = v[6];
+		c->old_fs = CVector(v[7],v[8],v[9]);
+		c->fn = v[10];
+		c->fs = CVector(v[11],v[12],v[13]);
+		c->frictional_work = v[14];
 		c->status = (Contact::Status) stat;
-		if (contacts[i]) delete contacts[i];
 		contacts[i] = c;
 	}
+	if (failed) {cerr << "Error reading contacts" << endl; return false;}
+	for (long i=0 ; i < Nc ; ++i) {
+		contacts[i]->grain1->contacts.push_back(contacts[i]);
+		contacts[i]->grain2->contacts.push_back(contacts[i]);
+	}
 
-	//cout << "c_pos=" << contacts[10]->position << " old_fn=" << contacts[10]->old_fn << " normal=" << contacts[10]->normal << endl;
-	//rfric = find_parameter("rfric=", Statefile);// � remettre quand les fichiers n'auront plus l'espace de trop...
+	std::istringstream Statefile(string(p, end));
 	Eyn = find_parameter("Eyn", Statefile);
 	Eys = find_parameter("Eys", Statefile);
 	wszzh = find_parameter("wszzh", Statefile);
@@ -264,60 +316,138 @@ bool TriaxialState::from_file(const char* filename, bool bz2)
 	prof = find_parameter("prof", Statefile);
 	ratio_f = find_parameter("ratio_f", Statefile);
 	vit = find_parameter("vit", Statefile);
-	
-// 	//Don't use bzipped files
-// 	Statefile.close();
-	
-	
-	//cout << endl << "wszzh= " << wszzh << endl;
-
-	/*GrainIterator grains_end = grains.end();
-	for (GrainIterator it=grains.begin(); it!=grains_end; ++it)
-	{
-	 if (it==grains.begin()) ++it;
-	 Vue1.Dessine_Sphere(it->sphere.x(), it->sphere.y(), it->sphere.z(), it->sphere.weight(), 10);
-	}*/
-	//Vue1.Affiche();
+	return true;
+}
+
+bool TriaxialState::parseBinary(const char* begin, const char* end)
+{
+	const char* p = begin+8;
+	int64_t header[2];
+	if (end-p < (long)sizeof(header)) {cerr << "Truncated state file" << endl; return false;}
+	memcpy(header, p, sizeof(header)); p+=sizeof(header);
+	Ng = header[0]; Nc = header[1];
+	if (Ng<0 || Nc<0) {cerr << "Error reading state file header" << endl; return false;}
+	if (end-p < (long)((Ng+1)*sizeof(BinaryGrain)+Nc*sizeof(BinaryContact)+14*sizeof(double))) {cerr << "Truncated state file" << endl; return false;}
+	grains.resize(Ng+1);
+	const char* grainData = p;
+	#ifdef YADE_OPENMP
+	#pragma omp parallel for schedule(static)
+	#endif
+	for (long i=0; i<=Ng; ++i) {
+		BinaryGrain b; memcpy(&b, grainData+i*sizeof(BinaryGrain), sizeof(b));
+		Grain& g = grains[i];
+		g.id = b.id;
+		g.sphere = Sphere(Point(b.pos[0],b.pos[1],b.pos[2]), b.rad);
+		g.translation = CVector(b.trans[0],b.trans[1],b.trans[2]);
+		g.rotation = CVector(b.rot[0],b.rot[1],b.rot[2]);
+		g.isSphere = b.isSphere;
+	}
+	p += (Ng+1)*sizeof(BinaryGrain);
+	setBoxAndMeanRadius();
 
+	contacts.resize(Nc);
+	const char* contactData = p;
+	long failed = 0;
+	#ifdef YADE_OPENMP
+	#pragma omp parallel for schedule(static) reduction(+:failed)
+	#endif
+	for (long i=0; i<Nc; ++i) {
+		BinaryContact b; memcpy(&b, contactData+i*sizeof(BinaryContact), sizeof(b));
+		if (b.id1<0 || b.id1>Ng || b.id2<0 || b.id2>Ng) {++failed; contacts[i]=NULL; continue;}
+		Contact* c = new Contact;
+		c->grain1 = &(grains[b.id1]);
+		c->grain2 = &(grains[b.id2]);
+		c->normal = CVector(b.normal[0],b.normal[1],b.normal[2]);
+		c->position = CVector(b.position[0],b.position[1],b.position[2]);
+		c->old_fn = b.old_fn;
+		c->old_fs = CVector(b.old_fs[0],b.old_fs[1],b.old_fs[2]);
+		c->fn = b.fn;
+		c->fs = CVector(b.fs[0],b.fs[1],b.fs[2]);
+		c->frictional_work = b.frictional_work;
+		c->status = (Contact::Status) b.status;
+		contacts[i] = c;
+	}
+	if (failed) {cerr << "Error reading contacts" << endl; return false;}
+	p += Nc*sizeof(BinaryContact);
+	for (long i=0 ; i < Nc ; ++i) {
+		contacts[i]->grain1->contacts.push_back(contacts[i]);
+		contacts[i]->grain2->contacts.push_back(contacts[i]);
+	}
+	double params[14]; memcpy(params, p, sizeof(params));
+	Eyn=params[0]; Eys=params[1]; wszzh=params[2]; wsxxd=params[3]; wsyyfa=params[4]; eps3=params[5]; eps1=params[6];
+	eps2=params[7]; porom=params[8]; haut=params[9]; larg=params[10]; prof=params[11]; ratio_f=params[12]; vit=params[13];
 	return true;
 }
 
-bool TriaxialState::to_file(const char* filename, bool bz2)
+void TriaxialState::setBoxAndMeanRadius(void)
+{
+	long Ns=0;//number of spheres (excluding fictious ones))
+	mean_radius=0;
+	for (GrainIterator git=grains_begin(); git!=grains_end(); ++git) {
+		if (git->id<0) continue;
+		const Point& pos = git->sphere.point();
+		Real rad = git->sphere.weight();
+		box.base = Point(min(box.base.x(), pos.x()-rad),
+						 min(box.base.y(), pos.y()-rad),
+						 min(box.base.z(), pos.z()-rad));
+		box.sommet = Point(max(box.sommet.x(), pos.x()+rad),
+						   max(box.sommet.y(), pos.y()+rad),
+						   max(box.sommet.z(), pos.z()+rad));
+		if (git->isSphere) {mean_radius += rad; ++Ns;}
+	}
+	mean_radius /= Ns;//rayon moyen
+}
+
+bool TriaxialState::to_file(const char* filename, bool bz2, bool binary)
 {
-	//string fname (filename);
-	
-	// use bzipped files
 	boost::iostreams::filtering_ostream Statefile;
-	
-	//if(boost::algorithm::ends_with(filename,".bz2")) Statefile.push(iostreams::bzip2_compressor());
 	if (bz2) {
 		Statefile.push(boost::iostreams::bzip2_compressor());
-		Statefile.push(boost::iostreams::file_sink(string(filename)+".bz2"));}
-	else Statefile.push(boost::iostreams::file_sink(string(filename)));
-	// Don't use bzipped files
-	//ofstream Statefile (filename);
-	//if (!Statefile.is_open())	{
+		Statefile.push(boost::iostreams::file_sink(string(filename)+".bz2", binary ? std::ios::out|std::ios::binary : std::ios::out));}
+	else Statefile.push(boost::iostreams::file_sink(string(filename), binary ? std::ios::out|std::ios::binary : std::ios::out));
 	if(!Statefile.good()) {
 		cerr << "Error opening files";
 		return false;	}
 
-		long Id_max = grains.size()-1;
-		Statefile << Id_max << endl;
-		for (long Idg=0 ; Idg <= Id_max ; ++Idg) 
-		{
-			Statefile << grains[Idg].id <<	" " << grains[Idg].sphere.point() << " " << grains[Idg].sphere.weight() << " " << grains[Idg].translation << " " << grains[Idg].rotation << " "<<grains[Idg].isSphere << endl;
+	long Id_max = grains.size()-1;
+	long Nc = contacts.size();
+	if (binary) {
+		Statefile.write(binaryMagic, 8);
+		int64_t header[2] = {Id_max, Nc};
+		Statefile.write((const char*) header, sizeof(header));
+		for (long Idg=0 ; Idg <= Id_max ; ++Idg) {
+			const Grain& g = grains[Idg];
+			BinaryGrain b;
+			b.id = g.id; b.rad = g.sphere.weight(); b.isSphere = g.isSphere;
+			for (int k=0; k<3; ++k) {b.pos[k]=g.sphere.point()[k]; b.trans[k]=g.translation[k]; b.rot[k]=g.rotation[k];}
+			Statefile.write((const char*) &b, sizeof(b));
 		}
-		long Nc = contacts.size();
-		Statefile << Nc << endl;
-		for (long i=0 ; i < Nc ; ++i)
-		{			
-			Statefile << contacts[i]->grain1->id << " " << contacts[i]->grain2->id << " " << contacts[i]->normal << " " << contacts[i]->position << " " << contacts[i]->old_fn << " " << contacts[i]->old_fs << " " << contacts[i]->fn << " " << contacts[i]->fs << " " << contacts[i]->frictional_work << " " << contacts[i]->status << endl;
+		for (long i=0 ; i < Nc ; ++i) {
+			const Contact& c = *contacts[i];
+			BinaryContact b;
+			b.id1 = c.grain1->id; b.id2 = c.grain2->id;
+			b.old_fn = c.old_fn; b.fn = c.fn; b.frictional_work = c.frictional_work; b.status = c.status;
+			for (int k=0; k<3; ++k) {b.normal[k]=c.normal[k]; b.position[k]=c.position[k]; b.old_fs[k]=c.old_fs[k]; b.fs[k]=c.fs[k];}
+			Statefile.write((const char*) &b, sizeof(b));
 		}
-
-		Statefile << "Eyn " << Eyn << " Eys " << Eys << " wszzh " << wszzh << " wsxxd " << wsxxd << " wsyyfa " << wsyyfa << " eps3 " << eps3 << " eps1 " << eps1 << " eps2 " << eps2 << " porom " << porom << " haut " << haut << " larg " << larg << " prof " << prof << " ratio_f " << ratio_f << " vit " << vit << endl;
-//	 	//Don't use bzipped files
-//		Statefile.close();
+		double params[14] = {Eyn, Eys, wszzh, wsxxd, wsyyfa, eps3, eps1, eps2, porom, haut, larg, prof, ratio_f, vit};
+		Statefile.write((const char*) params, sizeof(params));
 		return true;
+	}
+
+	Statefile << Id_max << endl;
+	for (long Idg=0 ; Idg <= Id_max ; ++Idg) 
+	{
+		Statefile << grains[Idg].id <<	" " << grains[Idg].sphere.point() << " " << grains[Idg].sphere.weight() << " " << grains[Idg].translation << " " << grains[Idg].rotation << " "<<grains[Idg].isSphere << endl;
+	}
+	Statefile << Nc << endl;
+	for (long i=0 ; i < Nc ; ++i)
+	{			
+		Statefile << contacts[i]->grain1->id << " " << contacts[i]->grain2->id << " " << contacts[i]->normal << " " << contacts[i]->position << " " << contacts[i]->old_fn << " " << contacts[i]->old_fs << " " << contacts[i]->fn << " " << contacts[i]->fs << " " << contacts[i]->frictional_work << " " << contacts[i]->status << endl;
+	}
+
+	Statefile << "Eyn " << Eyn << " Eys " << Eys << " wszzh " << wszzh << " wsxxd " << wsxxd << " wsyyfa " << wsyyfa << " eps3 " << eps3 << " eps1 " << eps1 << " eps2 " << eps2 << " porom " << porom << " haut " << haut << " larg " << larg << " prof " << prof << " ratio_f " << ratio_f << " vit " << vit << endl;
+	return true;
 }
 
 } // namespace CGT
@@ -16,8 +16,8 @@
 #include<boost/iostreams/filtering_stream.hpp>
 
 /*! \class TriaxialState
- * \brief A storage class with ascii input/output for bodies, contacts, and macro-variables. Yade packings are first converted to this object type, before being processed in KinematicLocalisationAnalyser.
- * 
+ * \brief A storage class with ascii or binary input/output for bodies, contacts, and macro-variables. Yade packings are first converted to this object type, before being processed in KinematicLocalisationAnalyser.
+ * Binary files start with "YADETS01", followed by int64 Id_max, int64 number of contacts, the grain records, the contact records (see BinaryGrain and BinaryContact in TriaxialState.cpp) and the 14 macro-variables as float64. from_file() recognizes both formats; uncompressed files are memory-mapped and parsed in parallel.
  */
 
 namespace CGT {
@@ -70,13 +70,14 @@ public:
 	~TriaxialState(void);
 		
 	bool from_file(const char* filename, bool bz2=false);
-	bool to_file(const char* filename, bool bz2=false);
+	bool to_file(const char* filename, bool bz2=false, bool binary=false);
 	bool inside(Real x, Real y, Real z);
 	bool inside(CVector v);
 	bool inside(Point p);
 	static Real find_parameter (const char* parameter_name, const char* filename);
 	static Real find_parameter (const char* parameter_name, boost::iostreams::filtering_istream& file);
 	static Real find_parameter (const char* parameter_name, ifstream& file);
+	static Real find_parameter (const char* parameter_name, std::istream& file);
 	void reset (void);
 
 	GrainIterator grains_begin (void);
@@ -100,6 +101,9 @@ public:
 private :
 	Tesselation Tes;	
 	Tesselation& Tesselate (void);
+	bool parseText (const char* begin, const char* end);
+	bool parseBinary (const char* begin, const char* end);
+	void setBoxAndMeanRadius (void);
 
 	//Private member data :
 	bool tesselated;
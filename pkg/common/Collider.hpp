@@ -30,6 +30,10 @@ class Collider: public GlobalEngine {
 		Currently used from Shop::flipCell, which changes cell information for bodies.
 		*/
 		virtual void invalidatePersistentData(){}
+		/*! Update persistent data after bodies were renumbered (see Engine::renumberBodies).
+		The default implementation invalidates persistent data, colliders should override it if they can remap their data cheaply.
+		*/
+		virtual void renumberBodies(const std::vector<Body::id_t>& newIds){ invalidatePersistentData(); }
 
 		// ctor with functors for the integrated BoundDispatcher
 		virtual void pyHandleCustomCtorArgs(boost::python::tuple& t, boost::python::dict& d);
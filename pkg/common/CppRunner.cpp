@@ -0,0 +1,38 @@
+// 2026 © Yade developers
+#include<pkg/common/CppRunner.hpp>
+#include<core/Scene.hpp>
+#include<dlfcn.h>
+
+YADE_PLUGIN((CppRunner));
+CREATE_LOGGER(CppRunner);
+
+CppRunner::~CppRunner(){ unload(); }
+
+void CppRunner::unload(){
+	if(handle) dlclose(handle);
+	handle=NULL; callback=NULL;
+	loadedLibrary.clear(); loadedFunction.clear();
+}
+
+void CppRunner::load(){
+	unload();
+	if(library.empty()) throw std::runtime_error("CppRunner.library must be given.");
+	handle=dlopen(library.c_str(),RTLD_NOW|RTLD_LOCAL);
+	if(!handle) throw std::runtime_error("CppRunner: unable to load "+library+": "+dlerror());
+	dlerror(); // clear any previous error before dlsym
+	void* sym=dlsym(handle,function.c_str());
+	const char* err=dlerror();
+	if(err || !sym){
+		string msg="CppRunner: function "+function+" not found in "+library+(err?string(": ")+err:string());
+		unload();
+		throw std::runtime_error(msg);
+	}
+	callback=reinterpret_cast<Callback>(sym);
+	loadedLibrary=library; loadedFunction=function;
+	LOG_DEBUG("Loaded "<<function<<" from "<<library);
+}
+
+void CppRunner::action(){
+	if(!callback || library!=loadedLibrary || function!=loadedFunction) load();
+	callback(scene,this);
+}
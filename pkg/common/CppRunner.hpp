@@ -0,0 +1,29 @@
+// 2026 © Yade developers
+#pragma once
+#include<pkg/common/PeriodicEngines.hpp>
+
+class CppRunner: public PeriodicEngine {
+	public:
+		//! signature of the function called by the engine; the library must define it as extern "C"
+		typedef void (*Callback)(Scene* scene, CppRunner* runner);
+	private:
+		void* handle;
+		Callback callback;
+		string loadedLibrary, loadedFunction;
+		void load();
+	public :
+		/* virtual bool isActivated: not overridden, PeriodicEngine handles that */
+		virtual void action();
+		void unload();
+		virtual ~CppRunner();
+	DECLARE_LOGGER;
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(CppRunner,PeriodicEngine,
+		"Call a function from a user-compiled shared library periodically, with the same periodicity semantics as :yref:`PyRunner` (see :yref:`PeriodicEngine`), but without the python interpreter (no GIL, no parsing of the command). This is meant for control logic run very often (servo-control of walls, stop criteria, data logging). The function is declared as ``extern \"C\" void yadeCallback(Scene* scene, CppRunner* runner)``; it can read and write the whole scene and use :yref:`params<CppRunner.params>` to exchange values with python. The library is compiled against yade headers, e.g. ``g++ -shared -fPIC -std=c++0x -I/path/to/yade/source -I/usr/include/eigen3 $(python-config --includes) servo.cpp -o servo.so`` (use the same defines as yade itself, notably ``-DYADE_OPENMP`` if yade was built with OpenMP). See :ysrc:`examples/CppRunner` for an example.",
+		((string,library,"",,"Shared library to load (path as accepted by dlopen). The library is loaded on first use, or when this attribute changes."))
+		((string,function,"yadeCallback",,"Name of the function to call, it must have C linkage."))
+		((vector<Real>,params,,,"Values passed to and from the function, for use by the function only."))
+		,/*ctor*/ handle=NULL; callback=NULL;
+		,/*py*/ .def("unload",&CppRunner::unload,"Close the library, so that it is loaded again (e.g. after recompilation) at the next call.")
+	);
+};
+REGISTER_SERIALIZABLE(CppRunner);
@@ -518,7 +518,7 @@ bool Ig2_ChainedCylinder_ChainedCylinder_ScGeom6D::go(	const shared_ptr<Shape>&
 	else{	//contact between two Cylinders within the same chain.
 		shared_ptr<ScGeom6D> scm;
 		if(!isNew) scm=YADE_PTR_CAST<ScGeom6D>(c->geom);
-		else { scm=shared_ptr<ScGeom6D>(new ScGeom6D()); c->geom=scm; }
+		else { scm=pooledShared<ScGeom6D>(); c->geom=scm; }
 		Real length=(bchain2.pos-bchain1.pos).norm();
 		Vector3r segt =pChain2->pos-pChain1->pos;
 		if(isNew) {/*scm->normal=scm->prevNormal=segt/length;*/bs1->initLength=length;}
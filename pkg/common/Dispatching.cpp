@@ -15,6 +15,7 @@ CREATE_LOGGER(BoundDispatcher);
 void BoundDispatcher::action()
 {
 	updateScenePtr();
+	updateDispatchTable();
 	shared_ptr<BodyContainer>& bodies = scene->bodies;
 	const long numBodies=(long)bodies->size();
 	#ifdef YADE_OPENMP
@@ -34,6 +35,8 @@ void BoundDispatcher::processBody(const shared_ptr<Body>& b)
 // 	const shared_ptr<Body>& b=(*bodies)[id];
 		shared_ptr<Shape>& shape=b->shape;
 		if(!b->isBounded() || !shape) return;
+		// sleeping bodies don't move, their bound is still valid
+		if(b->isSleeping() && b->bound) return;
 		if(b->bound) {
 			Real& sweepLength = b->bound->sweepLength;
 			if (targetInterv>=0) {
@@ -46,12 +49,8 @@ void BoundDispatcher::processBody(const shared_ptr<Body>& b)
 				else sweepLength=0;
 			} else sweepLength=sweepDist;
 		} 
-		#ifdef BV_FUNCTOR_CACHE
-		if(!shape->boundFunctor){ shape->boundFunctor=this->getFunctor1D(shape); if(!shape->boundFunctor) return; }
-		shape->boundFunctor->go(shape,b->bound,b->state->se3,b.get());
-		#else
+		// constant-time lookup in the dispatch table, see BoundDispatcher::action
 		operator()(shape,b->bound,b->state->se3,b.get());
-		#endif
 		if(!b->bound) return; // the functor did not create new bound
 		b->bound->refPos=b->state->pos;
 		b->bound->lastUpdateIter=scene->iter;
@@ -103,6 +102,7 @@ shared_ptr<Interaction> IGeomDispatcher::explicitAction(const shared_ptr<Body>&
 
 void IGeomDispatcher::action(){
 	updateScenePtr();
+	updateDispatchTable();
 
 	shared_ptr<BodyContainer>& bodies = scene->bodies;
 	const bool isPeriodic(scene->isPeriodic);
@@ -158,6 +158,7 @@ void IPhysDispatcher::explicitAction(shared_ptr<Material>& pp1, shared_ptr<Mater
 void IPhysDispatcher::action()
 {
 	updateScenePtr();
+	updateDispatchTable();
 	shared_ptr<BodyContainer>& bodies = scene->bodies;
 	#ifdef YADE_OPENMP
 		const long size=scene->interactions->size();
@@ -186,6 +187,8 @@ void IPhysDispatcher::action()
 CREATE_LOGGER(LawDispatcher);
 void LawDispatcher::action(){
 	updateScenePtr();
+	updateDispatchTable();
+	FOREACH(const shared_ptr<LawFunctor>& f, functors) f->preStep();
 	#ifdef YADE_OPENMP
 		const long size=scene->interactions->size();
 		#pragma omp parallel for
@@ -14,9 +14,15 @@
 #include <boost/random/linear_congruential.hpp>
 #include <boost/random/normal_distribution.hpp>
 #include <boost/random/variate_generator.hpp>
+#ifdef YADE_OPENMP
+  #include<omp.h>
+#endif
 
 YADE_PLUGIN((ForceEngine)(InterpolatingDirectedForceEngine)(RadialForceEngine)(DragEngine)(LinearDragEngine)(HydroForceEngine));
 
+// value of a depth profile, zero outside of its range (profiles may not have been computed yet)
+static inline Real profileValue(const vector<Real>& profile, long i){ return (i>=0 && i<(long)profile.size()) ? profile[i] : 0.; }
+
 void ForceEngine::action(){
 	FOREACH(Body::id_t id, ids){
 		if (!(scene->bodies->exists(id))) continue;
@@ -131,7 +137,8 @@ void HydroForceEngine::action(){
 	}
 	
 	/* Application of hydrodynamical forces */
-	if (activateAverage==true) averageProfile(); //Calculate the average fluid and velocity profile
+	if (activateAverage==true || solveFluid) averageProfile(); //Calculate the average fluid and velocity profile
+	if (solveFluid) fluidStep(scene->dt);
 	
 	FOREACH(Body::id_t id, ids){
 		Body* b=Body::byId(id,scene).get();
@@ -166,89 +173,129 @@ void HydroForceEngine::action(){
 }
 
 void HydroForceEngine::averageProfile(){
-	//Initialization
-	int minZ;
-	int maxZ;
-	int numLayer;
-	Real deltaCenter;
-	Real zInf;
-	Real zSup;
-	Real volPart;
-	Vector3r uRel = Vector3r::Zero();
-	Vector3r fDrag  = Vector3r::Zero();
-
-	int nMax = 2*nCell;
-	vector<Real> velAverageX(nMax,0.0);
-        vector<Real> velAverageY(nMax,0.0);
-        vector<Real> velAverageZ(nMax,0.0);
-	vector<Real> phiAverage(nMax,0.0);
-	vector<Real> dragAverage(nMax,0.0);
+	const int nMax = 2*nCell;
+	// per-thread histograms of volume, volume-weighted velocities and drag, and drag density, 6 profiles of nMax cells each
+	enum { PHI=0, VX, VY, VZ, DRAG, DRAGDENS, NPROF };
+	#ifdef YADE_OPENMP
+	const int nThreads = omp_get_max_threads();
+	#else
+	const int nThreads = 1;
+	#endif
+	vector<vector<Real> > sums(nThreads, vector<Real>(NPROF*nMax,0.0));
+	const BodyContainer& bodies = *scene->bodies;
+	const long nBodies = bodies.size();
 
 	//Loop over the particles
-	FOREACH(const shared_ptr<Body>& b, *Omega::instance().getScene()->bodies){
-		shared_ptr<Sphere> s=YADE_PTR_DYN_CAST<Sphere>(b->shape); if(!s) continue;
+	#ifdef YADE_OPENMP
+	#pragma omp parallel for schedule(static)
+	#endif
+	for(long i=0; i<nBodies; i++){
+		const shared_ptr<Body>& b = bodies[i];
+		if(!b) continue;
+		const Sphere* s = dynamic_cast<Sphere*>(b->shape.get()); if(!s) continue;
+		#ifdef YADE_OPENMP
+		Real* h = &sums[omp_get_thread_num()][0];
+		#else
+		Real* h = &sums[0][0];
+		#endif
 		const Real zPos = b->state->pos[2]-zRef;
 		int Np = floor(zPos/deltaZ);	//Define the layer number with 0 corresponding to zRef. Let the z position wrt to zero, that way all z altitude are positive. (otherwise problem with volPart evaluation)
 
 		// Relative fluid/particle velocity using also the associated fluid vel. fluct. 
+		Vector3r fDrag = Vector3r::Zero();
 		if ((Np>=0)&&(Np<nCell)){
-			uRel = Vector3r(vxFluid[Np]+vFluctX[b->id], 0.0,vFluctZ[b->id]) - b->state->vel;
+			Vector3r uRel = Vector3r(profileValue(vxFluid,Np)+profileValue(vFluctX,b->id), 0.0,profileValue(vFluctZ,b->id)) - b->state->vel;
 			// Drag force with a Dallavalle formulation (drag coef.) and Richardson-Zaki Correction (hindrance effect)
-			fDrag = 0.5*Mathr::PI*pow(s->radius,2.0)*densFluid*(0.44*uRel.norm()+24.4*viscoDyn/(densFluid*2.0*s->radius))*pow((1-phiPart[Np]),-expoRZ)*uRel;
+			fDrag = 0.5*Mathr::PI*pow(s->radius,2.0)*densFluid*(0.44*uRel.norm()+24.4*viscoDyn/(densFluid*2.0*s->radius))*pow((1-profileValue(phiPart,Np)),-expoRZ)*uRel;
 		}
-		else fDrag = Vector3r::Zero();
-
-		minZ= floor((zPos-s->radius)/deltaZ);
-		maxZ= floor((zPos+s->radius)/deltaZ);
-		deltaCenter = zPos - Np*deltaZ;
+		const Real volSphere = 4.0/3.0*Mathr::PI*pow(s->radius,3);
+		int minZ = floor((zPos-s->radius)/deltaZ);
+		int maxZ = floor((zPos+s->radius)/deltaZ);
+		Real deltaCenter = zPos - Np*deltaZ;
 	
 		// Loop over the cell in which the particle is contained
-		numLayer = minZ;
-		while (numLayer<=maxZ){
-			if ((numLayer>=0)&&(numLayer<nMax)){ //average under zRef does not interest us, avoid also negative values not compatible with the evaluation of volPart
-				zInf=(numLayer-Np-1)*deltaZ + deltaCenter;
-				zSup=(numLayer-Np)*deltaZ + deltaCenter;
-				if (zInf<-s->radius) zInf = -s->radius;
-				if (zSup>s->radius) zSup = s->radius;
-
-				//Analytical formulation of the volume of a slice of sphere
-				volPart = Mathr::PI*pow(s->radius,2)*(zSup - zInf +(pow(zInf,3)-pow(zSup,3))/(3*pow(s->radius,2)));
-
-				phiAverage[numLayer]+=volPart;
-				velAverageX[numLayer]+=volPart*b->state->vel[0];
-                                velAverageY[numLayer]+=volPart*b->state->vel[1];
-                                velAverageZ[numLayer]+=volPart*b->state->vel[2];
-				dragAverage[numLayer]+=volPart*fDrag[0];
-			}
-			numLayer+=1;
+		for(int numLayer=max(minZ,0); numLayer<=min(maxZ,nMax-1); numLayer++){ //average under zRef does not interest us, avoid also negative values not compatible with the evaluation of volPart
+			Real zInf=(numLayer-Np-1)*deltaZ + deltaCenter;
+			Real zSup=(numLayer-Np)*deltaZ + deltaCenter;
+			if (zInf<-s->radius) zInf = -s->radius;
+			if (zSup>s->radius) zSup = s->radius;
+
+			//Analytical formulation of the volume of a slice of sphere
+			Real volPart = Mathr::PI*pow(s->radius,2)*(zSup - zInf +(pow(zInf,3)-pow(zSup,3))/(3*pow(s->radius,2)));
+
+			h[PHI*nMax+numLayer]+=volPart;
+			h[VX*nMax+numLayer]+=volPart*b->state->vel[0];
+			h[VY*nMax+numLayer]+=volPart*b->state->vel[1];
+			h[VZ*nMax+numLayer]+=volPart*b->state->vel[2];
+			h[DRAG*nMax+numLayer]+=volPart*fDrag[0];
+			h[DRAGDENS*nMax+numLayer]+=volPart/volSphere*fDrag[0];
 		}
 	}
+	for(int t=1; t<nThreads; t++) for(int k=0; k<NPROF*nMax; k++) sums[0][k]+=sums[t][k];
+	const Real* h = &sums[0][0];
+
 	//Normalized the weighted velocity by the volume of particles contained inside the cell
+	phiPart.assign(nMax,0.0); vxPart.assign(nMax,0.0); vyPart.assign(nMax,0.0); vzPart.assign(nMax,0.0);
+	averageDrag.assign(nMax,0.0); dragDensity.assign(nMax,0.0);
 	for(int n=0;n<nMax;n++){
-		if (phiAverage[n]!=0){
-			velAverageX[n]/=phiAverage[n];
-                        velAverageY[n]/=phiAverage[n];
-                        velAverageZ[n]/=phiAverage[n];
-			dragAverage[n]/=phiAverage[n];
-			//Normalize the concentration after
-			phiAverage[n]/=vCell;
-		}
-		else {
-			velAverageX[n] = 0.0;
-                        velAverageY[n] = 0.0;
-                        velAverageZ[n] = 0.0;
-			dragAverage[n] = 0.0;
-		}
+		dragDensity[n] = h[DRAGDENS*nMax+n]/vCell;
+		const Real vol = h[PHI*nMax+n];
+		if (vol==0) continue;
+		vxPart[n] = h[VX*nMax+n]/vol;
+		vyPart[n] = h[VY*nMax+n]/vol;
+		vzPart[n] = h[VZ*nMax+n]/vol;
+		averageDrag[n] = h[DRAG*nMax+n]/vol;
+		//Normalize the concentration after
+		phiPart[n] = vol/vCell;
 	}
-	//Assign the results to the global/public variables of HydroForceEngine
-	phiPart = phiAverage;
-	vxPart = velAverageX;
-	vyPart = velAverageY;
-        vzPart = velAverageZ;
-	averageDrag = dragAverage;
 
 	//desactivate the average to avoid calculating at each step, only when asked by the user
 	activateAverage=false; 
 }
 
+void HydroForceEngine::fluidStep(Real dt){
+	const int n = nCell;
+	if ((int)vxFluid.size()<n) vxFluid.resize(n,0.0);
+	const Real dz2 = deltaZ*deltaZ;
+	// solid fraction in the cells, bounded so that the fluid fraction never vanishes
+	vector<Real> phi(n);
+	for(int j=0; j<n; j++) phi[j] = min(profileValue(phiPart,j),phiMax);
+	// mixing length and dynamic viscosity (times fluid fraction) at the cell interfaces, interface j is the bottom of cell j, interface 0 is the wall at zRef
+	vector<Real> visco(n+1,0.0);
+	turbViscosity.assign(n+1,0.0);
+	Real lm = 0;
+	for(int k=1; k<n; k++){
+		lm += kappa*deltaZ*(phiMax-phi[k-1])/phiMax;
+		turbViscosity[k] = lm*lm*std::abs(vxFluid[k]-vxFluid[k-1])/deltaZ;
+		visco[k] = (1-0.5*(phi[k]+phi[k-1]))*(viscoDyn+densFluid*turbViscosity[k]);
+	}
+	visco[0] = 2*(1-phi[0])*viscoDyn; // half-cell distance to the wall
+	visco[n] = 0; // no shear stress at the free surface
+	// tridiagonal system, drag linearized as beta*(u-vxPart) with beta from the current velocities
+	vector<Real> a(n), b(n), c(n), d(n);
+	for(int j=0; j<n; j++){
+		const Real eps = 1-phi[j];
+		const Real vPart = profileValue(vxPart,j);
+		const Real uRel = vxFluid[j]-vPart;
+		const Real beta = (std::abs(uRel)>1e-12) ? max((Real)0,(Real)(profileValue(dragDensity,j)/uRel)) : (Real)0;
+		a[j] = -dt*visco[j]/dz2*(j>0);
+		c[j] = -dt*visco[j+1]/dz2;
+		b[j] = densFluid*eps + dt*(visco[j]+visco[j+1])/dz2 + dt*beta;
+		d[j] = densFluid*eps*(vxFluid[j]+dt*gravity[0]) + dt*beta*vPart;
+	}
+	// Thomas algorithm
+	for(int j=1; j<n; j++){
+		const Real m = a[j]/b[j-1];
+		b[j] -= m*c[j-1];
+		d[j] -= m*d[j-1];
+	}
+	vxFluid[n-1] = d[n-1]/b[n-1];
+	for(int j=n-2; j>=0; j--) vxFluid[j] = (d[j]-c[j]*vxFluid[j+1])/b[j];
+}
+
+void HydroForceEngine::fluidResolution(Real tfin, Real dtFluid){
+	if (dtFluid<=0) throw std::invalid_argument("HydroForceEngine.fluidResolution: dtFluid must be positive.");
+	for(Real t=0; t<tfin; t+=dtFluid) fluidStep(min(dtFluid,tfin-t));
+}
+
 
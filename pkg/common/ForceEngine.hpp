@@ -72,10 +72,12 @@ REGISTER_SERIALIZABLE(LinearDragEngine);
 
 class HydroForceEngine: public PartialEngine{
 	private:
-		void averageProfile();
+		void fluidStep(Real dt);
 	public:
 		virtual void action();
-	YADE_CLASS_BASE_DOC_ATTRS(HydroForceEngine,PartialEngine,"Apply drag and lift due to a fluid flow vector (1D) to each sphere + the buoyant weight.\n The applied drag force reads\n\n. math:: F_{d}=\\frac{1}{2} C_d A\\rho^f|\\vec{v_f - v}| vec{v_f - v} \n\n where $\\rho$ is the medium density (:yref:`density<HydroForceEngine.densFluid>`), $v$ is particle's velocity,  $v_f$ is the velocity of the fluid at the particle center,  $A$ is particle projected area (disc), $C_d$ is the drag coefficient. The formulation of the drag coefficient depends on the local particle reynolds number and the solid volume fraction. The formulation of the drag is [Dallavalle1948]_ [RevilBaudard2013]_ with a correction of Richardson-Zaki [Richardson1954]_ to take into account the hindrance effect. This law is classical in sediment transport. It is possible to activate a fluctuation of the drag force for each particle which account for the turbulent fluctuation of the fluid velocity (:yref:`velFluct`). The model implemented for the turbulent velocity fluctuation is a simple discrete random walk which takes as input the reynolds stress tensor Re_{xz} in function of the depth and allows to recover the main property of the fluctuations by imposing <u_x'u_z'> (z) = <Re>(z)/rho^f. It requires as input <Re>(z)/rho^f called :yref:`simplifiedReynoldStresses` in the code. \n The formulation of the lift is taken from [Wiberg1985]_ and is such that : \n\n.. math:: F_{L}=\\frac{1}{2} C_L A\\rho^f((v_f - v)^2{top} - (v_f - v)^2{bottom}) \n\n Where the subscript top and bottom means evaluated at the top (respectively the bottom) of the sphere considered. This formulation of the lift account for the difference of pressure at the top and the bottom of the particle inside a turbulent shear flow. As this formulation is controversial when approaching the threshold of motion [Schmeeckle2007]_ it is possible to desactivate it with the variable :yref:`lift`.\n The buoyancy is taken into account through the buoyant weight : \n\n.. math:: F_{buoyancy}= - rho^f V^p g \n\n, where g is the gravity vector along the vertical, and V^p is the volume of the particle. This engine also evaluate the average particle velocity, solid volume fraction and drag force depth profiles. This is done as the solid volume fraction depth profile is required for the drag calculation, and as the three are required for the independent fluid resolution, and C++ code is faster than python.",
+		void averageProfile();
+		void fluidResolution(Real tfin, Real dtFluid);
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(HydroForceEngine,PartialEngine,"Apply drag and lift due to a fluid flow vector (1D) to each sphere + the buoyant weight.\n The applied drag force reads\n\n. math:: F_{d}=\\frac{1}{2} C_d A\\rho^f|\\vec{v_f - v}| vec{v_f - v} \n\n where $\\rho$ is the medium density (:yref:`density<HydroForceEngine.densFluid>`), $v$ is particle's velocity,  $v_f$ is the velocity of the fluid at the particle center,  $A$ is particle projected area (disc), $C_d$ is the drag coefficient. The formulation of the drag coefficient depends on the local particle reynolds number and the solid volume fraction. The formulation of the drag is [Dallavalle1948]_ [RevilBaudard2013]_ with a correction of Richardson-Zaki [Richardson1954]_ to take into account the hindrance effect. This law is classical in sediment transport. It is possible to activate a fluctuation of the drag force for each particle which account for the turbulent fluctuation of the fluid velocity (:yref:`velFluct`). The model implemented for the turbulent velocity fluctuation is a simple discrete random walk which takes as input the reynolds stress tensor Re_{xz} in function of the depth and allows to recover the main property of the fluctuations by imposing <u_x'u_z'> (z) = <Re>(z)/rho^f. It requires as input <Re>(z)/rho^f called :yref:`simplifiedReynoldStresses` in the code. \n The formulation of the lift is taken from [Wiberg1985]_ and is such that : \n\n.. math:: F_{L}=\\frac{1}{2} C_L A\\rho^f((v_f - v)^2{top} - (v_f - v)^2{bottom}) \n\n Where the subscript top and bottom means evaluated at the top (respectively the bottom) of the sphere considered. This formulation of the lift account for the difference of pressure at the top and the bottom of the particle inside a turbulent shear flow. As this formulation is controversial when approaching the threshold of motion [Schmeeckle2007]_ it is possible to desactivate it with the variable :yref:`lift`.\n The buoyancy is taken into account through the buoyant weight : \n\n.. math:: F_{buoyancy}= - rho^f V^p g \n\n, where g is the gravity vector along the vertical, and V^p is the volume of the particle. This engine also evaluate the average particle velocity, solid volume fraction and drag force depth profiles. This is done as the solid volume fraction depth profile is required for the drag calculation, and as the three are required for the independent fluid resolution, and C++ code is faster than python.",
 		((Real,densFluid,1000,,"Density of the fluid, by default - density of water"))
 		((Real,viscoDyn,1e-3,,"Dynamic viscosity of the fluid, by default - viscosity of water"))
 		((Real,zRef,,,"Position of the reference point which correspond to the first value of the fluid velocity"))
@@ -98,6 +100,15 @@ class HydroForceEngine: public PartialEngine{
 		((vector<Real>,vFluctZ,,,"Vector associating a Z fluid velocity fluctuation to each particle. Fluctuation calculated in the C++ code"))
 		((vector<Real>,simplifiedReynoldStresses,,,"Vector of size equal to :yref:`turbStress<HydroForceEngine.nCell>` containing the Reynolds stresses divided by the fluid density in function of the depth. simplifiedReynoldStresses(z) =  <u_x'u_z'>(z)^2 "))
 		((Real,bedElevation,,,"Elevation of the bed above which the fluid flow is turbulent and the particles undergo turbulent velocity fluctuation."))
+		((vector<Real>,dragDensity,,,"Discretized streamwise drag force per unit volume exerted by the fluid on the particles, evaluated with the average profiles; it is the coupling term of the fluid resolution."))
+		((bool,solveFluid,false,,"If true, the average profiles and the fluid velocity profile :yref:`vxFluid<HydroForceEngine.vxFluid>` are updated at every step (one implicit step of size O.dt, see :yref:`fluidResolution<HydroForceEngine.fluidResolution>`), so that the coupling does not need python."))
+		((Real,kappa,0.41,,"Von Karman constant of the mixing length model."))
+		((Real,phiMax,0.61,,"Maximum solid volume fraction; the mixing length grows as $\\kappa (\\phi_{max}-\\phi)/\\phi_{max}$ with the height [LiSawamoto1995]_, so that it vanishes inside the bed."))
+		((vector<Real>,turbViscosity,,Attr::readonly,"Eddy viscosity (kinematic) at the cell interfaces, from the last fluid resolution."))
+		,/*ctor*/
+		,/*py*/
+		.def("averageProfile",&HydroForceEngine::averageProfile,"Compute the average depth profiles of solid volume fraction, solid velocity and drag now.")
+		.def("fluidResolution",&HydroForceEngine::fluidResolution,(boost::python::arg("tfin"),boost::python::arg("dtFluid")),"Advance the streamwise fluid velocity profile :yref:`vxFluid<HydroForceEngine.vxFluid>` by *tfin*, with time steps *dtFluid*, using the current solid profiles (:yref:`phiPart<HydroForceEngine.phiPart>`, :yref:`vxPart<HydroForceEngine.vxPart>`, :yref:`dragDensity<HydroForceEngine.dragDensity>`). The 1D momentum balance of the fluid phase\n\n.. math:: \\rho^f (1-\\phi) \\frac{\\partial u}{\\partial t} = \\frac{\\partial}{\\partial z}\\left((1-\\phi)(\\eta + \\rho^f l_m^2 |\\frac{\\partial u}{\\partial z}|) \\frac{\\partial u}{\\partial z}\\right) + \\rho^f (1-\\phi) g_x - f_D\n\nis solved with an implicit scheme (tridiagonal system, the eddy viscosity and the drag coefficient are lagged), with no slip at zRef and no shear stress at the free surface zRef+nCell*deltaZ.")
 	);
 };
 REGISTER_SERIALIZABLE(HydroForceEngine);
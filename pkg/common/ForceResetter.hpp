@@ -8,9 +8,12 @@ class ForceResetter: public GlobalEngine{
 	public:
 		virtual void action() {
 			scene->forces.reset(scene->iter);
-			if(scene->trackEnergy) scene->energy->resetResettables();
+			if(scene->trackEnergy){
+				if(scene->energy->resettablesDue(scene->iter)) scene->energy->resetResettables();
+				else scene->energy->skipResettables=true;
+			}
 		}
-	YADE_CLASS_BASE_DOC(ForceResetter,GlobalEngine,"Reset all forces stored in Scene::forces (``O.forces`` in python). Typically, this is the first engine to be run at every step. In addition, reset those energies that should be reset, if energy tracing is enabled.");
+	YADE_CLASS_BASE_DOC(ForceResetter,GlobalEngine,"Reset all forces stored in Scene::forces (``O.forces`` in python). Typically, this is the first engine to be run at every step. In addition, reset those energies that should be reset, if energy tracing is enabled (only every :yref:`EnergyTracker.interval` steps).");
 };
 REGISTER_SERIALIZABLE(ForceResetter);
 
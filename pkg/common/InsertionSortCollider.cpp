@@ -537,6 +537,28 @@ bool InsertionSortCollider::spatialOverlapPeri(Body::id_t id1, Body::id_t id2,Sc
 	return true;
 }
 
+void InsertionSortCollider::renumberBodies(const std::vector<Body::id_t>& newIds){
+	for(int i=0; i<3; i++){
+		std::vector<Bounds>& vec=BB[i].vec;
+		size_t j=0; long loIdx=0;
+		for(size_t k=0; k<vec.size(); k++){
+			if((long)k==BB[i].loIdx) loIdx=j;
+			if(vec[k].id>=(Body::id_t)newIds.size() || newIds[vec[k].id]<0) continue;
+			vec[j]=vec[k]; vec[j].id=newIds[vec[k].id]; j++;
+		}
+		vec.erase(vec.begin()+j,vec.end());
+		BB[i].size=vec.size();
+		// keep the wrap position of the periodic container where it was
+		BB[i].loIdx=(loIdx<(long)j ? loIdx : 0);
+	}
+	// every slot of the new container must have its bounds, otherwise the next step would append duplicates
+	const long nNew=(newIds.empty() ? 0 : *std::max_element(newIds.begin(),newIds.end())+1);
+	for(int i=0; i<3; i++){
+		if(BB[i].size!=2*nNew){ LOG_WARN("Bounds do not match renumbered bodies, collider will be reinitialized."); invalidatePersistentData(); break; }
+	}
+	// minima and maxima are refreshed from bounds at every step
+}
+
 boost::python::tuple InsertionSortCollider::dumpBounds(){
   boost::python::list bl[3]; // 3 bound lists, inserted into the tuple at the end
 	for(int axis=0; axis<3; axis++){
@@ -184,6 +184,8 @@ class InsertionSortCollider: public Collider{
 
 	// force reinitialization at next run
 	virtual void invalidatePersistentData(){ for(int i=0; i<3; i++){ BB[i].vec.clear(); BB[i].size=0; }}
+	// remap ids of bounds in place, keeping them sorted so that no initial sort is needed
+	virtual void renumberBodies(const std::vector<Body::id_t>& newIds);
 
 	vector<Body::id_t> probeBoundingVolume(const Bound&);
 
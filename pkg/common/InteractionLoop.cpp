@@ -1,8 +1,44 @@
 #include"InteractionLoop.hpp"
+#include<pkg/common/NormShearPhys.hpp>
+#include<pkg/dem/DemXDofGeom.hpp>
+#include<pkg/dem/ScGeom.hpp>
+#include<pkg/dem/ViscoelasticPM.hpp>
 
 YADE_PLUGIN((InteractionLoop));
 CREATE_LOGGER(InteractionLoop);
 
+namespace{
+	/* applyHeldForce only repeats the contact force, hence interactions whose law adds contact moments must be evaluated at every step:
+	ScGeom6D is the geometry of such laws (CohFrictPhys, InelastCohFrictPhys, MindlinPhys with moments), ViscElPhys adds rolling resistance if mR>0 */
+	bool carriesMoment(const Interaction* I){
+		if(dynamic_cast<ScGeom6D*>(I->geom.get())) return true;
+		const ViscElPhys* ve=dynamic_cast<ViscElPhys*>(I->phys.get());
+		return ve && ve->mR>0;
+	}
+	// restores scene->dt scaled by multi-rate passes, also if a functor throws
+	struct DtRestorer{
+		Scene* scene; const Real dt0;
+		DtRestorer(Scene* s): scene(s), dt0(s->dt){}
+		~DtRestorer(){ scene->dt=dt0; }
+	};
+}
+
+int InteractionLoop::interactionLevel(const Interaction* I, const Body* b1, const Body* b2) const {
+	if(!I->isReal() || !dynamic_cast<GenericSpheresContact*>(I->geom.get()) || !dynamic_cast<NormShearPhys*>(I->phys.get()) || carriesMoment(I)) return 0;
+	const Body::id_t id1=(b1->isClumpMember()?b1->clumpId:b1->id), id2=(b2->isClumpMember()?b2->clumpId:b2->id);
+	const int l1=((size_t)id1<levels.size()?levels[id1]:0), l2=((size_t)id2<levels.size()?levels[id2]:0);
+	return max(0,min(l1,l2));
+}
+
+void InteractionLoop::applyHeldForce(const Interaction* I, const Body* b1, const Body* b2, const Matrix3r& cellHsize){
+	const Vector3r& contactPoint=static_cast<GenericSpheresContact*>(I->geom.get())->contactPoint;
+	const NormShearPhys* phys=static_cast<NormShearPhys*>(I->phys.get());
+	const Vector3r force=-phys->normalForce-phys->shearForce;
+	const Vector3r pos2=(scene->isPeriodic ? Vector3r(b2->state->pos+cellHsize*I->cellDist.cast<Real>()) : b2->state->pos);
+	scene->forces.addForce(b1->id,force); scene->forces.addTorque(b1->id,(contactPoint-b1->state->pos).cross(force));
+	scene->forces.addForce(b2->id,-force); scene->forces.addTorque(b2->id,-(contactPoint-pos2).cross(force));
+}
+
 void InteractionLoop::pyHandleCustomCtorArgs(boost::python::tuple& t, boost::python::dict& d){
 	if(boost::python::len(t)==0) return; // nothing to do
 	if(boost::python::len(t)!=3) throw invalid_argument("Exactly 3 lists of functors must be given");
@@ -20,11 +56,20 @@ void InteractionLoop::pyHandleCustomCtorArgs(boost::python::tuple& t, boost::pyt
 }
 
 
+void InteractionLoop::renumberBodies(const std::vector<Body::id_t>& newIds){
+	if(levels.empty()) return;
+	vector<int> remapped(*std::max_element(newIds.begin(),newIds.end())+1,0);
+	for(size_t id=0; id<newIds.size() && id<levels.size(); id++) if(newIds[id]>=0) remapped[newIds[id]]=levels[id];
+	levels.swap(remapped);
+}
+
 void InteractionLoop::action(){
 	// update Scene* of the dispatchers
 	geomDispatcher->scene=physDispatcher->scene=lawDispatcher->scene=scene;
 	// ask dispatchers to update Scene* of their functors
 	geomDispatcher->updateScenePtr(); physDispatcher->updateScenePtr(); lawDispatcher->updateScenePtr();
+	// resolve dispatch for all type combinations before the parallel loop (only if functors or class indices changed)
+	geomDispatcher->updateDispatchTable(); physDispatcher->updateDispatchTable(); lawDispatcher->updateDispatchTable();
 
 	// call Ig2Functor::preStep
 	FOREACH(const shared_ptr<IGeomFunctor>& ig2, geomDispatcher->functors) ig2->preStep();
@@ -47,10 +92,26 @@ void InteractionLoop::action(){
 	// cache transformed cell size
 	Matrix3r cellHsize; if(scene->isPeriodic) cellHsize=scene->cell->hSize;
 
+	// deterministic mode: traverse interactions in the order of ids, whichever thread inserted them (in the collider or elsewhere)
+	// forces are tagged with ids of the interaction and summed in that order by ForceContainer::sync
+	const bool deterministic=scene->deterministic;
+	if(deterministic) scene->interactions->sortByIds();
+
 	// force removal of interactions that were not encountered by the collider
 	// (only for some kinds of colliders; see comment for InteractionContainer::iterColliderLastRun)
 	bool removeUnseenIntrs=(scene->interactions->iterColliderLastRun>=0 && scene->interactions->iterColliderLastRun==scene->iter);
 
+	// multi-rate: pass p evaluates interactions of level p, if due in this step (see InteractionLoop::levels)
+	const bool multiRate=!levels.empty();
+	int maxPass=0;
+	if(multiRate){
+		const int maxLevel=*std::max_element(levels.begin(),levels.end());
+		while(maxPass<maxLevel && maxPass<30 && scene->iter%(1L<<(maxPass+1))==0) maxPass++;
+	}
+	const DtRestorer dtRestorer(scene); const Real dt0=dtRestorer.dt0;
+	for(int pass=0; pass<=maxPass; pass++){
+	scene->dt=dt0*(1L<<pass);
+
 	#ifdef YADE_OPENMP
 	const long size=scene->interactions->size();
 	#pragma omp parallel for schedule(guided) num_threads(ompThreads>0 ? min(ompThreads,omp_get_max_threads()) : omp_get_max_threads())
@@ -61,18 +122,28 @@ void InteractionLoop::action(){
 	#endif
 		// keep the following newline, my (edx) preprocessor outputs garbage code otherwise!
 
-		if(removeUnseenIntrs && !I->isReal() && I->iterLastSeen<scene->iter) {
+		if(pass==0 && removeUnseenIntrs && !I->isReal() && I->iterLastSeen<scene->iter) {
 			eraseAfterLoop(I->getId1(),I->getId2());
 			continue;
 		}
 
 		const shared_ptr<Body>& b1_=Body::byId(I->getId1(),scene);
 		const shared_ptr<Body>& b2_=Body::byId(I->getId2(),scene);
+		if(deterministic) scene->forces.setOrderKey(I->getId1(),I->getId2());
 
 		if(!b1_ || !b2_){ LOG_DEBUG("Body #"<<(b1_?I->getId2():I->getId1())<<" vanished, erasing intr #"<<I->getId1()<<"+#"<<I->getId2()<<"!"); scene->interactions->requestErase(I); continue; }
     
     // Skip interaction with clumps
     if (b1_->isClump() || b2_->isClump()) { continue; }
+		// both bodies frozen by SleepingEngine, the interaction cannot change
+		if(skipSleeping && b1_->isSleeping() && b2_->isSleeping()) continue;
+		if(multiRate){
+			const int level=interactionLevel(I.get(),b1_.get(),b2_.get());
+			// interactions made real in this step were evaluated in the first pass already
+			if(pass>0){ if(level!=pass || I->iterMadeReal==scene->iter) continue; }
+			else if(level>maxPass){ applyHeldForce(I.get(),b1_.get(),b2_.get(),cellHsize); continue; }
+			else if(level>0) continue;
+		}
 		// we know there is no geometry functor already, take the short path
 		if(!I->functorCache.geomExists) { assert(!I->isReal()); continue; }
 		// no interaction geometry for either of bodies; no interaction possible
@@ -146,4 +217,6 @@ void InteractionLoop::action(){
 			if(callbackPtrs[i]!=NULL) (*(callbackPtrs[i]))(callbacks[i].get(),I.get());
 		}
 	}
+	}
+	if(deterministic) scene->forces.clearOrderKeys();
 }
@@ -23,15 +23,21 @@ class InteractionLoop: public GlobalEngine {
 		list<idPair> eraseAfterLoopIds;
 		void eraseAfterLoop(Body::id_t id1,Body::id_t id2){ eraseAfterLoopIds.push_back(idPair(id1,id2)); }
 	#endif
+	// multi-rate mode: level of interaction (0 for those which cannot be held), and re-application of the last force
+	int interactionLevel(const Interaction*, const Body*, const Body*) const;
+	void applyHeldForce(const Interaction*, const Body*, const Body*, const Matrix3r& cellHsize);
 	public:
 		virtual void pyHandleCustomCtorArgs(boost::python::tuple& t, boost::python::dict& d);
 		virtual void action();
+		virtual void renumberBodies(const std::vector<Body::id_t>& newIds);
 		YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(InteractionLoop,GlobalEngine,"Unified dispatcher for handling interaction loop at every step, for parallel performance reasons.\n\n.. admonition:: Special constructor\n\n\tConstructs from 3 lists of :yref:`Ig2<IGeomFunctor>`, :yref:`Ip2<IPhysFunctor>`, :yref:`Law<LawFunctor>` functors respectively; they will be passed to interal dispatchers, which you might retrieve.",
 			((shared_ptr<IGeomDispatcher>,geomDispatcher,new IGeomDispatcher,Attr::readonly,":yref:`IGeomDispatcher` object that is used for dispatch."))
 			((shared_ptr<IPhysDispatcher>,physDispatcher,new IPhysDispatcher,Attr::readonly,":yref:`IPhysDispatcher` object used for dispatch."))
 			((shared_ptr<LawDispatcher>,lawDispatcher,new LawDispatcher,Attr::readonly,":yref:`LawDispatcher` object used for dispatch."))
 			((vector<shared_ptr<IntrCallback> >,callbacks,,,":yref:`Callbacks<IntrCallback>` which will be called for every :yref:`Interaction`, if activated."))
 			((bool, eraseIntsInLoop, false,,"Defines if the interaction loop should erase pending interactions, else the collider takes care of that alone (depends on what collider is used)."))
+			((bool, skipSleeping, true,,"Skip interactions between two :yref:`sleeping<Body.sleeping>` bodies, see :yref:`SleepingEngine` (which sets this flag according to :yref:`SleepingEngine.exact`)."))
+			((vector<int>, levels,,,"Time step levels of bodies (indexed by id) for multi-rate integration, usually set by :yref:`MultiRateTimeStepper`; empty (the default) disables it. Real interactions with :yref:`GenericSpheresContact` geometry and :yref:`NormShearPhys` physics get the lower level *c* of their bodies, unless they carry contact moments (:yref:`ScGeom6D` geometry, or :yref:`ViscElPhys` with rolling resistance); they are evaluated every :math:`2^c` steps, with :yref:`O.dt<Omega.dt>` multiplied by :math:`2^c`, and their last force is applied again in the steps between. Other interactions are evaluated at every step. Bodies missing from the list have level 0."))
 			,
 			/*ctor*/ alreadyWarnedNoCollider=false;
 				#ifdef YADE_OPENMP
@@ -27,6 +27,12 @@ void ParallelEngine::action(){
 	}
 }
 
+void ParallelEngine::renumberBodies(const std::vector<int>& newIds){
+	FOREACH(const vector<shared_ptr<Engine> >& group, slaves){
+		FOREACH(const shared_ptr<Engine>& e, group) e->renumberBodies(newIds);
+	}
+}
+
 void ParallelEngine::slaves_set(const boost::python::list& slaves2){
 	int len=boost::python::len(slaves2);
 	slaves.clear();
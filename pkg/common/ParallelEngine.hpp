@@ -9,6 +9,7 @@ class ParallelEngine: public Engine {
 		typedef vector<vector<shared_ptr<Engine> > > slaveContainer;
 		virtual void action();
 		virtual bool isActivated(){return true;}
+		virtual void renumberBodies(const std::vector<int>& newIds);
 	// py access
 		boost::python::list slaves_get();
 		void slaves_set(const boost::python::list& slaves);
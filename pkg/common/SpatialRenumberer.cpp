@@ -0,0 +1,82 @@
+// 2026 © Yade developers
+#include<pkg/common/SpatialRenumberer.hpp>
+#include<core/Clump.hpp>
+#include<core/Scene.hpp>
+
+YADE_PLUGIN((SpatialRenumberer));
+CREATE_LOGGER(SpatialRenumberer);
+
+unsigned long long SpatialRenumberer::spreadBits(unsigned long long x){
+	x&=0x1fffffULL;
+	x=(x|x<<32)&0x1f00000000ffffULL;
+	x=(x|x<<16)&0x1f0000ff0000ffULL;
+	x=(x|x<<8) &0x100f00f00f00f00fULL;
+	x=(x|x<<4) &0x10c30c30c30c30c3ULL;
+	x=(x|x<<2) &0x1249249249249249ULL;
+	return x;
+}
+
+unsigned long long SpatialRenumberer::mortonKey(const Vector3r& p, const Vector3r& lo, const Vector3r& scale){
+	const Real maxCell=(1<<21)-1;
+	unsigned long long c[3];
+	for(int i=0; i<3; i++) c[i]=(unsigned long long)max((Real)0.,min(maxCell,(p[i]-lo[i])*scale[i]));
+	return spreadBits(c[0])|(spreadBits(c[1])<<1)|(spreadBits(c[2])<<2);
+}
+
+void SpatialRenumberer::pyRenumber(){
+	scene=Omega::instance().getScene().get();
+	action();
+}
+
+void SpatialRenumberer::action(){
+	const shared_ptr<BodyContainer>& bodies=scene->bodies;
+	const long nBodies=bodies->size();
+	newIds.assign(nBodies,-1);
+	// points to sort: non-clump bodies at or above firstId
+	vector<Body::id_t> sortIds; vector<Vector3r> pts;
+	// number of members of each clump which are sorted; the clump follows the last of them
+	std::map<Body::id_t,int> pendingMembers;
+	vector<Body::id_t> clumps;
+	for(Body::id_t id=0; id<nBodies; id++){
+		const shared_ptr<Body>& b=(*bodies)[id];
+		// slots below firstId are kept even if empty
+		if(id<firstId){ newIds[id]=id; continue; }
+		if(!b) continue;
+		if(b->isClump()){ clumps.push_back(id); continue; }
+		if(b->isClumpMember() && b->clumpId>=firstId) pendingMembers[b->clumpId]++;
+		Vector3r p=(b->bound ? Vector3r(.5*(b->bound->min+b->bound->max)) : b->state->pos);
+		if(scene->isPeriodic) p=scene->cell->wrapShearedPt(p);
+		sortIds.push_back(id); pts.push_back(p);
+	}
+	const long nPts=sortIds.size();
+	if(nPts>0){
+		Vector3r lo=pts[0], hi=pts[0];
+		for(long i=1; i<nPts; i++){ lo=lo.cwiseMin(pts[i]); hi=hi.cwiseMax(pts[i]); }
+		Vector3r scale;
+		for(int i=0; i<3; i++) scale[i]=(hi[i]>lo[i] ? ((1<<21)-1)/(hi[i]-lo[i]) : 0.);
+		vector<std::pair<unsigned long long,Body::id_t> > keys(nPts);
+		#ifdef YADE_OPENMP
+		#pragma omp parallel for schedule(static)
+		#endif
+		for(long i=0; i<nPts; i++) keys[i]=std::make_pair(mortonKey(pts[i],lo,scale),sortIds[i]);
+		std::sort(keys.begin(),keys.end());
+		Body::id_t next=firstId;
+		for(long i=0; i<nPts; i++){
+			const Body::id_t id=keys[i].second;
+			newIds[id]=next++;
+			const Body::id_t clumpId=(*bodies)[id]->clumpId;
+			if(clumpId>=firstId && (*bodies)[id]->isClumpMember() && --pendingMembers[clumpId]==0) newIds[clumpId]=next++;
+		}
+		// clumps without sorted members (empty, or all members below firstId)
+		FOREACH(Body::id_t id, clumps) if(newIds[id]<0) newIds[id]=next++;
+	} else {
+		Body::id_t next=firstId;
+		FOREACH(Body::id_t id, clumps) newIds[id]=next++;
+	}
+
+	bodies->renumber(newIds);
+	scene->interactions->renumber(newIds);
+	scene->forces.renumber(newIds);
+	FOREACH(const shared_ptr<Engine>& e, scene->engines) e->renumberBodies(newIds);
+	LOG_DEBUG("Renumbered "<<nPts<<" bodies and "<<clumps.size()<<" clumps, "<<scene->interactions->size()<<" interactions.");
+}
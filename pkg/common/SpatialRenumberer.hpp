@@ -0,0 +1,24 @@
+// 2026 © Yade developers
+#pragma once
+#include<pkg/common/PeriodicEngines.hpp>
+
+class SpatialRenumberer: public PeriodicEngine {
+	//! interleave lower 21 bits of x with two zero bits between each of them
+	static unsigned long long spreadBits(unsigned long long x);
+	void pyRenumber();
+	public:
+		//! Morton (z-order) key of point p inside the box [lo,lo+1/scale] quantized to 2^21 cells per axis
+		static unsigned long long mortonKey(const Vector3r& p, const Vector3r& lo, const Vector3r& scale);
+		virtual void action();
+	DECLARE_LOGGER;
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(SpatialRenumberer,PeriodicEngine,
+		"Renumber bodies along a Morton (z-order) curve of their bound centers (or positions, for bodies without :yref:`Bound`), so that bodies close in space are close in memory as well; interactions are reordered by the new ids. After long runs with flowing material, this restores the locality of memory accesses in :yref:`InteractionLoop` and :yref:`NewtonIntegrator`. Erased bodies are compacted away. Each :yref:`Clump` gets the id following its last member, so that it is still processed after its members.\n\n\
+		The following is remapped: :yref:`Body.id`, :yref:`Body.clumpId`, clump members, :yref:`Interaction.id1` and :yref:`Interaction.id2`, permanent forces in :yref:`ForceContainer`, :yref:`PartialEngine.ids`, the bounds of :yref:`InsertionSortCollider` (which need no initial sort afterwards; other colliders are reinitialized) and per-body data of :yref:`SleepingEngine` and :yref:`InteractionLoop.levels`, for engines in :yref:`O.engines<Omega.engines>`. Ids stored elsewhere (python variables, attributes of other engines, :yref:`Body.id` s saved in labels etc.) are *not* remapped; use :yref:`newIds<SpatialRenumberer.newIds>` to update them, or keep such bodies below :yref:`firstId<SpatialRenumberer.firstId>`.\n\n\
+		The engine should be placed after :yref:`NewtonIntegrator` (forces of the current step are cleared), with large period (e.g. ``iterPeriod=10000``); it can be also called directly via :yref:`renumber<SpatialRenumberer.renumber>`.",
+		((int,firstId,0,,"Bodies with smaller id keep their id (typically walls and other bodies referenced by id from scripts); empty slots below it are kept as well."))
+		((vector<int>,newIds,,Attr::readonly,"New id of each body after the last renumbering, indexed by the old id; -1 for erased bodies at or above :yref:`firstId<SpatialRenumberer.firstId>`, which are compacted away."))
+		,/*ctor*/
+		,/*py*/ .def("renumber",&SpatialRenumberer::pyRenumber,"Renumber bodies of the current scene now (regardless of periodicity).")
+	);
+};
+REGISTER_SERIALIZABLE(SpatialRenumberer);
@@ -243,7 +243,7 @@ void Ip2_CohFrictMat_CohFrictMat_CohFrictPhys::go(const shared_ptr<Material>& b1
 
 	if (geom) {
 		if (!interaction->phys) {
-			interaction->phys = shared_ptr<CohFrictPhys>(new CohFrictPhys());
+			interaction->phys = pooledShared<CohFrictPhys>();
 			CohFrictPhys* contactPhysics = YADE_CAST<CohFrictPhys*>(interaction->phys.get());
 			Real Ea 	= sdec1->young;
 			Real Eb 	= sdec2->young;
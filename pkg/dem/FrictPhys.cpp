@@ -19,7 +19,7 @@ void Ip2_FrictMat_FrictMat_FrictPhys::go( const shared_ptr<Material>& b1
 	Ra=sphCont->refR1>0?sphCont->refR1:sphCont->refR2;
 	Rb=sphCont->refR2>0?sphCont->refR2:sphCont->refR1;
 	
-	interaction->phys = shared_ptr<FrictPhys>(new FrictPhys());
+	interaction->phys = pooledShared<FrictPhys>();
 	const shared_ptr<FrictPhys>& contactPhysics = YADE_PTR_CAST<FrictPhys>(interaction->phys);
 	Real Ea 	= mat1->young;
 	Real Eb 	= mat2->young;
@@ -44,7 +44,7 @@ void Ip2_FrictMat_FrictMat_ViscoFrictPhys::go( const shared_ptr<Material>& b1
 	if(interaction->phys) return;
 	const shared_ptr<FrictMat>& mat1 = YADE_PTR_CAST<FrictMat>(b1);
 	const shared_ptr<FrictMat>& mat2 = YADE_PTR_CAST<FrictMat>(b2);
-	interaction->phys = shared_ptr<ViscoFrictPhys>(new ViscoFrictPhys());
+	interaction->phys = pooledShared<ViscoFrictPhys>();
 	const shared_ptr<ViscoFrictPhys>& contactPhysics = YADE_PTR_CAST<ViscoFrictPhys>(interaction->phys);
 	Real Ea 	= mat1->young;
 	Real Eb 	= mat2->young;
@@ -21,7 +21,7 @@ class Scene;
 
 class GlobalStiffnessTimeStepper : public TimeStepper
 {
-	private :
+	protected :
 		vector<Vector3r> stiffnesses;
 		vector<Vector3r> Rstiffnesses;
 		vector<Vector3r> viscosities;
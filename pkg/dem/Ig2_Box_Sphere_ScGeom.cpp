@@ -85,7 +85,7 @@ bool Ig2_Box_Sphere_ScGeom::go(const shared_ptr<Shape>& cm1, const shared_ptr<Sh
 		pt2 = se32.position-normal*s->radius;
 		Vector3r normal = pt1-pt2; normal.normalize();
 		bool isNew=!c->geom;
-		if (isNew) scm = shared_ptr<ScGeom>(new ScGeom());
+		if (isNew) scm = pooledShared<ScGeom>();
 		else scm = YADE_PTR_CAST<ScGeom>(c->geom);
 
 		// contact point is in the middle of overlapping volumes
@@ -128,7 +128,7 @@ bool Ig2_Box_Sphere_ScGeom::go(const shared_ptr<Shape>& cm1, const shared_ptr<Sh
 		pt2=se32.position+shift2+cOnBox_sphere*s->radius;
 
 		bool isNew=!c->geom;
-		if (isNew) scm = shared_ptr<ScGeom>(new ScGeom());
+		if (isNew) scm = pooledShared<ScGeom>();
 		else scm = YADE_PTR_CAST<ScGeom>(c->geom);
 		scm->contactPoint = 0.5*(pt1+pt2);
 		scm->penetrationDepth = depth;
@@ -158,7 +158,7 @@ bool Ig2_Box_Sphere_ScGeom6D::go(const shared_ptr<Shape>& cm1, const shared_ptr<
 	bool isNew = !c->geom;
 	if (Ig2_Box_Sphere_ScGeom::go(cm1,cm2,state1,state2,shift2,force,c)) {
 		if (isNew) {//generate a 6DOF interaction from the 3DOF one generated by Ig2_Box_Sphere_ScGeom
-			shared_ptr<ScGeom6D> sc(new ScGeom6D());
+			shared_ptr<ScGeom6D> sc=pooledShared<ScGeom6D>();
 			*(YADE_PTR_CAST<ScGeom>(sc)) = *(YADE_PTR_CAST<ScGeom>(c->geom));
 			c->geom=sc;
 		}
@@ -107,7 +107,7 @@ bool Ig2_Facet_Sphere_ScGeom::go(const shared_ptr<Shape>& cm1,
 		if (c->geom)
 			scm = YADE_PTR_CAST<ScGeom>(c->geom);
 		else
-			scm = shared_ptr<ScGeom>(new ScGeom());
+			scm = pooledShared<ScGeom>();
 	  
 		normal = facetAxisT*normal; // in global orientation
 		scm->contactPoint = se32.position + shift2 - (sphereRadius-0.5*penetrationDepth)*normal;
@@ -148,7 +148,7 @@ bool Ig2_Facet_Sphere_ScGeom6D::go(const shared_ptr<Shape>& cm1,
 	bool isNew = !c->geom;
 	if (Ig2_Facet_Sphere_ScGeom::go(cm1,cm2,state1,state2,shift2,force,c)) {
 		if (isNew) {//generate a 6DOF interaction from the 3DOF one generated by Ig2_Facet_Sphere_ScGeom
-			shared_ptr<ScGeom6D> sc(new ScGeom6D());
+			shared_ptr<ScGeom6D> sc=pooledShared<ScGeom6D>();
 			*(YADE_PTR_CAST<ScGeom>(sc)) = *(YADE_PTR_CAST<ScGeom>(c->geom));
 			c->geom=sc;
 		}
@@ -191,7 +191,7 @@ bool Ig2_Wall_Sphere_ScGeom::go(const shared_ptr<Shape>& cm1, const shared_ptr<S
 	else normal[ax]=wall->sense==1?1.:-1;
 
 	bool isNew=!c->geom;
-	if(isNew) c->geom=shared_ptr<ScGeom>(new ScGeom());
+	if(isNew) c->geom=pooledShared<ScGeom>();
 	const shared_ptr<ScGeom>& ws=YADE_PTR_CAST<ScGeom>(c->geom);
 	ws->radius1=ws->radius2=radius; // do the same as for facet-sphere: wall's "radius" is the same as the sphere's radius
 	ws->contactPoint=contPt;
@@ -26,7 +26,7 @@ bool Ig2_Sphere_Sphere_ScGeom::go(	const shared_ptr<Shape>& cm1, const shared_pt
 	shared_ptr<ScGeom> scm;
 	bool isNew = !c->geom;
 	if(!isNew) scm=YADE_PTR_CAST<ScGeom>(c->geom);
-	else { scm=shared_ptr<ScGeom>(new ScGeom()); c->geom=scm; }
+	else { scm=pooledShared<ScGeom>(); c->geom=scm; }
 	Real norm=normal.norm(); normal/=norm; // normal is unit vector now
 #ifdef YADE_DEBUG
 	if(norm==0) throw runtime_error(("Zero distance between spheres #"+boost::lexical_cast<string>(c->getId1())+" and #"+boost::lexical_cast<string>(c->getId2())+".").c_str());
@@ -59,7 +59,7 @@ bool Ig2_Sphere_Sphere_ScGeom6D::go( const shared_ptr<Shape>& cm1, const shared_
 	bool isNew = !c->geom;
 	if (Ig2_Sphere_Sphere_ScGeom::go(cm1,cm2,state1,state2,shift2,force,c)){//the 3 DOFS from ScGeom are updated here
  		if (isNew) {//generate a 6DOF interaction from the 3DOF one generated by Ig2_Sphere_Sphere_ScGeom
-			shared_ptr<ScGeom6D> sc (new ScGeom6D());
+			shared_ptr<ScGeom6D> sc=pooledShared<ScGeom6D>();
 			*(YADE_PTR_CAST<ScGeom>(sc)) = *(YADE_PTR_CAST<ScGeom>(c->geom));
 			c->geom=sc;}
 		if (updateRotations) YADE_PTR_CAST<ScGeom6D>(c->geom)->precomputeRotations(state1,state2,isNew,creep);
@@ -43,7 +43,7 @@ void Ip2_ElastMat_ElastMat_NormShearPhys::go( const shared_ptr<Material>& b1
 	Real Eb 	= mat2->young;
 	Real Va 	= mat1->poisson;
 	Real Vb 	= mat2->poisson;
-	interaction->phys = shared_ptr<NormShearPhys>(new NormShearPhys());
+	interaction->phys = pooledShared<NormShearPhys>();
 	const shared_ptr<NormShearPhys>& phys = YADE_PTR_CAST<NormShearPhys>(interaction->phys);
 	Real Kn=0.0, Ks=0.0;
 	GenericSpheresContact* geom=dynamic_cast<GenericSpheresContact*>(interaction->geom.get());
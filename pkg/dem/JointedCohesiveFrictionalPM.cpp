@@ -11,6 +11,24 @@ YADE_PLUGIN((JCFpmMat)(JCFpmState)(JCFpmPhys)(Ip2_JCFpmMat_JCFpmMat_JCFpmPhys)(L
 /********************** Law2_ScGeom_JCFpmPhys_JointedCohesiveFrictionalPM ****************************/
 CREATE_LOGGER(Law2_ScGeom_JCFpmPhys_JointedCohesiveFrictionalPM);
 
+void Law2_ScGeom_JCFpmPhys_JointedCohesiveFrictionalPM::preStep(){
+	// resolved here, before the parallel loop, which only pushes events
+	if(!recordCracks) return;
+	EventLog* log=scene->events.get();
+	if(crackSource<0 || crackLog!=log){
+		log->findSource("JCFpm",crackSource,"cracks_"+Key+".txt",!cracksFileExist);
+		crackLog=log;
+		cracksFileExist=true; // the file is truncated (if at all) only once
+	}
+}
+
+void Law2_ScGeom_JCFpmPhys_JointedCohesiveFrictionalPM::recordCrack(const ScGeom* geom, const JCFpmPhys* phys, int type, Real energy, Interaction* I){
+	// events are buffered per thread and written by a background thread, nothing is written to the disk here
+	assert(crackSource>=0 && crackLog==scene->events.get());
+	const Vector3r& crackNormal=((smoothJoint) && (phys->isOnJoint)) ? phys->jointNormal : geom->normal;
+	scene->events->push(scene->iter,scene->time,crackSource,type,I->getId1(),I->getId2(),geom->contactPoint,crackNormal,0.5*(geom->radius1+geom->radius2),energy);
+}
+
 bool Law2_ScGeom_JCFpmPhys_JointedCohesiveFrictionalPM::go(shared_ptr<IGeom>& ig, shared_ptr<IPhys>& ip, Interaction* contact){
 
 	const int &id1 = contact->getId1();
@@ -23,7 +41,6 @@ bool Law2_ScGeom_JCFpmPhys_JointedCohesiveFrictionalPM::go(shared_ptr<IGeom>& ig
 
 	Real Dtensile=phys->FnMax/phys->kn;
 	
-	string fileCracks = "cracks_"+Key+".txt";
 	/// Defines the interparticular distance used for computation
 	Real D = 0;
 
@@ -84,15 +101,8 @@ bool Law2_ScGeom_JCFpmPhys_JointedCohesiveFrictionalPM::go(shared_ptr<IGeom>& ig
 	    st1->tensBreakRel+=1.0/st1->noIniLinks;
 	    st2->tensBreakRel+=1.0/st2->noIniLinks;
 	    
-    	    // create a text file to record properties of the broken bond (iteration, position, type (tensile), cross section and contact normal orientation)
-	    if (recordCracks){
-	      std::ofstream file (fileCracks.c_str(), !cracksFileExist ? std::ios::trunc : std::ios::app);
-	      if(file.tellp()==0){ file <<"i p0 p1 p2 t s norm0 norm1 norm2"<<endl; }
-	      Vector3r crackNormal=Vector3r::Zero();
-	      if ((smoothJoint) && (phys->isOnJoint)) { crackNormal=phys->jointNormal; } else {crackNormal=geom->normal;}
-	      file << boost::lexical_cast<string> ( scene->iter )<<" "<< boost::lexical_cast<string> ( geom->contactPoint[0] ) <<" "<< boost::lexical_cast<string> ( geom->contactPoint[1] ) <<" "<< boost::lexical_cast<string> ( geom->contactPoint[2] ) <<" "<< 0 <<" "<< boost::lexical_cast<string> ( 0.5*(geom->radius1+geom->radius2) ) <<" "<< boost::lexical_cast<string> ( crackNormal[0] ) <<" "<< boost::lexical_cast<string> ( crackNormal[1] ) <<" "<< boost::lexical_cast<string> ( crackNormal[2] ) << endl;
-	    }
-	    cracksFileExist=true;
+	    // record properties of the broken bond (iteration, position, type (tensile), cross section and contact normal orientation)
+	    if (recordCracks) recordCrack(geom,phys,0,0.5*(pow(phys->FnMax,2)/phys->kn+phys->shearForce.squaredNorm()/phys->ks),contact);
 	    /// Timos
 	    if (!neverErase) return false; 
 	    else {
@@ -156,15 +166,8 @@ bool Law2_ScGeom_JCFpmPhys_JointedCohesiveFrictionalPM::go(shared_ptr<IGeom>& ig
 	    st1->shearBreakRel+=1.0/st1->noIniLinks;
 	    st2->shearBreakRel+=1.0/st2->noIniLinks;
 
-	    // create a text file to record properties of the broken bond (iteration, position, type (shear), cross section and contact normal orientation)
-	    if (recordCracks){
-	      std::ofstream file (fileCracks.c_str(), !cracksFileExist ? std::ios::trunc : std::ios::app);
-	      if(file.tellp()==0){ file <<"i p0 p1 p2 t s norm0 norm1 norm2"<<endl; }
-	      Vector3r crackNormal=Vector3r::Zero();
-	      if ((smoothJoint) && (phys->isOnJoint)) { crackNormal=phys->jointNormal; } else {crackNormal=geom->normal;}
-	      file << boost::lexical_cast<string> ( scene->iter )<<" "<< boost::lexical_cast<string> ( geom->contactPoint[0] ) <<" "<< boost::lexical_cast<string> ( geom->contactPoint[1] ) <<" "<< boost::lexical_cast<string> ( geom->contactPoint[2] ) <<" "<< 1 <<" "<< boost::lexical_cast<string> ( 0.5*(geom->radius1+geom->radius2) ) <<" "<< boost::lexical_cast<string> ( crackNormal[0] ) <<" "<< boost::lexical_cast<string> ( crackNormal[1] ) <<" "<< boost::lexical_cast<string> ( crackNormal[2] ) << endl;
-	    }
-	    cracksFileExist=true;
+	    // record properties of the broken bond (iteration, position, type (shear), cross section and contact normal orientation)
+	    if (recordCracks) recordCrack(geom,phys,1,0.5*(pow(Fn,2)/phys->kn+pow(maxFs,2)/phys->ks),contact);
 	    
 	    // set the contact properties to friction if in compression, delete contact if in tension
 	    phys->isBroken = true;
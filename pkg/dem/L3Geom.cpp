@@ -86,8 +86,8 @@ Generic function to compute L3Geom (with colinear points), used for {sphere,face
 void Ig2_Sphere_Sphere_L3Geom::handleSpheresLikeContact(const shared_ptr<Interaction>& I, const State& state1, const State& state2, const Vector3r& shift2, bool is6Dof, const Vector3r& normal, const Vector3r& contPt, Real uN, Real r1, Real r2){
 	// create geometry
 	if(!I->geom){
-		if(is6Dof) I->geom=shared_ptr<L6Geom>(new L6Geom);
-		else       I->geom=shared_ptr<L3Geom>(new L3Geom);
+		if(is6Dof) I->geom=pooledShared<L6Geom>();
+		else       I->geom=pooledShared<L3Geom>();
 		L3Geom& g(I->geom->cast<L3Geom>());
 		g.contactPoint=contPt;
 		g.refR1=r1; g.refR2=r2;
@@ -200,11 +200,14 @@ void Law2_ScGeom_CapillaryPhys_Capillarity::action()
 					//LINEAR VERSION : capillary force is divided by (fusionNumber + 1) - NOTE : any decreasing function of fusionNumber can be considered in fact
 					else if (fusionNumber !=0) hertzOn?mindlinContactPhysics->fCap:cundallContactPhysics->fCap /= (fusionNumber+1.);
 				}
+				// in the deterministic mode, forces are summed in the order of interactions (see Scene::deterministic)
+				scene->forces.setOrderKey(interaction->getId1(),interaction->getId2());
 				scene->forces.addForce(interaction->getId1(),-(hertzOn?mindlinContactPhysics->fCap:cundallContactPhysics->fCap));
 				scene->forces.addForce(interaction->getId2(),  hertzOn?mindlinContactPhysics->fCap:cundallContactPhysics->fCap );
 			}
 		}
 	}
+	scene->forces.clearOrderKeys();
 }
 
 capillarylaw::capillarylaw()
@@ -0,0 +1,148 @@
+// 2026 © Yade developers
+#include<pkg/dem/MacroQuantities.hpp>
+#include<pkg/dem/NewtonIntegrator.hpp>
+#include<pkg/common/NormShearPhys.hpp>
+#include<pkg/common/Sphere.hpp>
+#include<pkg/common/Grid.hpp>
+#include<pkg/dem/DemXDofGeom.hpp>
+#include<core/Clump.hpp>
+
+YADE_PLUGIN((MacroQuantities));
+CREATE_LOGGER(MacroQuantities);
+
+void MacroQuantities::ThreadSums::reset(){
+	sumBodyF=maxBodyF=sumIntrF=sumFn=kinetic=0;
+	nBodyF=nIntrs=nContacts=nBodies=nBodyIntrs=0;
+	stress=sigN=sigT=fabric=Matrix3r::Zero();
+	bbMin=Vector3r::Constant(Mathr::MAX_REAL); bbMax=-bbMin;
+	hist.clear();
+}
+
+MacroQuantities* MacroQuantities::upToDate(Scene* scene){
+	FOREACH(const shared_ptr<Engine>& e, scene->engines){
+		MacroQuantities* mq=dynamic_cast<MacroQuantities*>(e.get());
+		if(mq) return (mq->iterComputed==scene->iter && !mq->dead) ? mq : NULL;
+	}
+	return NULL;
+}
+
+void MacroQuantities::compute(){
+	scene->forces.sync();
+	Vector3r gravity=Vector3r::Zero();
+	FOREACH(const shared_ptr<Engine>& e, scene->engines){ NewtonIntegrator* newton=dynamic_cast<NewtonIntegrator*>(e.get()); if(newton){ gravity=newton->gravity; break; } }
+	FOREACH(ThreadSums& S, threadSums) S.reset();
+	const bool isPeriodic=scene->isPeriodic;
+	const int sphereIndex=Sphere::getClassIndexStatic(), gridNodeIndex=GridNode::getClassIndexStatic();
+
+	// bodies: unbalanced force, kinetic energy, number of interactions per body, bounding box of spheres
+	const long nBodies=scene->bodies->size();
+	#ifdef YADE_OPENMP
+	#pragma omp parallel for schedule(guided)
+	#endif
+	for(long id=0; id<nBodies; id++){
+		const shared_ptr<Body>& b=(*scene->bodies)[id];
+		if(!b) continue;
+		#ifdef YADE_OPENMP
+			ThreadSums& S=threadSums[omp_get_thread_num()];
+		#else
+			ThreadSums& S=threadSums[0];
+		#endif
+		const State* state=b->state.get();
+		if(b->shape && b->shape->getClassIndex()==sphereIndex){
+			const Real r=static_cast<Sphere*>(b->shape.get())->radius;
+			S.bbMin=S.bbMin.cwiseMin(state->pos-Vector3r::Constant(r)); S.bbMax=S.bbMax.cwiseMax(state->pos+Vector3r::Constant(r));
+		}
+		if(b->isDynamic()){
+			// same expressions as Shop::kineticEnergy
+			Real E;
+			if(isPeriodic) E=.5*state->mass*scene->cell->bodyFluctuationVel(state->pos,state->vel,scene->cell->velGrad).squaredNorm();
+			else E=.5*state->mass*state->vel.squaredNorm();
+			if(b->isAspherical()){
+				Matrix3r T(state->ori); Matrix3r mI(state->inertia.asDiagonal());
+				E+=.5*state->angVel.transpose().dot((T*mI*T.transpose())*state->angVel);
+			} else E+=.5*state->angVel.dot(state->inertia.cwiseProduct(state->angVel));
+			S.kinetic+=E;
+		}
+		if(b->isClumpMember()) continue;
+		if(b->isDynamic()){
+			// same as Shop::unbalancedForce, including the case of clumps before NewtonIntegrator
+			Real currF=(scene->forces.getForce(id)+state->mass*gravity).norm();
+			if(b->isClump() && currF==0){
+				Vector3r f(scene->forces.getForce(id)),m(Vector3r::Zero());
+				b->shape->cast<Clump>().addForceTorqueFromMembers(state,scene,f,m);
+				currF=(f+state->mass*gravity).norm();
+			}
+			S.maxBodyF=max(S.maxBodyF,currF); S.sumBodyF+=currF; S.nBodyF++;
+		}
+		// interactions of clump members are counted for the clump
+		int n=0;
+		FOREACH(const Body::MapId2IntrT::value_type& mi, b->intrs) if(mi.second->isReal()) n++;
+		if(b->isClump()){
+			FOREACH(const Clump::MemberMap::value_type& mm, b->shape->cast<Clump>().members){
+				const shared_ptr<Body>& member=Body::byId(mm.first,scene);
+				FOREACH(const Body::MapId2IntrT::value_type& mi, member->intrs) if(mi.second->isReal()) n++;
+			}
+		}
+		if((int)S.hist.size()<=n) S.hist.resize(n+1,0);
+		S.hist[n]++; S.nBodies++; S.nBodyIntrs+=n;
+	}
+
+	// interactions: contact forces, stress, fabric
+	const long nIntrs=scene->interactions->size();
+	#ifdef YADE_OPENMP
+	#pragma omp parallel for schedule(guided)
+	#endif
+	for(long i=0; i<nIntrs; i++){
+		const shared_ptr<Interaction>& I=(*scene->interactions)[i];
+		if(!I->isReal()) continue;
+		#ifdef YADE_OPENMP
+			ThreadSums& S=threadSums[omp_get_thread_num()];
+		#else
+			ThreadSums& S=threadSums[0];
+		#endif
+		const NormShearPhys* phys=YADE_CAST<NormShearPhys*>(I->phys.get());
+		S.sumIntrF+=(phys->normalForce+phys->shearForce).norm(); S.nIntrs++;
+		const shared_ptr<Body>& b1=Body::byId(I->getId1(),scene); const shared_ptr<Body>& b2=Body::byId(I->getId2(),scene);
+		if(b1->shape->getClassIndex()!=gridNodeIndex){
+			Vector3r branch=b1->state->pos-b2->state->pos;
+			if(isPeriodic) branch-=scene->cell->hSize*I->cellDist.cast<Real>();
+			S.stress+=(phys->normalForce+phys->shearForce)*branch.transpose();
+		}
+		const GenericSpheresContact* geom=dynamic_cast<GenericSpheresContact*>(I->geom.get());
+		if(!geom) continue;
+		const Vector3r& n=geom->normal;
+		const Real N=phys->normalForce.dot(n), T=phys->shearForce.norm(), R=.5*(geom->refR1+geom->refR2);
+		S.fabric+=n*n.transpose(); S.nContacts++;
+		S.sumFn+=N;
+		S.sigN+=R*N*n*n.transpose();
+		if(T>0) S.sigT+=R*n*phys->shearForce.transpose();
+	}
+
+	// reduction
+	ThreadSums sum; sum.reset();
+	FOREACH(const ThreadSums& S, threadSums){
+		sum.sumBodyF+=S.sumBodyF; sum.maxBodyF=max(sum.maxBodyF,S.maxBodyF); sum.sumIntrF+=S.sumIntrF; sum.sumFn+=S.sumFn; sum.kinetic+=S.kinetic;
+		sum.nBodyF+=S.nBodyF; sum.nIntrs+=S.nIntrs; sum.nContacts+=S.nContacts; sum.nBodies+=S.nBodies; sum.nBodyIntrs+=S.nBodyIntrs;
+		sum.stress+=S.stress; sum.sigN+=S.sigN; sum.sigT+=S.sigT; sum.fabric+=S.fabric;
+		sum.bbMin=sum.bbMin.cwiseMin(S.bbMin); sum.bbMax=sum.bbMax.cwiseMax(S.bbMax);
+		if(sum.hist.size()<S.hist.size()) sum.hist.resize(S.hist.size(),0);
+		for(size_t k=0; k<S.hist.size(); k++) sum.hist[k]+=S.hist[k];
+	}
+	Real vol=volume;
+	if(vol<=0) vol=isPeriodic ? scene->cell->hSize.determinant() : (sum.bbMax-sum.bbMin).prod();
+	const Real meanIntrF=sum.sumIntrF/sum.nIntrs;
+	unbalancedForce=(sum.sumBodyF/sum.nBodyF)/meanIntrF;
+	maxUnbalancedForce=sum.maxBodyF/meanIntrF;
+	kineticEnergy=sum.kinetic;
+	stress=sum.stress/vol;
+	// only the upper triangle of the shear part is meaningful, as in Shop::normalShearStressTensors
+	sum.sigT(1,0)=sum.sigT(0,1); sum.sigT(2,0)=sum.sigT(0,2); sum.sigT(2,1)=sum.sigT(1,2);
+	normalStress=sum.sigN*2/vol; shearStress=sum.sigT*2/vol;
+	// averaged over the contacts they are accumulated from, other interactions would bias them low
+	fabric=sum.nContacts>0 ? Matrix3r(sum.fabric/sum.nContacts) : Matrix3r::Zero();
+	meanNormalForce=sum.nContacts>0 ? sum.sumFn/sum.nContacts : 0;
+	numContacts=sum.nIntrs;
+	coordNumber=sum.nBodies>0 ? sum.nBodyIntrs*1./sum.nBodies : 0;
+	numInteractionsHistogram=sum.hist;
+	iterComputed=scene->iter;
+}
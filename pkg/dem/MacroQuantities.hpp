@@ -0,0 +1,49 @@
+// 2026 © Yade developers
+#pragma once
+
+#include<pkg/common/PeriodicEngines.hpp>
+
+class MacroQuantities: public PeriodicEngine{
+	// per-thread partial results, reduced serially at the end of compute()
+	struct ThreadSums{
+		Real sumBodyF, maxBodyF, sumIntrF, sumFn, kinetic;
+		long nBodyF, nIntrs, nContacts, nBodies, nBodyIntrs; // nContacts: interactions with GenericSpheresContact
+		Matrix3r stress, sigN, sigT, fabric;
+		Vector3r bbMin, bbMax;
+		vector<int> hist;
+		void reset();
+	};
+	vector<ThreadSums> threadSums;
+	public:
+		virtual void action(){ compute(); }
+		//! compute all quantities now, in one pass over bodies and one pass over interactions
+		void compute();
+		void pyCompute(){ scene=Omega::instance().getScene().get(); compute(); }
+		//! return the first MacroQuantities engine of the scene if its values were computed in the current iteration, NULL otherwise
+		static MacroQuantities* upToDate(Scene* scene);
+	DECLARE_LOGGER;
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(MacroQuantities,PeriodicEngine,"Compute global quantities usually obtained from :yref:`yade.utils.unbalancedForce`, :yref:`yade.utils.getStress`, :yref:`yade.utils.fabricTensor`, :yref:`yade.utils.normalShearStressTensors`, :yref:`yade.utils.kineticEnergy` and :yref:`yade.utils.bodyNumInteractionsHistogram` in a single (parallel) pass over bodies and a single pass over interactions, and keep results as attributes. Results are cached with the iteration they were computed at (:yref:`iterComputed<MacroQuantities.iterComputed>`); C++ controllers (currently :yref:`TriaxialStressController.unbalancedForce<TriaxialStressController>`) use them instead of recomputing when they are fresh.\n\nThe engine should be placed after :yref:`InteractionLoop` (and before :yref:`NewtonIntegrator`), so that forces of the current step are summed up; engines using the cached values must come after it in the same step. Interactions must have :yref:`NormShearPhys`; fabric and normal/shear stress decomposition are only evaluated for :yref:`GenericSpheresContact` geometries.",
+		((Real,volume,0,,"Volume used to compute stresses; if 0, volume of the periodic cell, or volume of the axis-aligned box containing all spheres in aperiodic simulations."))
+		((long,iterComputed,-1,Attr::readonly,"Iteration at which the quantities were last computed."))
+		((Real,unbalancedForce,NaN,Attr::readonly,"Mean resultant force on dynamic bodies (gravity included) divided by the mean contact force, as :yref:`yade.utils.unbalancedForce` with useMaxForce=False."))
+		((Real,maxUnbalancedForce,NaN,Attr::readonly,"Same as :yref:`unbalancedForce<MacroQuantities.unbalancedForce>`, but using the maximum resultant force instead of the mean."))
+		((Real,kineticEnergy,0,Attr::readonly,"Kinetic energy of dynamic bodies (fluctuation velocity in periodic simulations), as :yref:`yade.utils.kineticEnergy`."))
+		((Matrix3r,stress,Matrix3r::Zero(),Attr::readonly,"Love-Weber stress tensor, as :yref:`yade.utils.getStress`."))
+		((Matrix3r,normalStress,Matrix3r::Zero(),Attr::readonly,"Contribution of normal forces to the stress tensor (tensile positive), as the first item of :yref:`yade.utils.normalShearStressTensors`."))
+		((Matrix3r,shearStress,Matrix3r::Zero(),Attr::readonly,"Contribution of shear forces to the stress tensor, as the second item of :yref:`yade.utils.normalShearStressTensors`."))
+		((Matrix3r,fabric,Matrix3r::Zero(),Attr::readonly,"Fabric tensor [Satake1982]_, as :yref:`yade.utils.fabricTensor`."))
+		((Real,meanNormalForce,0,Attr::readonly,"Mean (signed) normal contact force, tensile positive, over interactions with :yref:`GenericSpheresContact` geometry."))
+		((long,numContacts,0,Attr::readonly,"Number of real interactions."))
+		((Real,coordNumber,0,Attr::readonly,"Average number of real interactions per body (clumps count as one body)."))
+		((vector<int>,numInteractionsHistogram,,Attr::readonly,"Number of bodies having *i* real interactions at the *i*-th position (clumps count as one body)."))
+		,/*ctor*/
+			#ifdef YADE_OPENMP
+				threadSums.resize(omp_get_max_threads());
+			#else
+				threadSums.resize(1);
+			#endif
+		,/*py*/
+		.def("compute",&MacroQuantities::pyCompute,"Compute all quantities now, regardless of the engine's period.")
+	);
+};
+REGISTER_SERIALIZABLE(MacroQuantities);
@@ -0,0 +1,76 @@
+// 2026 © Yade developers
+#include<pkg/dem/MultiRateTimeStepper.hpp>
+#include<pkg/common/InteractionLoop.hpp>
+#include<pkg/common/ElastMat.hpp>
+#include<pkg/common/Sphere.hpp>
+#include<pkg/dem/Shop.hpp>
+#include<core/Clump.hpp>
+#include<core/Scene.hpp>
+
+YADE_PLUGIN((MultiRateTimeStepper));
+CREATE_LOGGER(MultiRateTimeStepper);
+
+Real MultiRateTimeStepper::bodyCriticalDt(const shared_ptr<Body>& b){
+	const State* state=b->state.get();
+	Vector3r stiffness=stiffnesses[b->id], Rstiffness=Rstiffnesses[b->id];
+	if(b->isClump()){
+		FOREACH(const Clump::MemberMap::value_type& m, YADE_PTR_CAST<Clump>(b->shape)->members){ stiffness+=stiffnesses[m.first]; Rstiffness+=Rstiffnesses[m.first]; }
+	}
+	Real dt2=Mathr::MAX_REAL;
+	if(stiffness.maxCoeff()>0) dt2=state->mass/stiffness.maxCoeff();
+	for(int i=0; i<3; i++) if(Rstiffness[i]>0) dt2=min(dt2,state->inertia[i]/Rstiffness[i]);
+	if(dt2==Mathr::MAX_REAL) return Mathr::MAX_REAL;
+	return 1.41044*timestepSafetyCoefficient*sqrt(dt2);
+}
+
+Real MultiRateTimeStepper::bodyPWaveDt(const shared_ptr<Body>& b){
+	const Sphere* sphere=dynamic_cast<Sphere*>(b->shape.get());
+	const ElastMat* mat=dynamic_cast<ElastMat*>(b->material.get());
+	if(!sphere || !mat || mat->young<=0) return Mathr::MAX_REAL;
+	return timestepSafetyCoefficient*sphere->radius/sqrt(mat->young/mat->density);
+}
+
+void MultiRateTimeStepper::computeTimeStep(Scene* ncb){
+	if(nLevels<1) throw std::invalid_argument("MultiRateTimeStepper.nLevels must be positive.");
+	if(viscEl || densityScaling) throw std::invalid_argument("MultiRateTimeStepper: viscEl and densityScaling are not supported.");
+	if(defaultDt<0) defaultDt=timestepSafetyCoefficient*Shop::PWaveTimeStep(Omega::instance().getScene());
+	shared_ptr<InteractionLoop> loop;
+	FOREACH(const shared_ptr<Engine>& e, ncb->engines){ loop=YADE_PTR_DYN_CAST<InteractionLoop>(e); if(loop) break; }
+	if(!loop) throw std::runtime_error("MultiRateTimeStepper: no InteractionLoop in O.engines.");
+	computeStiffnesses(ncb);
+
+	const long nBodies=ncb->bodies->size();
+	vector<Real> bodyDt(nBodies,Mathr::MAX_REAL);
+	Real minDt=Mathr::MAX_REAL;
+	bool fromStiffness=false;
+	for(long id=0; id<nBodies; id++){
+		const shared_ptr<Body>& b=(*ncb->bodies)[id];
+		if(!b || b->isClumpMember() || !b->isDynamic()) continue;
+		bodyDt[id]=bodyCriticalDt(b);
+		if(bodyDt[id]<Mathr::MAX_REAL) fromStiffness=true;
+		else bodyDt[id]=bodyPWaveDt(b);
+		minDt=min(minDt,bodyDt[id]);
+	}
+	if(fromStiffness){
+		previousDt=min(min(minDt,maxDt),1.05*previousDt);
+		ncb->dt=previousDt;
+		computedOnce=true;
+	} else if(!computedOnce) ncb->dt=defaultDt;
+
+	// levels; clump members share the level of their clump, bodies without estimate stay at level 0
+	loop->levels.assign(nBodies,0);
+	levelCounts.assign(nLevels,0);
+	for(long id=0; id<nBodies; id++){
+		const shared_ptr<Body>& b=(*ncb->bodies)[id];
+		if(!b || b->isClumpMember()) continue;
+		int level=0;
+		if(bodyDt[id]<Mathr::MAX_REAL) level=max(0,min(nLevels-1,(int)floor(log2(bodyDt[id]/ncb->dt))));
+		else if(!b->isDynamic()) level=nLevels-1; // fixed bodies take the level of their dynamic neighbours
+		loop->levels[id]=level;
+		if(b->isClump()){
+			FOREACH(const Clump::MemberMap::value_type& m, YADE_PTR_CAST<Clump>(b->shape)->members) loop->levels[m.first]=level;
+		}
+		if(b->isDynamic()) levelCounts[level]++;
+	}
+	if(nLevels==1) loop->levels.clear();
+}
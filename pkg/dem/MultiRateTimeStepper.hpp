@@ -0,0 +1,21 @@
+// 2026 © Yade developers
+#pragma once
+#include<pkg/dem/GlobalStiffnessTimeStepper.hpp>
+
+class MultiRateTimeStepper: public GlobalStiffnessTimeStepper {
+	// critical time step of a body from contact stiffnesses (infinite without contacts)
+	Real bodyCriticalDt(const shared_ptr<Body>& b);
+	// critical time step of a free body (P-wave in the body), infinite if it cannot be estimated
+	Real bodyPWaveDt(const shared_ptr<Body>& b);
+	public:
+		virtual void computeTimeStep(Scene*);
+	DECLARE_LOGGER;
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR(MultiRateTimeStepper,GlobalStiffnessTimeStepper,
+		"Time stepper for multi-rate integration: like :yref:`GlobalStiffnessTimeStepper`, it sets :yref:`O.dt<Omega.dt>` to the minimum critical time step of bodies, but it also assigns each body a level :math:`l`, the largest one such that :math:`2^l O.dt` is below the critical time step of the body (from stiffness of its contacts and its mass, or from the P-wave speed in the body if it has no contacts). Levels are written to :yref:`InteractionLoop.levels`, so that interactions among slow (large, soft) bodies are evaluated only every :math:`2^l` steps; in between, their last force is applied again, which conserves momentum, and :yref:`NewtonIntegrator` moves all bodies at every step, so that fast bodies always see current positions of their slow neighbours. Interactions between bodies of different levels are evaluated at the rate of the faster one.\n\n\
+		This pays off for wide size distributions, where few fine particles limit the time step of the whole packing. Viscous and density-scaling options of the base class are not supported, and interactions with contact moments (see :yref:`levels<InteractionLoop.levels>`) are evaluated at every step. See :ysrc:`examples/multirate/benchmark.py`.",
+		((int,nLevels,4,,"Number of levels (level 0 is the finest one); 1 gives single-rate integration."))
+		((vector<int>,levelCounts,,Attr::readonly,"Number of bodies at each level, after the last update."))
+		,/*ctor*/
+	);
+};
+REGISTER_SERIALIZABLE(MultiRateTimeStepper);
@@ -37,27 +37,50 @@ Vector3r NewtonIntegrator::computeAngAccel(const Vector3r& torque, const Vector3
 	return ret;
 }
 
-void NewtonIntegrator::updateEnergy(const shared_ptr<Body>& b, const State* state, const Vector3r& fluctVel, const Vector3r& f, const Vector3r& m){
+void NewtonIntegrator::updateEnergy(const shared_ptr<Body>& b, const State* state, const Vector3r& fluctVel, const Vector3r& f, const Vector3r& m, bool kinetic){
 	assert(b->isStandalone() || b->isClump());
+	// in the deterministic mode, values of each body go to the EnergyTracker directly, where they are summed exactly; per-thread sums would depend on the number of threads
+	ThreadEnergy local; local.reset();
+	#ifdef YADE_OPENMP
+		ThreadEnergy& E=(scene->deterministic ? local : threadEnergy[omp_get_thread_num()]);
+	#else
+		ThreadEnergy& E=(scene->deterministic ? local : threadEnergy[0]);
+	#endif
 	// always positive dissipation, by-component: |F_i|*|v_i|*damping*dt (|T_i|*|ω_i|*damping*dt for rotations)
-	if(damping!=0. && state->isDamped){
-		scene->energy->add(fluctVel.cwiseAbs().dot(f.cwiseAbs())*damping*scene->dt,"nonviscDamp",nonviscDampIx,/*non-incremental*/false);
-		// when the aspherical integrator is used, torque is damped instead of ang acceleration; this code is only approximate
-		scene->energy->add(state->angVel.cwiseAbs().dot(m.cwiseAbs())*damping*scene->dt,"nonviscDamp",nonviscDampIx,false);
-	}
-	// kinetic energy
-	Real Etrans=.5*state->mass*fluctVel.squaredNorm();
-	Real Erot;
-	// rotational terms
-	if(b->isAspherical()){
-		Matrix3r mI; mI<<state->inertia[0],0,0, 0,state->inertia[1],0, 0,0,state->inertia[2];
-		Matrix3r T(state->ori);
-		Erot=.5*b->state->angVel.transpose().dot((T.transpose()*mI*T)*b->state->angVel);
-	} else { Erot=0.5*state->angVel.dot(state->inertia.cwiseProduct(state->angVel)); }
-	if(!kinSplit) scene->energy->add(Etrans+Erot,"kinetic",kinEnergyIx,/*non-incremental*/true);
-	else{ scene->energy->add(Etrans,"kinTrans",kinEnergyTransIx,true); scene->energy->add(Erot,"kinRot",kinEnergyRotIx,true); }
+	// when the aspherical integrator is used, torque is damped instead of ang acceleration; this code is only approximate
+	if(damping!=0. && state->isDamped){ E.damped=true; E.nonviscDamp+=(fluctVel.cwiseAbs().dot(f.cwiseAbs())+state->angVel.cwiseAbs().dot(m.cwiseAbs()))*damping*scene->dt; }
 	// gravitational work (work done by gravity is "negative", since the energy appears in the system from outside)
-	scene->energy->add(-gravity.dot(b->state->vel)*b->state->mass*scene->dt,"gravWork",fieldWorkIx,/*non-incremental*/false);
+	E.gravWork-=gravity.dot(b->state->vel)*b->state->mass*scene->dt;
+	if(kinetic){
+		// kinetic energy
+		E.kinTrans+=.5*state->mass*fluctVel.squaredNorm();
+		// rotational terms
+		if(b->isAspherical()){
+			// equal to ½ω·(TᵀIT)ω with T the rotation matrix of ori and I diagonal, without building the matrices
+			const Vector3r w(state->ori*state->angVel);
+			E.kinRot+=.5*w.dot(state->inertia.cwiseProduct(w));
+		} else { E.kinRot+=0.5*state->angVel.dot(state->inertia.cwiseProduct(state->angVel)); }
+	}
+	if(scene->deterministic) addEnergy(local,kinetic);
+}
+
+void NewtonIntegrator::reduceEnergy(bool kinetic){
+	// in the deterministic mode, everything was added by updateEnergy already
+	if(scene->deterministic) return;
+	ThreadEnergy sum; sum.reset();
+	FOREACH(const ThreadEnergy& E, threadEnergy){ sum.nonviscDamp+=E.nonviscDamp; sum.kinTrans+=E.kinTrans; sum.kinRot+=E.kinRot; sum.gravWork+=E.gravWork; sum.damped|=E.damped; }
+	// called outside the parallel section, hence each value hits the accumulator only once
+	addEnergy(sum,kinetic);
+}
+
+void NewtonIntegrator::addEnergy(const ThreadEnergy& sum, bool kinetic){
+	// registered only if some body was damped, not merely because damping is set
+	if(sum.damped) scene->energy->add(sum.nonviscDamp,"nonviscDamp",nonviscDampIx,/*non-incremental*/false);
+	if(kinetic){
+		if(!kinSplit) scene->energy->add(sum.kinTrans+sum.kinRot,"kinetic",kinEnergyIx,/*non-incremental*/true);
+		else{ scene->energy->add(sum.kinTrans,"kinTrans",kinEnergyTransIx,true); scene->energy->add(sum.kinRot,"kinRot",kinEnergyRotIx,true); }
+	}
+	scene->energy->add(sum.gravWork,"gravWork",fieldWorkIx,/*non-incremental*/false);
 }
 
 void NewtonIntegrator::saveMaximaVelocity(const Body::id_t& id, State* state){
@@ -116,7 +139,10 @@ void NewtonIntegrator::action()
 	#endif
 
 	const bool trackEnergy(scene->trackEnergy);
+	// kinetic energy is only evaluated in steps where resettable energies are (see EnergyTracker::interval)
+	const bool trackKinetic(trackEnergy && !scene->energy->skipResettables);
 	const bool isPeriodic(scene->isPeriodic);
+	if(trackEnergy){ FOREACH(ThreadEnergy& E, threadEnergy) E.reset(); }
 
 	#ifdef YADE_OPENMP
 		FOREACH(Real& thrMaxVSq, threadMaxVelocitySq) { thrMaxVSq=0; }
@@ -124,6 +150,8 @@ void NewtonIntegrator::action()
 	YADE_PARALLEL_FOREACH_BODY_BEGIN(const shared_ptr<Body>& b, scene->bodies){
 			// clump members are handled inside clumps
 			if(b->isClumpMember()) continue;
+			// frozen by SleepingEngine
+			if(b->isSleeping()) continue;
 			State* state=b->state.get(); const Body::id_t& id=b->getId();
 			Vector3r f=Vector3r::Zero(); 
 			Vector3r m=Vector3r::Zero();
@@ -153,7 +181,7 @@ void NewtonIntegrator::action()
 			Vector3r fluctVel=isPeriodic?scene->cell->bodyFluctuationVel(b->state->pos,b->state->vel,prevVelGrad):state->vel;
 
 			// numerical damping & kinetic energy
-			if(trackEnergy) updateEnergy(b,state,fluctVel,f,m);
+			if(trackEnergy) updateEnergy(b,state,fluctVel,f,m,trackKinetic);
 
 			// whether to use aspherical rotation integration for this body; for no accelerations, spherical integrator is "exact" (and faster)
 			bool useAspherical=(exactAsphericalRot && b->isAspherical() && state->blockedDOFs!=State::DOF_ALL);
@@ -201,6 +229,7 @@ void NewtonIntegrator::action()
 	#ifdef YADE_OPENMP
 		FOREACH(const Real& thrMaxVSq, threadMaxVelocitySq) { maxVelocitySq=max(maxVelocitySq,thrMaxVSq); }
 	#endif
+	if(trackEnergy) reduceEnergy(trackKinetic);
 	if(scene->isPeriodic) { prevCellSize=scene->cell->getSize(); prevVelGrad=scene->cell->prevVelGrad=scene->cell->velGrad; }
 }
 
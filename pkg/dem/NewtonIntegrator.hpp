@@ -34,7 +34,13 @@ class NewtonIntegrator : public FieldApplier{
 	Vector3r computeAccel(const Vector3r& force, const Real& mass, int blockedDOFs);
 	Vector3r computeAngAccel(const Vector3r& torque, const Vector3r& inertia, int blockedDOFs);
 
-	void updateEnergy(const shared_ptr<Body>&b, const State* state, const Vector3r& fluctVel, const Vector3r& f, const Vector3r& m);
+	// energy terms accumulated by each thread and reduced into scene->energy once per step;
+	// vector does not align elements to cache lines, so the padding keeps used fields of adjacent threads more than a cache line (64 bytes) apart instead
+	struct ThreadEnergy{ Real nonviscDamp, kinTrans, kinRot, gravWork; bool damped; Real pad[8]; void reset(){ nonviscDamp=kinTrans=kinRot=gravWork=0; damped=false; } };
+	vector<ThreadEnergy> threadEnergy;
+	void updateEnergy(const shared_ptr<Body>&b, const State* state, const Vector3r& fluctVel, const Vector3r& f, const Vector3r& m, bool kinetic);
+	void reduceEnergy(bool kinetic);
+	void addEnergy(const ThreadEnergy& sum, bool kinetic);
 	#ifdef YADE_OPENMP
 	void ensureSync(); bool syncEnsured;
 	#endif
@@ -82,6 +88,9 @@ class NewtonIntegrator : public FieldApplier{
 			densityScaling=false;
 			#ifdef YADE_OPENMP
 				threadMaxVelocitySq.resize(omp_get_max_threads()); syncEnsured=false;
+				threadEnergy.resize(omp_get_max_threads());
+			#else
+				threadEnergy.resize(1);
 			#endif
 		,/*py*/
 		.add_property("densityScaling",&NewtonIntegrator::get_densityScaling,&NewtonIntegrator::set_densityScaling,"if True, then density scaling [Pfc3dManual30]_ will be applied in order to have a critical timestep equal to :yref:`GlobalStiffnessTimeStepper::targetDt` for all bodies. This option makes the simulation unrealistic from a dynamic point of view, but may speedup quasistatic simulations. In rare situations, it could be useful to not set the scalling factor automatically for each body (which the time-stepper does). In such case revert :yref:`GlobalStiffnessTimeStepper.densityScaling` to False.")
@@ -7,6 +7,7 @@
 *************************************************************************/
 #include"STLImporter.hpp"
 #include<pkg/dem/Shop.hpp>
+#include<pkg/dem/TriMesh.hpp>
 
 CREATE_LOGGER(STLImporter);
 
@@ -47,3 +48,23 @@ vector<shared_ptr<Body> > STLImporter::import(const char* filename)
 	return imported;
 }
 
+shared_ptr<Body> STLImporter::importMesh(const char* filename)
+{
+	vector<double> vtmp, ntmp; vector<int> etmp, ftmp;
+	STLReader reader; reader.tolerance=Mathr::ZERO_TOLERANCE;
+	if(!reader.open(filename, back_inserter(vtmp), back_inserter(etmp), back_inserter(ftmp), back_inserter(ntmp))) throw runtime_error(string("STLImporter: can't open file: ")+filename);
+	// the reader merges coincident vertices, so that neighbour triangles share them
+	shared_ptr<TriMesh> mesh(new TriMesh);
+	mesh->color=Vector3r(0.8,0.3,0.3);
+	Vector3r center=Vector3r::Zero();
+	for(size_t i=0; i+2<vtmp.size(); i+=3){ mesh->vertices.push_back(Vector3r(vtmp[i],vtmp[i+1],vtmp[i+2])); center+=mesh->vertices.back(); }
+	if(!mesh->vertices.empty()) center/=mesh->vertices.size();
+	FOREACH(Vector3r& v, mesh->vertices) v-=center;
+	for(size_t i=0; i+2<ftmp.size(); i+=3) mesh->triangles.push_back(Vector3i(ftmp[i],ftmp[i+1],ftmp[i+2]));
+	mesh->postLoad(*mesh);
+	shared_ptr<Body> b(new Body);
+	b->state->pos=b->state->refPos=center;
+	b->state->ori=b->state->refOri=Quaternionr::Identity();
+	b->shape=mesh;
+	return b;
+}
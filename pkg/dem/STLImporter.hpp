@@ -14,6 +14,8 @@
 class STLImporter {
     public:
 	vector<shared_ptr<Body> > import(const char*);
+	//! import the whole file as one body with TriMesh shape
+	shared_ptr<Body> importMesh(const char*);
 	DECLARE_LOGGER;
 };
 
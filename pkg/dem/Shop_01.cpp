@@ -37,6 +37,7 @@
 #include"pkg/common/Grid.hpp"
 
 #include"pkg/dem/Tetra.hpp"
+#include"pkg/dem/VoxelPorosity.hpp"
 
 #ifdef YADE_OPENGL
 	#include"pkg/common/Gl1_NormPhys.hpp"
@@ -158,6 +159,8 @@ Real Shop::unbalancedForce(bool useMaxForce, Scene* _rb){
 	Real sumF=0,maxF=0,currF; int nb=0;
 	FOREACH(const shared_ptr<Body>& b, *rb->bodies){
 		if(!b || b->isClumpMember() || !b->isDynamic()) continue;
+		// sleeping bodies are balanced within SleepingEngine.forceThreshold; forces of their frozen interactions are not summed
+		if(b->isSleeping()){ nb++; continue; }
 		currF=(rb->forces.getForce(b->id)+b->state->mass*gravity).norm();
 		if(b->isClump() && currF==0){ // this should not happen unless the function is called by an engine whose position in the loop is before Newton (with the exception of bodies which really have null force), because clumps forces are updated in Newton. Typical triaxial loops are using such ordering unfortunately (triaxEngine before Newton). So, here we make sure that they will get correct unbalance. In the future, it is better for optimality to check unbalancedF inside scripts at the end of loops, so that this "if" is never active.
 			Vector3r f(rb->forces.getForce(b->id)),m(Vector3r::Zero());
@@ -341,65 +344,18 @@ Real Shop::getVoxelPorosity(const shared_ptr<Scene>& _scene, int _resolution, Ve
 	if(_start==_end) throw std::invalid_argument("utils.voxelPorosity: cannot calculate porosity when start==end of the volume box.");
 	if(_resolution<50)     throw std::invalid_argument("utils.voxelPorosity: it doesn't make sense to calculate porosity with voxel resolution below 50.");
 
-	// prepare the gird, it eats a lot of memory.
-	// I am not optimizing for using bits. A single byte for each cell is used.
-	std::vector<std::vector<std::vector<unsigned char> > > grid;
-	int S(_resolution);
-	grid.resize(S);
-	for(int i=0 ; i<S ; ++i) {
-		grid[i].resize(S);
-		for(int j=0 ; j<S ; ++j) {
-			grid[i][j].resize(S,0);
-		}
-	}
-
-	Vector3r start(_start), size(_end - _start);
-	
-	FOREACH(shared_ptr<Body> bi, *scene->bodies){
-		if((bi)->isClump()) continue;
-		const shared_ptr<Body>& b = bi;
-		if ( b->isDynamic() || b->isClumpMember() ) {
-			const shared_ptr<Sphere>& sphere = YADE_PTR_CAST<Sphere> ( b->shape );
-			Real r       = sphere->radius;
-			Real rr      = r*r;
-			Vector3r pos = b->state->se3.position;
-			// we got sphere with radius r, at position pos.
-			// and a box of size S, scaled to 'size'
-			// mark cells that are iniside a sphere
-			int ii(0),II(S),jj(0),JJ(S),kk(0),KK(S);
-			// make sure to loop only in AABB of that sphere. No need to waste cycles outside of it.
-			ii = std::max((int)((Real)(pos[0]-start[0]-r)*(Real)(S)/(Real)(size[0]))-1,0); II = std::min(ii+(int)((Real)(2.0*r)*(Real)(S)/(Real)(size[0]))+3,S);
-			jj = std::max((int)((Real)(pos[1]-start[1]-r)*(Real)(S)/(Real)(size[1]))-1,0); JJ = std::min(jj+(int)((Real)(2.0*r)*(Real)(S)/(Real)(size[1]))+3,S);
-			kk = std::max((int)((Real)(pos[2]-start[2]-r)*(Real)(S)/(Real)(size[2]))-1,0); KK = std::min(kk+(int)((Real)(2.0*r)*(Real)(S)/(Real)(size[2]))+3,S);
-			for(int i=ii ; i<II ; ++i) {
-			for(int j=jj ; j<JJ ; ++j) {
-			for(int k=kk ; k<KK ; ++k) {
-				Vector3r a(i,j,k);
-				a = a/(Real)(S);
-				Vector3r b( a[0]*size[0] , a[1]*size[1] , a[2]*size[2] );
-				b = b+start;
-				Vector3r c(0,0,0);
-				c = pos-b;
-				Real x = c[0];
-				Real y = c[1];
-				Real z = c[2];
-				if(x*x+y*y+z*z < rr)
-					grid[i][j][k]=1;
-			}}}
-		}
-	}
-
-	Real Vv=0;
-	for(int i=0 ; i<S ; ++i ) {
-		for(int j=0 ; j<S ; ++j ) {
-			for(int k=0 ; k<S ; ++k ) {
-				if(grid[i][j][k]==1)
-					Vv += 1.0;
-			}
-		}
+	// the grid is sparse and bit-packed, see SphereVoxelGrid; only blocks touched by spheres use memory
+	vector<Vector3r> centers; vector<Real> radii;
+	FOREACH(const shared_ptr<Body>& b, *scene->bodies){
+		if(!b || b->isClump()) continue;
+		if(!(b->isDynamic() || b->isClumpMember())) continue;
+		const Sphere* sphere=dynamic_cast<Sphere*>(b->shape.get());
+		if(!sphere) continue;
+		centers.push_back(b->state->pos); radii.push_back(sphere->radius);
 	}
-
-	return ( std::pow(S,3) - Vv ) / std::pow(S,3);
+	SphereVoxelGrid grid(_start,_end,Vector3i(_resolution,_resolution,_resolution),/*partial*/false);
+	grid.rasterize(centers,radii);
+	return 1-grid.solidFractions(Vector3i(1,1,1))[0];
 };
 
 vector<boost::tuple<Vector3r,Real,int> > Shop::loadSpheresFromFile(const string& fname, Vector3r& minXYZ, Vector3r& maxXYZ, Vector3r* cellSize){
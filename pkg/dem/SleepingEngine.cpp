@@ -0,0 +1,136 @@
+// 2026 © Yade developers
+#include<pkg/dem/SleepingEngine.hpp>
+#include<pkg/dem/NewtonIntegrator.hpp>
+#include<pkg/common/InteractionLoop.hpp>
+#include<pkg/common/NormShearPhys.hpp>
+#include<core/Clump.hpp>
+#include<core/Omega.hpp>
+#include<core/Scene.hpp>
+
+YADE_PLUGIN((SleepingEngine));
+CREATE_LOGGER(SleepingEngine);
+
+Body::id_t SleepingEngine::findRoot(Body::id_t id){
+	while(parent[id]!=id){ parent[id]=parent[parent[id]]; id=parent[id]; }
+	return id;
+}
+
+Vector3r SleepingEngine::unitForce(const shared_ptr<Body>& b){
+	Vector3r f=scene->forces.getForce(b->id);
+	if(b->isClump()){
+		FOREACH(const Clump::MemberMap::value_type& m, YADE_PTR_CAST<Clump>(b->shape)->members) f+=scene->forces.getForce(m.first);
+	}
+	return f;
+}
+
+void SleepingEngine::setUnitSleeping(const shared_ptr<Body>& b, bool sleeping){
+	b->setSleeping(sleeping);
+	if(sleeping){ b->state->vel=b->state->angVel=Vector3r::Zero(); }
+	if(b->isClump()){
+		FOREACH(const Clump::MemberMap::value_type& m, YADE_PTR_CAST<Clump>(b->shape)->members){
+			const shared_ptr<Body>& member=Body::byId(m.first,scene);
+			member->setSleeping(sleeping);
+			if(sleeping){ member->state->vel=member->state->angVel=Vector3r::Zero(); }
+		}
+	}
+}
+
+void SleepingEngine::wakeAll(){
+	scene=Omega::instance().getScene().get();
+	FOREACH(const shared_ptr<Body>& b, *scene->bodies) if(b) b->setSleeping(false);
+	quietSteps.clear(); refForce.clear();
+	nSleeping=nSleepingIslands=0;
+}
+
+void SleepingEngine::renumberBodies(const std::vector<Body::id_t>& newIds){
+	if(quietSteps.empty()) return;
+	const long nNew=*std::max_element(newIds.begin(),newIds.end())+1;
+	vector<int> quiet(nNew,0); vector<Vector3r> ref(nNew,Vector3r::Constant(NaN));
+	for(size_t id=0; id<newIds.size() && id<quietSteps.size(); id++){
+		if(newIds[id]<0) continue;
+		quiet[newIds[id]]=quietSteps[id]; ref[newIds[id]]=refForce[id];
+	}
+	quietSteps.swap(quiet); refForce.swap(ref);
+}
+
+void SleepingEngine::action(){
+	scene->forces.sync();
+	Vector3r gravity=Vector3r::Zero();
+	FOREACH(const shared_ptr<Engine>& e, scene->engines){
+		if(NewtonIntegrator* newton=dynamic_cast<NewtonIntegrator*>(e.get())) gravity=newton->gravity;
+		if(InteractionLoop* loop=dynamic_cast<InteractionLoop*>(e.get())) loop->skipSleeping=!exact;
+	}
+	const shared_ptr<BodyContainer>& bodies=scene->bodies;
+	const long nBodies=bodies->size();
+	const Vector3r nanVec=Vector3r::Constant(NaN);
+	quietSteps.resize(nBodies,0); refForce.resize(nBodies,nanVec);
+	toWake.assign(nBodies,0); disturbed.assign(nBodies,0);
+	parent.resize(nBodies);
+	for(long id=0; id<nBodies; id++) parent[id]=id;
+
+	// mean contact force, and islands of dynamic bodies (clump members are represented by their clump)
+	Real sumF=0; long nF=0;
+	FOREACH(const shared_ptr<Interaction>& I, *scene->interactions){
+		if(!I->isReal()) continue;
+		const NormShearPhys* phys=dynamic_cast<NormShearPhys*>(I->phys.get());
+		if(phys){ sumF+=(phys->normalForce+phys->shearForce).norm(); nF++; }
+		const shared_ptr<Body>& b1=Body::byId(I->getId1(),scene); const shared_ptr<Body>& b2=Body::byId(I->getId2(),scene);
+		if(!b1 || !b2) continue;
+		const Body::id_t u1=(b1->isClumpMember()?b1->clumpId:b1->id), u2=(b2->isClumpMember()?b2->clumpId:b2->id);
+		if(!Body::byId(u1,scene)->isDynamic() || !Body::byId(u2,scene)->isDynamic()) continue;
+		const Body::id_t r1=findRoot(u1), r2=findRoot(u2);
+		if(r1!=r2) parent[max(r1,r2)]=min(r1,r2);
+	}
+	meanForce=(nF>0 ? sumF/nF : 0.);
+
+	// per-body criteria
+	long violations=0;
+	#ifdef YADE_OPENMP
+	#pragma omp parallel for schedule(guided) reduction(+:violations)
+	#endif
+	for(long id=0; id<nBodies; id++){
+		const shared_ptr<Body>& b=(*bodies)[id];
+		if(!b || b->isClumpMember() || !b->isDynamic()) continue;
+		const State* state=b->state.get();
+		const Vector3r f=unitForce(b);
+		if(b->isSleeping()){
+			// imposed motion
+			if(state->vel!=Vector3r::Zero() || state->angVel!=Vector3r::Zero()){ toWake[id]=1; continue; }
+			if(exact){
+				if((f+state->mass*gravity).norm()>exactTolerance*meanForce){ toWake[id]=1; violations++; }
+			} else {
+				// the first force after falling asleep (without the frozen interactions) is the reference
+				if(isnan(refForce[id][0])) refForce[id]=f;
+				else if((f-refForce[id]).norm()>wakeForceRatio*meanForce) toWake[id]=1;
+			}
+		} else {
+			bool quiet=(state->vel.norm()<velThreshold && state->angVel.norm()<angVelThreshold && (f+state->mass*gravity).norm()<=forceThreshold*meanForce);
+			quietSteps[id]=(quiet ? quietSteps[id]+1 : 0);
+		}
+	}
+	if(violations>0) LOG_WARN("Iteration "<<scene->iter<<": "<<violations<<" sleeping bodies above exactTolerance, waking them up.");
+	nViolations+=violations;
+
+	// per-island decision, stored at the root of the island: 0 all members may sleep, 1 some member is disturbed
+	nIslands=0;
+	for(long id=0; id<nBodies; id++){
+		const shared_ptr<Body>& b=(*bodies)[id];
+		if(!b || b->isClumpMember() || !b->isDynamic()) continue;
+		const Body::id_t root=findRoot(id);
+		if(root==id) nIslands++;
+		if(b->isSleeping() ? toWake[id] : quietSteps[id]<nQuiet) disturbed[root]=1;
+	}
+	nSleepingIslands=0; nSleeping=nFellAsleep=nWoken=0;
+	for(long id=0; id<nBodies; id++){
+		const shared_ptr<Body>& b=(*bodies)[id];
+		if(!b || b->isClumpMember() || !b->isDynamic()) continue;
+		const Body::id_t root=findRoot(id);
+		if(disturbed[root]){
+			if(b->isSleeping()){ setUnitSleeping(b,false); quietSteps[id]=0; nWoken++; }
+			continue;
+		}
+		if(!b->isSleeping()){ setUnitSleeping(b,true); refForce[id]=nanVec; nFellAsleep++; }
+		nSleeping++;
+		if(root==id) nSleepingIslands++;
+	}
+}
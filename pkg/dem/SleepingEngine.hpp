@@ -0,0 +1,45 @@
+// 2026 © Yade developers
+#pragma once
+#include<core/GlobalEngine.hpp>
+#include<core/Body.hpp>
+
+class SleepingEngine: public GlobalEngine {
+	// per-body data, indexed by id (clump members use their clump's entry)
+	vector<int> quietSteps;
+	vector<Vector3r> refForce;
+	vector<char> toWake;
+	vector<char> disturbed; // indexed by root of island
+	// union-find of bodies in contact
+	vector<Body::id_t> parent;
+	Body::id_t findRoot(Body::id_t id);
+	Vector3r unitForce(const shared_ptr<Body>& b);
+	void setUnitSleeping(const shared_ptr<Body>& b, bool sleeping);
+	public:
+		virtual void action();
+		virtual void renumberBodies(const std::vector<Body::id_t>& newIds);
+		void wakeAll();
+	DECLARE_LOGGER;
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(SleepingEngine,GlobalEngine,
+		"Put to sleep islands of quiescent bodies, and wake them up when disturbed. Bodies (and clumps) are quiescent if their velocity is below :yref:`velThreshold<SleepingEngine.velThreshold>`, angular velocity below :yref:`angVelThreshold<SleepingEngine.angVelThreshold>` and unbalanced force (including gravity of :yref:`NewtonIntegrator`) below :yref:`forceThreshold<SleepingEngine.forceThreshold>` times the mean contact force. Islands are sets of dynamic bodies connected by real interactions (non-dynamic bodies, such as walls, do not connect islands); an island falls asleep when all its bodies have been quiescent for :yref:`nQuiet<SleepingEngine.nQuiet>` steps.\n\n\
+		Sleeping bodies (see :yref:`Body.sleeping`) have zero velocity and are skipped by :yref:`NewtonIntegrator` and :yref:`BoundDispatcher`; interactions between two sleeping bodies are skipped by :yref:`InteractionLoop`. An island wakes up when one of its bodies gets a new contact with an awake dynamic body, when velocity is imposed on one of its bodies (e.g. by a kinematic engine), or when the force on one of its bodies (now coming from awake neighbours and non-dynamic bodies only) changes by more than :yref:`wakeForceRatio<SleepingEngine.wakeForceRatio>` times the mean contact force.\n\n\
+		With :yref:`exact<SleepingEngine.exact>`, frozen interactions are still evaluated (bodies are not moved); islands whose unbalanced force would exceed :yref:`exactTolerance<SleepingEngine.exactTolerance>` are reported in :yref:`nViolations<SleepingEngine.nViolations>` and woken up. This is meant to check that the thresholds are safe for given simulation.\n\n\
+		The engine must run every step, between kinematic engines and :yref:`NewtonIntegrator` (i.e. after :yref:`InteractionLoop`). Interactions must have :yref:`NormShearPhys`. :yref:`Shop.unbalancedForce<yade._utils.unbalancedForce>` counts sleeping bodies as balanced.",
+		((Real,velThreshold,1e-4,,"Maximum velocity of quiescent bodies."))
+		((Real,angVelThreshold,1e-3,,"Maximum angular velocity of quiescent bodies."))
+		((Real,forceThreshold,1e-2,,"Maximum unbalanced force of quiescent bodies, relative to the mean contact force."))
+		((int,nQuiet,100,,"Number of consecutive quiescent steps after which an island falls asleep."))
+		((Real,wakeForceRatio,.1,,"Change of force on a sleeping body, relative to the mean contact force, which wakes its island up."))
+		((bool,exact,false,,"Evaluate frozen interactions and check unbalanced force of sleeping bodies against :yref:`exactTolerance<SleepingEngine.exactTolerance>`."))
+		((Real,exactTolerance,5e-2,,"Maximum unbalanced force of sleeping bodies (relative to the mean contact force) in :yref:`exact<SleepingEngine.exact>` mode."))
+		((long,nSleeping,0,Attr::readonly,"Number of sleeping bodies (clumps count as one) after the last step."))
+		((long,nIslands,0,Attr::readonly,"Number of islands after the last step."))
+		((long,nSleepingIslands,0,Attr::readonly,"Number of sleeping islands after the last step."))
+		((long,nFellAsleep,0,Attr::readonly,"Number of bodies put to sleep in the last step."))
+		((long,nWoken,0,Attr::readonly,"Number of bodies woken up in the last step."))
+		((long,nViolations,0,Attr::readonly,"Total number of sleeping bodies found above :yref:`exactTolerance<SleepingEngine.exactTolerance>` in :yref:`exact<SleepingEngine.exact>` mode."))
+		((Real,meanForce,0,Attr::readonly,"Mean contact force in the last step."))
+		,/*ctor*/
+		,/*py*/ .def("wakeAll",&SleepingEngine::wakeAll,"Wake all bodies of the current scene up.")
+	);
+};
+REGISTER_SERIALIZABLE(SleepingEngine);
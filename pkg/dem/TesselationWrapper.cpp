@@ -17,103 +17,42 @@
 YADE_PLUGIN((TesselationWrapper));
 CREATE_LOGGER(TesselationWrapper);
 
-//spatial sort traits to use with a pair of CGAL::sphere pointers and integer.
-//template<class _Triangulation>
-struct RTraits_for_spatial_sort : public CGT::SimpleTriangulationTypes::RTriangulation::Geom_traits {
-	//typedef typename _Triangulation::Geom_traits Gt;
-	typedef CGT::SimpleTriangulationTypes::RTriangulation::Geom_traits Gt;
-	typedef std::pair<const CGT::Sphere*,Body::id_t> Point_3;
-
-	struct Less_x_3 {
-		bool operator()(const Point_3& p,const Point_3& q) const {
-			return Gt::Less_x_3()(* (p.first),* (q.first));
-		}
-	};
-	struct Less_y_3 {
-		bool operator()(const Point_3& p,const Point_3& q) const {
-			return Gt::Less_y_3()(* (p.first),* (q.first));
-		}
-	};
-	struct Less_z_3 {
-		bool operator()(const Point_3& p,const Point_3& q) const {
-			return Gt::Less_z_3()(* (p.first),* (q.first));
-		}
-	};
-	Less_x_3  less_x_3_object() const {return Less_x_3();}
-	Less_y_3  less_y_3_object() const {return Less_y_3();}
-	Less_z_3  less_z_3_object() const {return Less_z_3();}
-};
-
-
 //function inserting points into a triangulation (where YADE::Sphere is converted to CGT::Sphere)
 //and setting the info field to the bodies id.
-//Possible improvements : use bodies pointers to avoid one copy, use aabb's lists to replace the shuffle/sort part
 // template <class Triangulation>
 void build_triangulation_with_ids(const shared_ptr<BodyContainer>& bodies, TesselationWrapper &TW, bool reset=true)
 {
 	if (reset) TW.clear();
-	typedef SimpleTesselation::RTriangulation RTriangulation; 
 	SimpleTesselation& Tes = *(TW.Tes);
-	RTriangulation& T = Tes.Triangulation();
 	std::vector<CGT::Sphere> spheres;
-	std::vector<std::pair<const CGT::Sphere*,Body::id_t> > pointsPtrs;
+	std::vector<unsigned int> ids;
 	spheres.reserve(bodies->size());
-	pointsPtrs.reserve(bodies->size());
+	ids.reserve(bodies->size());
 
 	BodyContainer::iterator biBegin    = bodies->begin();
 	BodyContainer::iterator biEnd = bodies->end();
 	BodyContainer::iterator bi = biBegin;
 
 	Body::id_t Ng = 0;
-	Body::id_t& MaxId=Tes.maxId;
 	TW.mean_radius = 0;
 
 	shared_ptr<Sphere> sph (new Sphere);
 	int Sph_Index = sph->getClassIndexStatic();
 	for (; bi!=biEnd ; ++bi) {
 		if ( (*bi)->shape->getClassIndex() ==  Sph_Index ) {
-// 		if ((*bi)->isDynamic()) { //then it is a sphere (not a wall) FIXME : need test if isSphere
 			const Sphere* s = YADE_CAST<Sphere*> ((*bi)->shape.get());
 			const Vector3r& pos = (*bi)->state->pos;
 			const Real rad = s->radius;
-			CGT::Sphere sp(CGT::Point(pos[0],pos[1],pos[2]),rad*rad);
-			spheres.push_back(sp);
-			pointsPtrs.push_back(std::make_pair(&(spheres[Ng]/*.point()*/),(*bi)->getId()));
+			spheres.push_back(CGT::Sphere(CGT::Point(pos[0],pos[1],pos[2]),rad*rad));
+			ids.push_back((*bi)->getId());
 			TW.Pmin = CGT::Point(min(TW.Pmin.x(),pos.x()-rad),min(TW.Pmin.y(), pos.y()-rad),min(TW.Pmin.z(), pos.z()-rad));
 			TW.Pmax = CGT::Point(max(TW.Pmax.x(),pos.x()+rad),max(TW.Pmax.y(),pos.y()+rad),max(TW.Pmax.z(),pos.z()+rad));
 			Ng++; TW.mean_radius += rad;
-			MaxId = max(MaxId,(*bi)->getId());
 		}
 	}
 	TW.mean_radius /= Ng; TW.rad_divided = true;
-	spheres.resize(Ng);
-	pointsPtrs.resize(Ng);
-	Tes.vertexHandles.resize(MaxId+1);
 	Tes.redirected = 1;
-	std::random_shuffle(pointsPtrs.begin(), pointsPtrs.end());
-	spatial_sort(pointsPtrs.begin(),pointsPtrs.end(), RTraits_for_spatial_sort()/*, CGT::RTriangulation::Weighted_point*/);
-
-	RTriangulation::Cell_handle hint;
-
-	TW.n_spheres = 0;
-	for (std::vector<std::pair<const CGT::Sphere*,Body::id_t> >::const_iterator
-			p = pointsPtrs.begin();p != pointsPtrs.end(); ++p) {
-		RTriangulation::Locate_type lt;
-		RTriangulation::Cell_handle c;
-		int li, lj;
-		c = T.locate(* (p->first), lt, li, lj, hint);
-		RTriangulation::Vertex_handle v = T.insert(*(p->first),lt,c,li,lj);
-		if (v==RTriangulation::Vertex_handle())
-			hint=c;
-		else {
-			v->info().setId((const unsigned int) p->second);
-			//Vh->info().isFictious = false;//false is the default
-			Tes.maxId = std::max(Tes.maxId,(int) p->second);
-			Tes.vertexHandles[p->second]=v;
-			hint=v->cell();
-			++TW.n_spheres;
-		}
-	}
+	TW.n_spheres = Tes.insertSpheres(spheres,ids);
 	//cerr << " loaded : " << Ng<<", triangulated : "<<TW.n_spheres<<", mean radius = " << TW.mean_radius<<endl;
 }
 
@@ -291,15 +230,19 @@ void TesselationWrapper::loadState (string filename, bool stateNumber, bool bz2)
 	TS.from_file(filename.c_str(),bz2);
 }
 
-void TesselationWrapper::saveState (string filename, bool stateNumber, bool bz2){
+void TesselationWrapper::saveState (string filename, bool stateNumber, bool bz2, bool binary){
 	CGT::TriaxialState& TS = stateNumber? *(mma.analyser->TS1) :*( mma.analyser->TS0);
-	TS.to_file(filename.c_str(),bz2);
+	TS.to_file(filename.c_str(),bz2,binary);
 }
 
 void TesselationWrapper::defToVtkFromStates (string inputFile1, string inputFile2, string outputFile, bool bz2){
 	mma.analyser->DefToFile(inputFile1.c_str(),inputFile2.c_str(),outputFile.c_str(),bz2);
 }
 
+int TesselationWrapper::defToVtkFromStateSequence (string baseName, int first, int last, int step, string outputBase, bool bz2){
+	return mma.analyser->DefToFileSequence(baseName.c_str(),first,last,step,outputBase.c_str(),bz2);
+}
+
 void createSphere(shared_ptr<Body>& body, Vector3r position, Real radius, bool big, bool dynamic )
 {
 	body = shared_ptr<Body>(new Body); body->groupMask=2;
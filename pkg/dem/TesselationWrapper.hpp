@@ -94,10 +94,11 @@ public:
 	/// make the current state the initial (0) or final (1) configuration for the definition of displacement increments, use only state=0 if you just want to get only volmumes and porosity
 	void setState (bool state=0);
 	void loadState (string fileName, bool stateNumber=0, bool bz2=false);
-	void saveState (string fileName, bool stateNumber=0, bool bz2=false);
+	void saveState (string fileName, bool stateNumber=0, bool bz2=false, bool binary=false);
 	/// read two state files and write per-particle deformation to a vtk file. The second variant uses existing states.
  	void defToVtkFromStates (string inputFile1, string inputFile2, string outputFile="def.vtk", bool bz2=false);
 	void defToVtkFromPositions (string inputFile1, string inputFile2, string outputFile="def.vtk", bool bz2=false);
+	int defToVtkFromStateSequence (string baseName, int first, int last, int step=1, string outputBase="def", bool bz2=false);
 	void defToVtk (string outputFile="def.vtk");
 
 	/// return python array containing voronoi volumes, per-particle porosity, and optionaly per-particle deformation, if states 0 and 1 have been assigned
@@ -125,10 +126,11 @@ public:
 	.def("triangulate",&TesselationWrapper::insertSceneSpheres,(boost::python::arg("reset")=true),"triangulate spheres of the packing")
  	.def("setState",&TesselationWrapper::setState,(boost::python::arg("state")=0),"Make the current state of the simulation the initial (0) or final (1) configuration for the definition of displacement increments, use only state=0 if you just want to get  volmumes and porosity.")
  	.def("loadState",&TesselationWrapper::loadState,(boost::python::arg("inputFile")="state",boost::python::arg("state")=0,boost::python::arg("bz2")=true),"Load a file with positions to define state 0 or 1.")
- 	.def("saveState",&TesselationWrapper::saveState,(boost::python::arg("outputFile")="state",boost::python::arg("state")=0,boost::python::arg("bz2")=true),"Save a file with positions, can be later reloaded in order to define state 0 or 1.")
+ 	.def("saveState",&TesselationWrapper::saveState,(boost::python::arg("outputFile")="state",boost::python::arg("state")=0,boost::python::arg("bz2")=true,boost::python::arg("binary")=false),"Save a file with positions, can be later reloaded in order to define state 0 or 1. Binary files are much faster to load (both formats are recognized by :yref:`loadState<TesselationWrapper.loadState>`).")
  	.def("volume",&TesselationWrapper::Volume,(boost::python::arg("id")=0),"Returns the volume of Voronoi's cell of a sphere.")
  	.def("defToVtk",&TesselationWrapper::defToVtk,(boost::python::arg("outputFile")="def.vtk"),"Write local deformations in vtk format from states 0 and 1.")
  	.def("defToVtkFromStates",&TesselationWrapper::defToVtkFromStates,(boost::python::arg("input1")="state1",boost::python::arg("input2")="state2",boost::python::arg("outputFile")="def.vtk",boost::python::arg("bz2")=true),"Write local deformations in vtk format from state files (since the file format is very special, consider using defToVtkFromPositions if the input files were not generated by TesselationWrapper).")
+ 	.def("defToVtkFromStateSequence",&TesselationWrapper::defToVtkFromStateSequence,(boost::python::arg("baseName")="state",boost::python::arg("first")=0,boost::python::arg("last")=1,boost::python::arg("step")=1,boost::python::arg("outputBase")="def",boost::python::arg("bz2")=true),"Write local deformations of the increments between state files baseName+first, baseName+(first+step), ..., baseName+last to outputBase+n.vtk. Each state file is read only once and the next one is loaded while the current increment is processed. Returns the number of files written.")
  	.def("defToVtkFromPositions",&TesselationWrapper::defToVtkFromPositions,(boost::python::arg("input1")="pos1",boost::python::arg("input2")="pos2",boost::python::arg("outputFile")="def.vtk",boost::python::arg("bz2")=false),"Write local deformations in vtk format from positions files (one sphere per line, with x,y,z,rad separated by spaces).")
  	.def("computeVolumes",&TesselationWrapper::computeVolumes,"compute volumes of all Voronoi's cells.")
 	.def("getVolPoroDef",&TesselationWrapper::getVolPoroDef,(boost::python::arg("deformation")=false),"Return a table with per-sphere computed quantities. Include deformations on the increment defined by states 0 and 1 if deformation=True (make sure to define states 0 and 1 consistently).")
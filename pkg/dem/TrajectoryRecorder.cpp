@@ -0,0 +1,151 @@
+// 2026 © Yade developers
+#include<pkg/dem/TrajectoryRecorder.hpp>
+#include<pkg/common/Sphere.hpp>
+#include<core/Scene.hpp>
+#include<boost/iostreams/filtering_stream.hpp>
+#include<boost/iostreams/filter/zlib.hpp>
+#include<boost/iostreams/device/back_inserter.hpp>
+#include<boost/filesystem.hpp>
+#include<fstream>
+#include<cstring>
+
+YADE_PLUGIN((TrajectoryRecorder));
+CREATE_LOGGER(TrajectoryRecorder);
+
+namespace {
+	const char fileMagic[8]={'Y','A','D','E','T','R','J','1'};
+	const char frameMagic[4]={'F','R','M','1'};
+	enum { FILE_FLOAT32=1 };
+	enum { FRAME_ZLIB=1, FRAME_XOR=2 };
+	template<typename T> void writeBin(std::ostream& out, const T& v){ out.write((const char*)&v,sizeof(T)); }
+	template<typename T> T readBin(std::istream& in){ T v; in.read((char*)&v,sizeof(T)); return v; }
+	// store one value as double or float at position i of the raw column
+	inline void put(char* raw, size_t i, Real v, bool f32){
+		if(f32){ float f=(float)v; memcpy(raw+i*sizeof(float),&f,sizeof(float)); }
+		else { double d=(double)v; memcpy(raw+i*sizeof(double),&d,sizeof(double)); }
+	}
+	string zlibCompress(const string& raw){
+		string ret;
+		boost::iostreams::filtering_ostream out;
+		out.push(boost::iostreams::zlib_compressor());
+		out.push(boost::iostreams::back_inserter(ret));
+		out.write(raw.data(),raw.size());
+		out.reset(); // flushes the compressor
+		return ret;
+	}
+}
+
+int TrajectoryRecorder::numComponents(const string& c){
+	if(c=="pos" || c=="vel" || c=="angVel" || c=="force" || c=="torque") return 3;
+	if(c=="ori") return 4;
+	if(c=="radius") return 1;
+	throw std::invalid_argument("TrajectoryRecorder: unknown column `"+c+"' (supported are: pos, vel, angVel, ori, force, torque, radius).");
+}
+
+void TrajectoryRecorder::writeHeader(std::ostream& out){
+	out.write(fileMagic,8);
+	writeBin<uint32_t>(out,1);
+	writeBin<uint32_t>(out,float32?FILE_FLOAT32:0);
+	writeBin<uint32_t>(out,columns.size());
+	FOREACH(const string& c, columns){
+		char name[16]; memset(name,0,16); strncpy(name,c.c_str(),15);
+		out.write(name,16);
+		writeBin<uint32_t>(out,numComponents(c));
+	}
+}
+
+void TrajectoryRecorder::checkHeader(std::istream& in){
+	char magic[8]; in.read(magic,8);
+	if(!in || memcmp(magic,fileMagic,8)!=0) throw std::runtime_error("TrajectoryRecorder: "+fileName+" exists and is not a trajectory file.");
+	readBin<uint32_t>(in); // version
+	bool f32=(readBin<uint32_t>(in) & FILE_FLOAT32);
+	vector<string> cols(readBin<uint32_t>(in));
+	for(size_t i=0; i<cols.size(); i++){ char name[17]; name[16]=0; in.read(name,16); cols[i]=name; readBin<uint32_t>(in); }
+	if(f32!=float32 || cols!=columns) throw std::runtime_error("TrajectoryRecorder: "+fileName+" was written with different columns or precision, cannot append.");
+}
+
+void TrajectoryRecorder::action(){
+	if(fileName.empty()) throw std::runtime_error("TrajectoryRecorder.fileName must be given.");
+	FOREACH(const string& c, columns) numComponents(c); // check names before writing anything
+	vector<Body::id_t> ids; ids.reserve(scene->bodies->size());
+	FOREACH(const shared_ptr<Body>& b, *scene->bodies){
+		if(!b || (mask!=0 && !b->maskCompatible(mask))) continue;
+		ids.push_back(b->getId());
+	}
+	const long n=ids.size();
+	const size_t valSize=float32?sizeof(float):sizeof(double);
+	bool needForces=false;
+	FOREACH(const string& c, columns) if(c=="force" || c=="torque") needForces=true;
+	if(needForces) scene->forces.sync();
+
+	// raw columns: ids first, then requested quantities
+	vector<string> raw(columns.size()+1);
+	if(n>0) raw[0].assign((const char*)&ids[0],(const char*)&ids[0]+n*sizeof(Body::id_t));
+	const int sphereIndex=Sphere::getClassIndexStatic();
+	for(size_t c=0; c<columns.size(); c++){
+		const string& col=columns[c];
+		const int nc=numComponents(col);
+		raw[c+1].resize(n*nc*valSize);
+		char* data=&raw[c+1][0];
+		const int what= col=="pos"?0 : col=="vel"?1 : col=="angVel"?2 : col=="ori"?3 : col=="force"?4 : col=="torque"?5 : 6;
+		#ifdef YADE_OPENMP
+		#pragma omp parallel for schedule(static)
+		#endif
+		for(long i=0; i<n; i++){
+			const Body* b=(*scene->bodies)[ids[i]].get();
+			const State* s=b->state.get();
+			switch(what){
+				case 0: for(int k=0; k<3; k++) put(data,3*i+k,s->pos[k],float32); break;
+				case 1: for(int k=0; k<3; k++) put(data,3*i+k,s->vel[k],float32); break;
+				case 2: for(int k=0; k<3; k++) put(data,3*i+k,s->angVel[k],float32); break;
+				case 3: put(data,4*i,s->ori.w(),float32); for(int k=0; k<3; k++) put(data,4*i+1+k,s->ori.vec()[k],float32); break;
+				case 4: { const Vector3r& f=scene->forces.getForce(ids[i]); for(int k=0; k<3; k++) put(data,3*i+k,f[k],float32); } break;
+				case 5: { const Vector3r& t=scene->forces.getTorque(ids[i]); for(int k=0; k<3; k++) put(data,3*i+k,t[k],float32); } break;
+				default: put(data,i,(b->shape && b->shape->getClassIndex()==sphereIndex)?static_cast<const Sphere*>(b->shape.get())->radius:0.,float32);
+			}
+		}
+	}
+
+	// delta encoding against the previous frame, if the same bodies are recorded
+	uint32_t frameFlags=0;
+	vector<string> stored;
+	if(keyframeInterval>0 && prevNum==n && framesSinceKey<keyframeInterval && prevRaw.size()==raw.size() && prevRaw[0]==raw[0]){
+		// the previous frame is not needed anymore, xor into it in-place
+		for(size_t c=0; c<raw.size(); c++){
+			string& p=prevRaw[c]; const string& s=raw[c];
+			for(size_t j=0; j<p.size(); j++) p[j]^=s[j];
+		}
+		stored.swap(prevRaw);
+		frameFlags|=FRAME_XOR; framesSinceKey++;
+	} else {
+		framesSinceKey=1;
+		// keyframes are kept as reference for the next frames
+		if(keyframeInterval>0) stored=raw; else stored.swap(raw);
+	}
+	if(keyframeInterval>0){ prevRaw.swap(raw); prevNum=n; }
+	if(compress){
+		#ifdef YADE_OPENMP
+		#pragma omp parallel for schedule(dynamic)
+		#endif
+		for(long c=0; c<(long)stored.size(); c++) stored[c]=zlibCompress(stored[c]);
+		frameFlags|=FRAME_ZLIB;
+	}
+
+	bool exists=boost::filesystem::exists(fileName) && boost::filesystem::file_size(fileName)>0;
+	if(exists){ std::ifstream in(fileName.c_str(),std::ios::binary); checkHeader(in); }
+	std::ofstream out(fileName.c_str(),std::ios::binary|std::ios::app);
+	if(!out) throw std::runtime_error("TrajectoryRecorder: unable to open "+fileName+" for writing.");
+	if(!exists) writeHeader(out);
+	out.flush();
+	const int64_t offset=boost::filesystem::file_size(fileName);
+	out.write(frameMagic,4);
+	writeBin<uint32_t>(out,frameFlags);
+	writeBin<int64_t>(out,scene->iter);
+	writeBin<double>(out,scene->time);
+	writeBin<int64_t>(out,n);
+	FOREACH(const string& s, stored){ writeBin<uint64_t>(out,s.size()); out.write(s.data(),s.size()); }
+	out.close();
+	std::ofstream idx((fileName+".idx").c_str(),std::ios::binary|std::ios::app);
+	writeBin<int64_t>(idx,offset); writeBin<int64_t>(idx,scene->iter); writeBin<double>(idx,scene->time);
+	nFrames++;
+}
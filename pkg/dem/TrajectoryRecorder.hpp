@@ -0,0 +1,38 @@
+// 2026 © Yade developers
+#pragma once
+#include<pkg/common/PeriodicEngines.hpp>
+
+/* Binary trajectory file (all numbers little-endian, as written by the machine):
+
+	header: "YADETRJ1", uint32 version(=1), uint32 flags (1: float32 values), uint32 number of columns,
+	        for each column: char[16] name (NUL-padded), uint32 number of components
+	frames: "FRM1", uint32 flags (1: zlib-compressed columns, 2: columns XOR-ed with the previous frame),
+	        int64 iteration, float64 time, int64 number of bodies,
+	        then for the id column (int32) and every column: uint64 number of stored bytes, bytes
+
+Columns are stored as contiguous arrays (structure of arrays). The index file (fileName.idx) has one record per frame:
+int64 frame offset in the trajectory file, int64 iteration, float64 time. It is read by yade.trajectory.
+*/
+class TrajectoryRecorder: public PeriodicEngine{
+	// raw (uncompressed, non-XOR-ed) columns of the last frame, for delta encoding
+	vector<string> prevRaw;
+	long prevNum;
+	int framesSinceKey;
+	void writeHeader(std::ostream& out);
+	void checkHeader(std::istream& in);
+	public:
+		virtual void action();
+		static int numComponents(const string& column);
+	DECLARE_LOGGER;
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR(TrajectoryRecorder,PeriodicEngine,"Append body data (positions, velocities, ...) of each run to a compact binary trajectory file, which can be read efficiently (memory-mapped into numpy arrays) with :yref:`yade.trajectory.Trajectory`. The format (described in :ysrc:`pkg/dem/TrajectoryRecorder.hpp`) is append-only, stores each quantity as a contiguous column and keeps an index of frames for random access.",
+		((string,fileName,"",,"Trajectory file; the index is written to the same name with ``.idx`` appended. If the file exists, frames are appended to it (its columns and precision must match)."))
+		((vector<string>,columns,vector<string>(1,"pos"),,"Recorded quantities, any of ``pos``, ``vel``, ``angVel``, ``ori`` (quaternion as w,x,y,z), ``force``, ``torque``, ``radius`` (0 for non-spheres). Body ids are always recorded."))
+		((bool,float32,false,,"Store values in single precision (halves the size, positions lose precision beyond ~7 digits)."))
+		((bool,compress,false,,"Compress columns with zlib. Compressed frames cannot be memory-mapped, the reader decompresses them."))
+		((int,keyframeInterval,0,,"If positive, columns are XOR-ed with the previous frame (when the set of bodies did not change), which makes slowly changing data compress much better; every *keyframeInterval*-th frame is stored in full, which bounds the number of frames to decode for random access. Only useful with :yref:`compress<TrajectoryRecorder.compress>`."))
+		((int,mask,0,,"If non-zero, only bodies with matching :yref:`groupMask<Body.groupMask>` are recorded."))
+		((long,nFrames,0,Attr::readonly,"Number of frames written by this engine."))
+		,/*ctor*/ prevNum=-1; framesSinceKey=0; initRun=true;
+	);
+};
+REGISTER_SERIALIZABLE(TrajectoryRecorder);
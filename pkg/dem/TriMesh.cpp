@@ -0,0 +1,225 @@
+// 2026 © Yade developers
+#include"TriMesh.hpp"
+#include<pkg/dem/ScGeom.hpp>
+#include<core/Scene.hpp>
+#include<pkg/common/InteractionLoop.hpp>
+
+YADE_PLUGIN((TriMesh)(Bo1_TriMesh_Aabb)(Ig2_TriMesh_Sphere_ScGeom)(Ig2_TriMesh_Sphere_ScGeom6D)
+	#ifdef YADE_OPENGL
+		(Gl1_TriMesh)
+	#endif
+);
+CREATE_LOGGER(TriMesh);
+
+void TriMesh::postLoad(TriMesh&){
+	// triangles may be assigned before vertices (e.g. from python keyword arguments)
+	if(vertices.empty()){ nodes.clear(); return; }
+	FOREACH(const Vector3i& t, triangles){
+		for(int i=0; i<3; i++) if(t[i]<0 || t[i]>=(int)vertices.size()) throw std::invalid_argument("TriMesh: triangle refers to vertex #"+boost::lexical_cast<string>(t[i])+", but there are only "+boost::lexical_cast<string>(vertices.size())+" vertices.");
+	}
+	buildBvh();
+}
+
+namespace {
+	// orders triangles by their centroid coordinate along one axis
+	struct CentroidLess{
+		const vector<Vector3r>& centroids; int ax;
+		CentroidLess(const vector<Vector3r>& _centroids, int _ax): centroids(_centroids), ax(_ax){}
+		bool operator()(int a, int b) const { return centroids[a][ax]<centroids[b][ax]; }
+	};
+	// range of triangles to be made into a node of the hierarchy, with its parent node
+	struct BvhRange{ int first, count, parent; BvhRange(int _first, int _count, int _parent): first(_first), count(_count), parent(_parent){} };
+}
+
+void TriMesh::buildBvh(){
+	nodes.clear(); order.resize(triangles.size());
+	if(triangles.empty()) return;
+	vector<Vector3r> centroids(triangles.size());
+	for(size_t t=0; t<triangles.size(); t++){ order[t]=t; centroids[t]=(vertices[triangles[t][0]]+vertices[triangles[t][1]]+vertices[triangles[t][2]])/3.; }
+	nodes.reserve(2*triangles.size()/max(1,leafSize)+1);
+	vector<BvhRange> stack(1,BvhRange(0,triangles.size(),-1));
+	while(!stack.empty()){
+		BvhRange r=stack.back(); stack.pop_back();
+		Node n; n.left=n.right=-1; n.first=r.first; n.count=r.count;
+		AlignedBox3r cbox;
+		for(int i=r.first; i<r.first+r.count; i++){
+			for(int j=0; j<3; j++) n.box.extend(vertices[triangles[order[i]][j]]);
+			cbox.extend(centroids[order[i]]);
+		}
+		int id=nodes.size(); nodes.push_back(n);
+		if(r.parent>=0){ Node& p=nodes[r.parent]; (p.left<0 ? p.left : p.right)=id; }
+		if(r.count<=leafSize) continue;
+		// split at the median centroid along the longest axis of centroids' box
+		int ax; cbox.sizes().maxCoeff(&ax);
+		int half=r.count/2;
+		std::nth_element(order.begin()+r.first,order.begin()+r.first+half,order.begin()+r.first+r.count,CentroidLess(centroids,ax));
+		// right is pushed first so that left is processed (and linked) first
+		stack.push_back(BvhRange(r.first+half,r.count-half,id));
+		stack.push_back(BvhRange(r.first,half,id));
+		nodes[id].count=0;
+	}
+}
+
+void TriMesh::trianglesNear(const Vector3r& p, Real dist, vector<int>& out) const {
+	if(nodes.empty()) return;
+	Real dist2=pow(dist,2);
+	int stack[64]; int top=0; stack[top++]=0;
+	while(top>0){
+		const Node& n=nodes[stack[--top]];
+		if(n.box.squaredExteriorDistance(p)>dist2) continue;
+		if(n.left<0){ for(int i=n.first; i<n.first+n.count; i++) out.push_back(order[i]); continue; }
+		assert(top<62);
+		stack[top++]=n.right; stack[top++]=n.left;
+	}
+}
+
+int TriMesh::closestPoint(int t, const Vector3r& p, Vector3r& closest, int feature[3]) const {
+	// Ericson, Real-Time Collision Detection, 5.1.5: find Voronoi region of p
+	const Vector3i& tri=triangles[t];
+	const Vector3r& a=vertices[tri[0]]; const Vector3r& b=vertices[tri[1]]; const Vector3r& c=vertices[tri[2]];
+	Vector3r ab=b-a, ac=c-a, ap=p-a;
+	Real d1=ab.dot(ap), d2=ac.dot(ap);
+	if(d1<=0 && d2<=0){ closest=a; feature[0]=tri[0]; return 1; }
+	Vector3r bp=p-b;
+	Real d3=ab.dot(bp), d4=ac.dot(bp);
+	if(d3>=0 && d4<=d3){ closest=b; feature[0]=tri[1]; return 1; }
+	Real vc=d1*d4-d3*d2;
+	if(vc<=0 && d1>=0 && d3<=0){ closest=a+ab*(d1/(d1-d3)); feature[0]=tri[0]; feature[1]=tri[1]; return 2; }
+	Vector3r cp=p-c;
+	Real d5=ab.dot(cp), d6=ac.dot(cp);
+	if(d6>=0 && d5<=d6){ closest=c; feature[0]=tri[2]; return 1; }
+	Real vb=d5*d2-d1*d6;
+	if(vb<=0 && d2>=0 && d6<=0){ closest=a+ac*(d2/(d2-d6)); feature[0]=tri[0]; feature[1]=tri[2]; return 2; }
+	Real va=d3*d6-d5*d4;
+	if(va<=0 && (d4-d3)>=0 && (d5-d6)>=0){ closest=b+(c-b)*((d4-d3)/((d4-d3)+(d5-d6))); feature[0]=tri[1]; feature[1]=tri[2]; return 2; }
+	Real denom=1./(va+vb+vc);
+	closest=a+ab*(vb*denom)+ac*(vc*denom);
+	for(int i=0; i<3; i++) feature[i]=tri[i];
+	return 3;
+}
+
+void Bo1_TriMesh_Aabb::go(const shared_ptr<Shape>& cm, shared_ptr<Bound>& bv, const Se3r& se3, const Body*){
+	TriMesh* mesh=static_cast<TriMesh*>(cm.get());
+	if(!bv){ bv=shared_ptr<Bound>(new Aabb); }
+	Aabb* aabb=static_cast<Aabb*>(bv.get());
+	if(mesh->nodes.empty()){ aabb->min=aabb->max=se3.position; return; }
+	// corners of the root box of the hierarchy, transformed; cheaper than going through all vertices
+	const AlignedBox3r& box=mesh->nodes[0].box;
+	Matrix3r rot=se3.orientation.toRotationMatrix();
+	Real inf=std::numeric_limits<Real>::infinity();
+	aabb->min=Vector3r(inf,inf,inf); aabb->max=Vector3r(-inf,-inf,-inf);
+	for(int i=0; i<8; i++){
+		Vector3r v=se3.position+rot*box.corner((AlignedBox3r::CornerType)i);
+		if(scene->isPeriodic) v=scene->cell->unshearPt(v);
+		aabb->min=aabb->min.cwiseMin(v);
+		aabb->max=aabb->max.cwiseMax(v);
+	}
+}
+
+namespace {
+	// closest point on one triangle of the mesh
+	struct MeshTouch{ Real dist; Vector3r point; int tri, nFeature; int feature[3]; bool operator<(const MeshTouch& o) const { return dist<o.dist; } };
+}
+
+bool Ig2_TriMesh_Sphere_ScGeom::go(const shared_ptr<Shape>& cm1, const shared_ptr<Shape>& cm2, const State& state1, const State& state2, const Vector3r& shift2, const bool& force, const shared_ptr<Interaction>& c){
+	TIMING_DELTAS_START();
+	const TriMesh* mesh=static_cast<TriMesh*>(cm1.get());
+	const Real radius=static_cast<Sphere*>(cm2.get())->radius;
+	Matrix3r rot=state1.ori.toRotationMatrix();
+	// sphere center in mesh-local coordinates
+	Vector3r cl=rot.transpose()*(state2.pos+shift2-state1.pos);
+	vector<int> near; mesh->trianglesNear(cl,radius,near);
+	vector<MeshTouch> touches; touches.reserve(near.size());
+	FOREACH(int t, near){
+		MeshTouch m; m.tri=t;
+		m.nFeature=mesh->closestPoint(t,cl,m.point,m.feature);
+		m.dist=(cl-m.point).norm();
+		if(m.dist<radius) touches.push_back(m);
+	}
+	std::sort(touches.begin(),touches.end());
+	// sum overlaps of distinct contacts; an edge or a vertex is skipped if a closer triangle contains it
+	Vector3r overlap=Vector3r::Zero();
+	for(size_t i=0; i<touches.size(); i++){
+		const MeshTouch& m=touches[i];
+		if(m.nFeature<3){
+			bool shadowed=false;
+			for(size_t j=0; j<i && !shadowed; j++){
+				const Vector3i& tri=mesh->triangles[touches[j].tri];
+				bool hasAll=true;
+				for(int k=0; k<m.nFeature; k++) hasAll&=(tri[0]==m.feature[k] || tri[1]==m.feature[k] || tri[2]==m.feature[k]);
+				shadowed=hasAll;
+			}
+			if(shadowed) continue;
+		}
+		Vector3r n;
+		if(m.dist>0) n=(cl-m.point)/m.dist;
+		else { const Vector3i& tri=mesh->triangles[m.tri]; n=(mesh->vertices[tri[1]]-mesh->vertices[tri[0]]).cross(mesh->vertices[tri[2]]-mesh->vertices[tri[0]]).normalized(); }
+		overlap+=(radius-m.dist)*n;
+	}
+	Real penetrationDepth=overlap.norm();
+	Vector3r normal;
+	if(penetrationDepth>0) normal=overlap/penetrationDepth;
+	else {
+		if((!c->isReal() && !force) || mesh->nodes.empty()){ TIMING_DELTAS_CHECKPOINT("Ig2_TriMesh_Sphere_ScGeom"); return false; }
+		// existing contact which ceased to overlap: find the nearest triangle, so that the law sees the real (negative) penetration
+		Real dist=2*radius, maxDist=2*mesh->nodes[0].box.diagonal().norm()+dist;
+		MeshTouch best; best.dist=std::numeric_limits<Real>::infinity();
+		while(best.dist==std::numeric_limits<Real>::infinity() && dist<maxDist){
+			near.clear(); mesh->trianglesNear(cl,dist,near);
+			FOREACH(int t, near){
+				MeshTouch m; m.tri=t; m.nFeature=mesh->closestPoint(t,cl,m.point,m.feature); m.dist=(cl-m.point).norm();
+				if(m.dist<best.dist) best=m;
+			}
+			dist*=2;
+		}
+		if(best.dist==std::numeric_limits<Real>::infinity() || best.dist==0){ TIMING_DELTAS_CHECKPOINT("Ig2_TriMesh_Sphere_ScGeom"); return false; }
+		penetrationDepth=radius-best.dist;
+		normal=(cl-best.point)/best.dist;
+	}
+	bool isNew=!c->geom;
+	if(isNew) c->geom=pooledShared<ScGeom>();
+	const shared_ptr<ScGeom>& scm=YADE_PTR_CAST<ScGeom>(c->geom);
+	normal=rot*normal; // global orientation
+	scm->contactPoint=state2.pos+shift2-(radius-0.5*penetrationDepth)*normal;
+	scm->penetrationDepth=penetrationDepth;
+	scm->radius1=2*radius;
+	scm->radius2=radius;
+	scm->precompute(state1,state2,scene,c,normal,isNew,shift2,false/*avoidGranularRatcheting only for sphere-sphere*/);
+	TIMING_DELTAS_CHECKPOINT("Ig2_TriMesh_Sphere_ScGeom");
+	return true;
+}
+
+bool Ig2_TriMesh_Sphere_ScGeom6D::go(const shared_ptr<Shape>& cm1, const shared_ptr<Shape>& cm2, const State& state1, const State& state2, const Vector3r& shift2, const bool& force, const shared_ptr<Interaction>& c){
+	bool isNew=!c->geom;
+	if(!Ig2_TriMesh_Sphere_ScGeom::go(cm1,cm2,state1,state2,shift2,force,c)) return false;
+	if(isNew){
+		shared_ptr<ScGeom6D> sc=pooledShared<ScGeom6D>();
+		*(YADE_PTR_CAST<ScGeom>(sc))=*(YADE_PTR_CAST<ScGeom>(c->geom));
+		c->geom=sc;
+	}
+	YADE_PTR_CAST<ScGeom6D>(c->geom)->precomputeRotations(state1,state2,isNew,false);
+	return true;
+}
+
+#ifdef YADE_OPENGL
+	#include<lib/opengl/OpenGLWrapper.hpp>
+	void Gl1_TriMesh::go(const shared_ptr<Shape>& cm, const shared_ptr<State>&, bool wire, const GLViewInfo&){
+		TriMesh* mesh=static_cast<TriMesh*>(cm.get());
+		glColor3v(cm->color);
+		if(cm->wire || wire){
+			glDisable(GL_LIGHTING);
+			FOREACH(const Vector3i& t, mesh->triangles){
+				glBegin(GL_LINE_LOOP); for(int i=0; i<3; i++) glVertex3v(mesh->vertices[t[i]]); glEnd();
+			}
+		} else {
+			glDisable(GL_CULL_FACE); glEnable(GL_LIGHTING);
+			glBegin(GL_TRIANGLES);
+			FOREACH(const Vector3i& t, mesh->triangles){
+				const Vector3r& a=mesh->vertices[t[0]]; const Vector3r& b=mesh->vertices[t[1]]; const Vector3r& c=mesh->vertices[t[2]];
+				glNormal3v(Vector3r((b-a).cross(c-a).normalized()));
+				glVertex3v(a); glVertex3v(b); glVertex3v(c);
+			}
+			glEnd();
+		}
+	}
+#endif
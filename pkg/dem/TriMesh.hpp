@@ -0,0 +1,79 @@
+// 2026 © Yade developers
+#pragma once
+
+#include<core/Shape.hpp>
+#include<pkg/common/Aabb.hpp>
+#include<pkg/common/Dispatching.hpp>
+#include<pkg/common/Sphere.hpp>
+
+/*! Rigid triangulated surface as one body, with a bounding volume hierarchy (BVH) over its triangles.
+
+The hierarchy is built in local coordinates (so it stays valid when the body moves) when vertices or triangles are set; it is not saved. */
+class TriMesh: public Shape{
+	public:
+		//! BVH node; leaves have left==-1 and refer to count triangles from first in order
+		struct Node{ AlignedBox3r box; int left, right, first, count; };
+		vector<Node> nodes;
+		//! triangle indices, permuted so that each leaf refers to a contiguous range
+		vector<int> order;
+		void postLoad(TriMesh&);
+		void buildBvh();
+		//! append to out indices of triangles whose bounding boxes are closer than dist to point p (in local coordinates)
+		void trianglesNear(const Vector3r& p, Real dist, vector<int>& out) const;
+		//! closest point on triangle t to p; vertex indices spanning the closest feature (vertex, edge or the whole triangle) are stored in feature, their number is returned
+		int closestPoint(int t, const Vector3r& p, Vector3r& closest, int feature[3]) const;
+		boost::python::list pyTrianglesNear(const Vector3r& p, Real dist) const { vector<int> ret; trianglesNear(p,dist,ret); boost::python::list l; FOREACH(int t, ret) l.append(t); return l; }
+		virtual ~TriMesh(){};
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(TriMesh,Shape,"Rigid triangulated surface (e.g. imported by :yref:`yade.ymport.stlMesh`), represented as one body with one bound; triangles near a sphere are found by querying bounding volume hierarchy. Contacts are computed by :yref:`Ig2_TriMesh_Sphere_ScGeom`. The mesh is non-dynamic and can be moved by kinematic engines like any other body.",
+		((vector<Vector3r>,vertices,,Attr::triggerPostLoad,"Vertex positions in local coordinates."))
+		((vector<Vector3i>,triangles,,Attr::triggerPostLoad,"Vertex indices of triangles. Neighbour triangles must share vertices (rather than have duplicate vertices at the same position), so that contacts on their common edges and vertices are counted only once."))
+		((int,leafSize,4,Attr::triggerPostLoad,"Maximum number of triangles in a leaf of the bounding volume hierarchy."))
+		,/*ctor*/ createIndex();
+		,/*py*/
+		.def("trianglesNear",&TriMesh::pyTrianglesNear,(boost::python::arg("pos"),boost::python::arg("dist")),"Return indices of triangles whose bounding boxes are closer than *dist* to *pos* (in local coordinates).")
+		.add_property("nNodes",&TriMesh::nNodes,"Number of nodes of the bounding volume hierarchy.")
+	);
+	int nNodes() const { return nodes.size(); }
+	DECLARE_LOGGER;
+	REGISTER_CLASS_INDEX(TriMesh,Shape);
+};
+REGISTER_SERIALIZABLE(TriMesh);
+
+class Bo1_TriMesh_Aabb: public BoundFunctor{
+	public:
+		void go(const shared_ptr<Shape>& cm, shared_ptr<Bound>& bv, const Se3r& se3, const Body*);
+	FUNCTOR1D(TriMesh);
+	YADE_CLASS_BASE_DOC(Bo1_TriMesh_Aabb,BoundFunctor,"Create/update :yref:`Aabb` of a :yref:`TriMesh`, enclosing the root box of its hierarchy.");
+};
+REGISTER_SERIALIZABLE(Bo1_TriMesh_Aabb);
+
+class Ig2_TriMesh_Sphere_ScGeom: public IGeomFunctor{
+	public:
+		virtual bool go(const shared_ptr<Shape>& cm1, const shared_ptr<Shape>& cm2, const State& state1, const State& state2, const Vector3r& shift2, const bool& force, const shared_ptr<Interaction>& c);
+		virtual bool goReverse(const shared_ptr<Shape>& cm1, const shared_ptr<Shape>& cm2, const State& state1, const State& state2, const Vector3r& shift2, const bool& force, const shared_ptr<Interaction>& c){ c->swapOrder(); return go(cm2,cm1,state2,state1,-shift2,force,c); }
+	YADE_CLASS_BASE_DOC(Ig2_TriMesh_Sphere_ScGeom,IGeomFunctor,"Create/update :yref:`ScGeom` of :yref:`TriMesh` and :yref:`Sphere`. Triangles closer than the sphere radius are found in the hierarchy and the closest point on each of them is computed. A closest point on an edge or a vertex is discarded if a triangle sharing that edge or vertex is closer, so that a sphere resting on a flat or convex part of the mesh has only one contact regardless of the tessellation. Remaining contacts (e.g. with both faces of a concave corner) are summed as overlap vectors; the resulting normal and penetration depth give the same elastic force as separate contacts would in a linear model.");
+	FUNCTOR2D(TriMesh,Sphere);
+	DEFINE_FUNCTOR_ORDER_2D(TriMesh,Sphere);
+};
+REGISTER_SERIALIZABLE(Ig2_TriMesh_Sphere_ScGeom);
+
+class Ig2_TriMesh_Sphere_ScGeom6D: public Ig2_TriMesh_Sphere_ScGeom{
+	public:
+		virtual bool go(const shared_ptr<Shape>& cm1, const shared_ptr<Shape>& cm2, const State& state1, const State& state2, const Vector3r& shift2, const bool& force, const shared_ptr<Interaction>& c);
+		virtual bool goReverse(const shared_ptr<Shape>& cm1, const shared_ptr<Shape>& cm2, const State& state1, const State& state2, const Vector3r& shift2, const bool& force, const shared_ptr<Interaction>& c){ c->swapOrder(); return go(cm2,cm1,state2,state1,-shift2,force,c); }
+	YADE_CLASS_BASE_DOC(Ig2_TriMesh_Sphere_ScGeom6D,Ig2_TriMesh_Sphere_ScGeom,"Create :yref:`ScGeom6D` from :yref:`TriMesh` and :yref:`Sphere`, like :yref:`Ig2_Facet_Sphere_ScGeom6D` does for facets.");
+	FUNCTOR2D(TriMesh,Sphere);
+	DEFINE_FUNCTOR_ORDER_2D(TriMesh,Sphere);
+};
+REGISTER_SERIALIZABLE(Ig2_TriMesh_Sphere_ScGeom6D);
+
+#ifdef YADE_OPENGL
+	#include<pkg/common/GLDrawFunctors.hpp>
+	class Gl1_TriMesh: public GlShapeFunctor{
+		public:
+			virtual void go(const shared_ptr<Shape>&, const shared_ptr<State>&,bool,const GLViewInfo&);
+		RENDERS(TriMesh);
+		YADE_CLASS_BASE_DOC(Gl1_TriMesh,GlShapeFunctor,"Renders :yref:`TriMesh` object.");
+	};
+	REGISTER_SERIALIZABLE(Gl1_TriMesh);
+#endif
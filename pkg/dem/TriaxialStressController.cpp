@@ -15,6 +15,7 @@
 #include<assert.h>
 #include<core/Scene.hpp>
 #include<pkg/dem/Shop.hpp>
+#include<pkg/dem/MacroQuantities.hpp>
 #include<core/Clump.hpp>
 
 #ifdef FLOW_ENGINE
@@ -266,6 +267,9 @@ void TriaxialStressController::controlInternalStress ( Real multiplier )
 /*!
     \fn TriaxialStressController::ComputeUnbalancedForce( bool maxUnbalanced)
  */
-Real TriaxialStressController::ComputeUnbalancedForce( bool maxUnbalanced) {return Shop::unbalancedForce(maxUnbalanced,scene);}
+Real TriaxialStressController::ComputeUnbalancedForce( bool maxUnbalanced) {
+	// reuse the value if a MacroQuantities engine already computed it in this iteration
+	if (MacroQuantities* mq=MacroQuantities::upToDate(scene)) return maxUnbalanced ? mq->maxUnbalancedForce : mq->unbalancedForce;
+	return Shop::unbalancedForce(maxUnbalanced,scene);}
 
 
@@ -12,6 +12,7 @@
 #include<vtkPolyData.h>
 #include<vtkXMLUnstructuredGridWriter.h>
 #include<vtkXMLPolyDataWriter.h>
+#include<vtkXMLWriter.h>
 #include<vtkZLibDataCompressor.h>
 #include<vtkTriangle.h>
 #include<vtkLine.h>
@@ -30,6 +31,10 @@
 #include<pkg/dem/WirePM.hpp>
 #include<pkg/dem/JointedCohesiveFrictionalPM.hpp>
 #include<pkg/dem/Shop.hpp>
+#include<boost/thread/thread.hpp>
+#include<boost/thread/condition_variable.hpp>
+#include<boost/bind.hpp>
+#include<deque>
 #ifdef YADE_LIQMIGRATION
 	#include<pkg/dem/ViscoelasticCapillarPM.hpp>
 #endif
@@ -43,7 +48,72 @@ CREATE_LOGGER(VTKRecorder);
 #define GET_MASK(b) b->groupMask
 #endif
 
+/* Writes files prepared by VTKRecorder::buildWriters in background threads.
+Each job owns the only references to its writers (and through them to the data), so the main thread and the writing thread never touch the same VTK objects. */
+class VTKWriterPool{
+	typedef vector<vtkSmartPointer<vtkXMLWriter> > Job;
+	std::deque<shared_ptr<Job> > jobs;
+	vector<shared_ptr<boost::thread> > threads;
+	boost::mutex mutex;
+	boost::condition_variable jobAdded, jobTaken, jobDone;
+	int busy;
+	bool stopping;
+	void work(){
+		while(true){
+			shared_ptr<Job> job;
+			{
+				boost::mutex::scoped_lock lock(mutex);
+				while(jobs.empty() && !stopping) jobAdded.wait(lock);
+				if(jobs.empty()) return; // stopping, and nothing left to write
+				job=jobs.front(); jobs.pop_front(); busy++;
+				jobTaken.notify_all();
+			}
+			FOREACH(const vtkSmartPointer<vtkXMLWriter>& writer, *job) writer->Write();
+			job.reset(); // free the data in this thread
+			boost::mutex::scoped_lock lock(mutex);
+			busy--; jobDone.notify_all();
+		}
+	}
+	public:
+	const int nThreads;
+	VTKWriterPool(int n): busy(0), stopping(false), nThreads(n){
+		for(int i=0; i<n; i++) threads.push_back(shared_ptr<boost::thread>(new boost::thread(boost::bind(&VTKWriterPool::work,this))));
+	}
+	// pending jobs are written before the threads exit
+	~VTKWriterPool(){
+		{ boost::mutex::scoped_lock lock(mutex); stopping=true; jobAdded.notify_all(); }
+		FOREACH(const shared_ptr<boost::thread>& t, threads) t->join();
+	}
+	// takes over writers (the vector is left empty); blocks while maxPending jobs are waiting
+	void submit(Job& writers, size_t maxPending){
+		shared_ptr<Job> job(new Job); job->swap(writers);
+		boost::mutex::scoped_lock lock(mutex);
+		while(jobs.size()>=max(maxPending,(size_t)1)) jobTaken.wait(lock);
+		jobs.push_back(job);
+		jobAdded.notify_one();
+	}
+	void wait(){
+		boost::mutex::scoped_lock lock(mutex);
+		while(!jobs.empty() || busy>0) jobDone.wait(lock);
+	}
+};
+
 void VTKRecorder::action(){
+	vector<vtkSmartPointer<vtkXMLWriter> > writers;
+	// all local VTK objects are released when buildWriters returns, only the writers hold the data
+	buildWriters(writers);
+	if(asyncWriters<=0){
+		writerPool.reset();
+		FOREACH(const vtkSmartPointer<vtkXMLWriter>& writer, writers) writer->Write();
+		return;
+	}
+	if(!writerPool || writerPool->nThreads!=asyncWriters) writerPool=shared_ptr<VTKWriterPool>(new VTKWriterPool(asyncWriters));
+	writerPool->submit(writers,maxPendingWrites);
+}
+
+void VTKRecorder::waitForWriters(){ if(writerPool) writerPool->wait(); }
+
+void VTKRecorder::buildWriters(vector<vtkSmartPointer<vtkXMLWriter> >& writers){
 	vector<bool> recActive(REC_SENTINEL,false);
 	FOREACH(string& rec, recorders){
 		if(rec=="all"){
@@ -841,7 +911,7 @@ void VTKRecorder::action(){
 			#else
 				writer->SetInput(spheresUg);
 			#endif
-			writer->Write();
+			writers.push_back(writer);
 		}
 	}
 	vtkSmartPointer<vtkUnstructuredGrid> facetsUg = vtkSmartPointer<vtkUnstructuredGrid>::New();
@@ -876,7 +946,7 @@ void VTKRecorder::action(){
 			#else
 				writer->SetInput(facetsUg);
 			#endif
-			writer->Write();
+			writers.push_back(writer);
 		}
 	}
 	vtkSmartPointer<vtkUnstructuredGrid> boxesUg = vtkSmartPointer<vtkUnstructuredGrid>::New();
@@ -910,7 +980,7 @@ void VTKRecorder::action(){
 			#else
 				writer->SetInput(boxesUg);
 			#endif
-			writer->Write();	
+			writers.push_back(writer);
 		}
 	}
 	vtkSmartPointer<vtkPolyData> intrPd = vtkSmartPointer<vtkPolyData>::New();
@@ -947,7 +1017,7 @@ void VTKRecorder::action(){
 			#else
 				writer->SetInput(intrPd);
 			#endif
-			writer->Write();
+			writers.push_back(writer);
 		}
 	}
 	vtkSmartPointer<vtkUnstructuredGrid> pericellUg = vtkSmartPointer<vtkUnstructuredGrid>::New();
@@ -968,12 +1038,15 @@ void VTKRecorder::action(){
 			#else
 				writer->SetInput(pericellUg);
 			#endif
-			writer->Write();
+			writers.push_back(writer);
 		}
 	}
 
 	if (recActive[REC_CRACKS]) {
 		string fileCracks = "cracks_"+Key+".txt";
+		// the file is written by EventLog in the background; include cracks from this step as well (engines run sequentially here)
+		scene->events->flush();
+		scene->events->waitForWriter();
 		std::ifstream file (fileCracks.c_str(),std::ios::in);
 		vtkSmartPointer<vtkUnstructuredGrid> crackUg = vtkSmartPointer<vtkUnstructuredGrid>::New();
 		
@@ -1013,7 +1086,7 @@ void VTKRecorder::action(){
 		#else
 			writer->SetInput(crackUg);
 		#endif
-		writer->Write(); }
+		writers.push_back(writer);}
 
 	#ifdef YADE_VTK_MULTIBLOCK
 		if(multiblock){
@@ -1032,7 +1105,7 @@ void VTKRecorder::action(){
 			#else
 				writer->SetInput(multiblockDataset);
 			#endif
-			writer->Write();	
+			writers.push_back(writer);
 		}
 	#endif
 };
@@ -23,7 +23,7 @@ ViscElPhys::~ViscElPhys(){}
 void Ip2_ViscElMat_ViscElMat_ViscElPhys::go(const shared_ptr<Material>& b1, const shared_ptr<Material>& b2, const shared_ptr<Interaction>& interaction) {
 	// no updates of an existing contact 
 	if(interaction->phys) return;
-	shared_ptr<ViscElPhys> phys (new ViscElPhys());
+	shared_ptr<ViscElPhys> phys=pooledShared<ViscElPhys>();
 	Calculate_ViscElMat_ViscElMat_ViscElPhys(b1, b2, interaction, phys);
 	interaction->phys = phys;
 }
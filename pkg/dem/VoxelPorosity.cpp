@@ -0,0 +1,218 @@
+// 2026 © Yade developers
+#include"VoxelPorosity.hpp"
+#include<core/Scene.hpp>
+#include<core/Omega.hpp>
+#include<pkg/common/Sphere.hpp>
+#include<fstream>
+#ifdef YADE_OPENMP
+	#include<omp.h>
+#endif
+
+YADE_PLUGIN((VoxelPorosity));
+CREATE_LOGGER(VoxelPorosity);
+
+SphereVoxelGrid::SphereVoxelGrid(const Vector3r& _lo, const Vector3r& hi, const Vector3i& _n, bool _partial): lo(_lo), n(_n), partial(_partial){
+	if(n.minCoeff()<1) throw std::invalid_argument("SphereVoxelGrid: the grid must have at least one voxel along each axis.");
+	h=(hi-lo).cwiseQuotient(n.cast<Real>());
+	if(h.minCoeff()<=0) throw std::invalid_argument("SphereVoxelGrid: the box has zero or negative size.");
+	layers.resize((n[0]+7)/8);
+}
+
+Real SphereVoxelGrid::cubeUnderPlane(Vector3r a, Real b){
+	// mirror the cube so that all components of a are non-negative
+	for(int i=0; i<3; i++) if(a[i]<0){ b-=a[i]; a[i]=-a[i]; }
+	Real sum=a.sum();
+	if(b<=0) return 0;
+	if(b>=sum) return 1;
+	// along (nearly) vanishing components, the volume is a prism over the lower-dimensional problem
+	Real aa[3]; int m=0; Real prod=1;
+	for(int i=0; i<3; i++) if(a[i]>1e-6*sum){ aa[m++]=a[i]; prod*=a[i]; }
+	// inclusion-exclusion over vertices of the m-dimensional unit cube
+	Real ret=0;
+	for(int v=0; v<(1<<m); v++){
+		Real s=b; int sign=1;
+		for(int i=0; i<m; i++) if(v&(1<<i)){ s-=aa[i]; sign=-sign; }
+		if(s>0) ret+=sign*pow(s,m);
+	}
+	ret/=(m==3 ? 6 : m)*prod;
+	return std::min((Real)1,std::max((Real)0,ret));
+}
+
+void SphereVoxelGrid::rasterizeSphere(int L, const Vector3r& pos, Real r){
+	Layer& layer=layers[L];
+	const Real hd=.5*h.norm(), r2=r*r, rIn2=(r>hd ? pow(r-hd,2) : -1), rOut2=pow(r+hd,2);
+	// voxel i along axis k has center lo[k]+(i+.5)*h[k]
+	#define _VOXEL_RANGE(k,x0,x1,i0,i1) int i0=std::max(0,(int)ceil(((x0)-lo[k])/h[k]-.5)), i1=std::min(n[k]-1,(int)floor(((x1)-lo[k])/h[k]-.5))
+	_VOXEL_RANGE(0,pos[0]-r-hd,pos[0]+r+hd,ix0,ix1);
+	ix0=std::max(ix0,8*L); ix1=std::min(ix1,8*L+7);
+	for(int ix=ix0; ix<=ix1; ix++){
+		Real dx2=pow(lo[0]+(ix+.5)*h[0]-pos[0],2);
+		if(dx2>=rOut2) continue;
+		Real dyMax=sqrt(rOut2-dx2);
+		_VOXEL_RANGE(1,pos[1]-dyMax,pos[1]+dyMax,iy0,iy1);
+		for(int iy=iy0; iy<=iy1; iy++){
+			Real dxy2=dx2+pow(lo[1]+(iy+.5)*h[1]-pos[1],2);
+			if(dxy2>=rOut2) continue;
+			Real dzMax=sqrt(rOut2-dxy2);
+			_VOXEL_RANGE(2,pos[2]-dzMax,pos[2]+dzMax,iz0,iz1);
+			Block* blk=NULL; int blkZ=-1;
+			for(int iz=iz0; iz<=iz1; iz++){
+				Vector3r c=lo+(Vector3r(ix,iy,iz)+Vector3r(.5,.5,.5)).cwiseProduct(h);
+				Real d2=(c-pos).squaredNorm();
+				if(d2>=rOut2) continue;
+				if(!blk || blkZ!=iz/8){ blkZ=iz/8; blk=&layer[(long)(iy/8)*nbz()+blkZ]; }
+				int word=ix%8, bit=8*(iy%8)+iz%8;
+				if(d2<=rIn2 || (!partial && d2<r2)){ blk->bits[word]|=((boost::uint64_t)1)<<bit; continue; }
+				if(!partial) continue;
+				Real d=sqrt(d2), frac;
+				if(d>0){
+					// plane tangent to the sphere at the point nearest to the voxel center, in voxel coordinates scaled to the unit cube
+					Vector3r normal=(c-pos)/d;
+					Vector3r corner=c-.5*h;
+					frac=cubeUnderPlane(normal.cwiseProduct(h),r-normal.dot(corner-pos));
+				} else frac=std::min((Real)1,(4/3.)*Mathr::PI*pow(r,3)/h.prod());
+				if(blk->partial.empty()) blk->partial.resize(512,0.f);
+				blk->partial[64*word+bit]+=frac;
+			}
+		}
+	}
+	#undef _VOXEL_RANGE
+}
+
+void SphereVoxelGrid::rasterize(const vector<Vector3r>& centers, const vector<Real>& radii){
+	// spheres overlapping each layer
+	vector<vector<int> > inLayer(layers.size());
+	const Real hd=.5*h.norm();
+	for(size_t s=0; s<centers.size(); s++){
+		int i0=std::max(0,(int)floor((centers[s][0]-radii[s]-hd-lo[0])/h[0])), i1=std::min(n[0]-1,(int)floor((centers[s][0]+radii[s]+hd-lo[0])/h[0]));
+		for(int L=i0/8; L<=i1/8; L++) inLayer[L].push_back(s);
+	}
+	#ifdef YADE_OPENMP
+		#pragma omp parallel for schedule(dynamic,1)
+	#endif
+	for(int L=0; L<(int)layers.size(); L++){
+		FOREACH(int s, inLayer[L]) rasterizeSphere(L,centers[s],radii[s]);
+	}
+}
+
+long SphereVoxelGrid::nBlocks() const {
+	long ret=0; FOREACH(const Layer& l, layers) ret+=l.size();
+	return ret;
+}
+
+vector<Real> SphereVoxelGrid::solidFractions(const Vector3i& R) const {
+	if(R.minCoeff()<1) throw std::invalid_argument("SphereVoxelGrid: there must be at least one region along each axis.");
+	const int nR=R.prod();
+	#define _REGION(k,i) ((long)(i)*R[k]/n[k])
+	vector<Real> solid(nR,0.);
+	#ifdef YADE_OPENMP
+		#pragma omp parallel
+	#endif
+	{
+		vector<Real> mySolid(nR,0.);
+		#ifdef YADE_OPENMP
+			#pragma omp for schedule(dynamic,1)
+		#endif
+		for(int L=0; L<(int)layers.size(); L++){
+			FOREACH(const Layer::value_type& kv, layers[L]){
+				const Block& blk=kv.second;
+				const Vector3i first(8*L,8*(kv.first/nbz()),8*(kv.first%nbz()));
+				const Vector3i last=(first+Vector3i(7,7,7)).cwiseMin(n-Vector3i(1,1,1));
+				bool oneRegion=true; int reg[3];
+				for(int k=0; k<3; k++){ reg[k]=_REGION(k,first[k]); oneRegion&=(reg[k]==_REGION(k,last[k])); }
+				if(oneRegion && blk.partial.empty()){
+					// voxels outside of the grid are never set
+					long bits=0; for(int w=0; w<8; w++) bits+=__builtin_popcountll(blk.bits[w]);
+					mySolid[(reg[0]*R[1]+reg[1])*R[2]+reg[2]]+=bits;
+					continue;
+				}
+				for(int x=first[0]; x<=last[0]; x++) for(int y=first[1]; y<=last[1]; y++) for(int z=first[2]; z<=last[2]; z++){
+					int word=x%8, bit=8*(y%8)+z%8;
+					Real v=((blk.bits[word]>>bit)&1) ? 1. : (blk.partial.empty() ? 0. : std::min(1.f,blk.partial[64*word+bit]));
+					if(v>0) mySolid[(_REGION(0,x)*R[1]+_REGION(1,y))*R[2]+_REGION(2,z)]+=v;
+				}
+			}
+		}
+		#ifdef YADE_OPENMP
+			#pragma omp critical
+		#endif
+		for(int i=0; i<nR; i++) solid[i]+=mySolid[i];
+	}
+	// divide by number of voxels in each region
+	vector<long> count[3];
+	for(int k=0; k<3; k++){ count[k].resize(R[k],0); for(int i=0; i<n[k]; i++) count[k][_REGION(k,i)]++; }
+	#undef _REGION
+	for(int x=0; x<R[0]; x++) for(int y=0; y<R[1]; y++) for(int z=0; z<R[2]; z++){
+		long c=count[0][x]*count[1][y]*count[2][z];
+		Real& s=solid[(x*R[1]+y)*R[2]+z];
+		s=(c>0 ? s/c : NaN);
+	}
+	return solid;
+}
+
+Real VoxelPorosity::compute(){
+	vector<Vector3r> centers; vector<Real> radii;
+	FOREACH(const shared_ptr<Body>& b, *scene->bodies){
+		if(!b || !(b->isDynamic() || b->isClumpMember())) continue;
+		Sphere* s=dynamic_cast<Sphere*>(b->shape.get());
+		if(!s || (mask!=0 && (b->groupMask & mask)==0)) continue;
+		centers.push_back(b->state->pos); radii.push_back(s->radius);
+	}
+	if(start!=end){ boxMin=start; boxMax=end; }
+	else if(scene->isPeriodic){
+		if(scene->cell->hasShear()) throw std::invalid_argument("VoxelPorosity: sheared periodic cell is not supported; give start and end explicitly.");
+		boxMin=Vector3r::Zero(); boxMax=scene->cell->getSize();
+		// wrap spheres into the cell and add their images crossing the cell boundaries
+		size_t nSpheres=centers.size();
+		for(size_t s=0; s<nSpheres; s++){
+			Vector3r& c=centers[s]; c=scene->cell->wrapPt(c);
+			for(int img=1; img<8; img++){
+				Vector3r shift=Vector3r::Zero(); bool crosses=true;
+				for(int k=0; k<3 && crosses; k++){
+					if(!(img&(1<<k))) continue;
+					if(c[k]-radii[s]<0) shift[k]=boxMax[k];
+					else if(c[k]+radii[s]>boxMax[k]) shift[k]=-boxMax[k];
+					else crosses=false;
+				}
+				if(crosses){ centers.push_back(centers[s]+shift); radii.push_back(radii[s]); }
+			}
+		}
+	} else {
+		if(centers.empty()) throw std::runtime_error("VoxelPorosity: no spheres and no box given.");
+		boxMin=boxMax=centers[0];
+		for(size_t s=0; s<centers.size(); s++){
+			boxMin=boxMin.cwiseMin(centers[s]-radii[s]*Vector3r::Ones());
+			boxMax=boxMax.cwiseMax(centers[s]+radii[s]*Vector3r::Ones());
+		}
+	}
+	Vector3r size=boxMax-boxMin;
+	if(resolution<1) throw std::invalid_argument("VoxelPorosity.resolution must be positive.");
+	Real h=size.maxCoeff()/resolution;
+	for(int k=0; k<3; k++) gridSize[k]=std::max(1,(int)round(size[k]/h));
+	SphereVoxelGrid grid(boxMin,boxMax,gridSize,partialVolumes);
+	grid.rasterize(centers,radii);
+	nBlocks=grid.nBlocks();
+	solidFraction=grid.solidFractions(regions);
+	// porosity of the whole box from region fractions, weighted by region volumes (in voxels)
+	vector<Real> whole=(regions==Vector3i(1,1,1) ? solidFraction : grid.solidFractions(Vector3i(1,1,1)));
+	porosity=1-whole[0];
+	return porosity;
+}
+
+Real VoxelPorosity::pyCompute(){
+	scene=Omega::instance().getScene().get();
+	return compute();
+}
+
+void VoxelPorosity::exportVtk(const string& filename) const {
+	if((int)solidFraction.size()!=regions.prod()) throw std::runtime_error("VoxelPorosity.exportVtk: no solid fraction computed yet (or regions changed since).");
+	std::ofstream out(filename.c_str());
+	if(!out.good()) throw std::runtime_error("VoxelPorosity.exportVtk: unable to open "+filename+" for writing.");
+	Vector3r spacing=(boxMax-boxMin).cwiseQuotient(regions.cast<Real>());
+	out<<"# vtk DataFile Version 3.0\nSolid fraction computed by VoxelPorosity\nASCII\nDATASET STRUCTURED_POINTS\n";
+	out<<"DIMENSIONS "<<regions[0]+1<<" "<<regions[1]+1<<" "<<regions[2]+1<<"\n";
+	out<<"ORIGIN "<<boxMin[0]<<" "<<boxMin[1]<<" "<<boxMin[2]<<"\nSPACING "<<spacing[0]<<" "<<spacing[1]<<" "<<spacing[2]<<"\n";
+	out<<"CELL_DATA "<<regions.prod()<<"\nSCALARS solidFraction double 1\nLOOKUP_TABLE default\n";
+	// VTK orders cells with x varying fastest
+	for(int z=0; z<regions[2]; z++) for(int y=0; y<regions[1]; y++) for(int x=0; x<regions[0]; x++) out<<solidFraction[(x*regions[1]+y)*regions[2]+z]<<"\n";
+}
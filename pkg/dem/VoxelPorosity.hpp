@@ -0,0 +1,62 @@
+// 2026 © Yade developers
+#pragma once
+#include<pkg/common/PeriodicEngines.hpp>
+#include<boost/unordered_map.hpp>
+#include<boost/cstdint.hpp>
+
+/*! Occupancy of a regular voxel grid by spheres, stored sparsely in blocks of 8×8×8 voxels packed into bits.
+
+A voxel is occupied if its center is inside a sphere; with partial volumes, voxels cut by the sphere surface get the part of their volume under the tangent plane instead. Blocks are kept separately for each layer of 8 voxels along x, so that layers can be rasterized in parallel without locking. */
+class SphereVoxelGrid{
+	public:
+		struct Block{
+			//! bit 8*y+z of word x is voxel (x,y,z) of the block
+			boost::uint64_t bits[8];
+			//! partial volumes of the 512 voxels, allocated at the first partially covered one
+			vector<float> partial;
+			Block(){ for(int i=0; i<8; i++) bits[i]=0; }
+		};
+		typedef boost::unordered_map<long,Block> Layer;
+		Vector3r lo, h; Vector3i n; bool partial;
+		vector<Layer> layers;
+		//! grid of n voxels between lo and hi
+		SphereVoxelGrid(const Vector3r& lo, const Vector3r& hi, const Vector3i& n, bool partial);
+		void rasterize(const vector<Vector3r>& centers, const vector<Real>& radii);
+		//! solid fraction of regions (grid cut in regions[i] equal parts along axis i), in C order
+		vector<Real> solidFractions(const Vector3i& regions) const;
+		long nBlocks() const;
+		//! volume of the part of unit cube where a·u<=b
+		static Real cubeUnderPlane(Vector3r a, Real b);
+	private:
+		void rasterizeSphere(int layer, const Vector3r& pos, Real r);
+		int nbz() const { return (n[2]+7)/8; }
+};
+
+class VoxelPorosity: public PeriodicEngine{
+	void exportVtk(const string& filename) const;
+	Real pyCompute();
+	public:
+		//! rasterize spheres and update porosity and solidFraction; returns porosity
+		Real compute();
+		virtual void action(){ compute(); }
+	DECLARE_LOGGER;
+	YADE_CLASS_BASE_DOC_ATTRS_CTOR_PY(VoxelPorosity,PeriodicEngine,"Porosity and solid fraction field of spheres, estimated on a voxel grid. Occupancy is stored sparsely and bit-packed (about 100 bytes per 512 voxels containing solid), and the grid is rasterized in parallel; the engine can therefore run periodically during the simulation, or be called via :yref:`compute<VoxelPorosity.compute>`. Dynamic spheres and clump members matching :yref:`mask<VoxelPorosity.mask>` are considered. Solid fraction of regions is stored in :yref:`solidFraction<VoxelPorosity.solidFraction>` (get a numpy array with ``numpy.array(e.solidFraction).reshape(e.regions)``) and can be saved as VTK image data with :yref:`exportVtk<VoxelPorosity.exportVtk>`.",
+		((Vector3r,start,Vector3r::Zero(),,"Lower corner of the box; if equal to :yref:`end<VoxelPorosity.end>`, the periodic cell (with periodic images of spheres) or the bounding box of the spheres is used."))
+		((Vector3r,end,Vector3r::Zero(),,"Upper corner of the box."))
+		((int,resolution,200,,"Number of voxels along the longest edge of the box; voxels are (nearly) cubic."))
+		((Vector3i,regions,Vector3i(1,1,1),,"Number of regions along each axis, for which solid fraction is computed."))
+		((bool,partialVolumes,false,,"Voxels cut by a sphere surface count with the part of their volume under the tangent plane at the nearest point of the sphere (the plane cuts the voxel exactly, the sphere is approximated), rather than with 0 or 1 depending on their center. This gives much better estimates at coarse resolutions. Volumes of overlapping spheres are not subtracted in partially covered voxels."))
+		((int,mask,0,,"If non-zero, only spheres with matching :yref:`groupMask<Body.groupMask>` are considered."))
+		((Real,porosity,NaN,Attr::readonly,"Porosity of the whole box from the last run."))
+		((vector<Real>,solidFraction,,Attr::readonly,"Solid fraction of regions from the last run, in C order (index ``(x*regions[1]+y)*regions[2]+z``)."))
+		((Vector3r,boxMin,Vector3r::Zero(),Attr::readonly,"Lower corner of the box used in the last run."))
+		((Vector3r,boxMax,Vector3r::Zero(),Attr::readonly,"Upper corner of the box used in the last run."))
+		((Vector3i,gridSize,Vector3i::Zero(),Attr::readonly,"Number of voxels along each axis in the last run."))
+		((long,nBlocks,0,Attr::readonly,"Number of allocated blocks of 8×8×8 voxels in the last run."))
+		,/*ctor*/
+		,/*py*/
+		.def("compute",&VoxelPorosity::pyCompute,"Compute porosity and solid fraction now; return porosity.")
+		.def("exportVtk",&VoxelPorosity::exportVtk,(boost::python::arg("filename")),"Save solid fraction of regions from the last run as VTK image data (legacy ``STRUCTURED_POINTS`` format, readable by Paraview), with one cell per region.")
+	);
+};
+REGISTER_SERIALIZABLE(VoxelPorosity);
@@ -0,0 +1,48 @@
+# encoding: utf-8
+# 2026 © Yade developers
+"""
+Access events (broken bonds, cracks, ...) collected by :yref:`EventLog` (:yref:`O.events<Omega.events>`) as numpy arrays.
+
+Events are returned as numpy record arrays with fields ``iter``, ``time``, ``source``, ``type``, ``id1``, ``id2``, ``pos`` (n,3), ``normal`` (n,3), ``size`` and ``energy``::
+
+	from yade import eventlog
+	cracks=eventlog.arrays('JCFpm')          # events in memory, from the current simulation
+	shear=cracks[cracks['type']==1]['pos']   # positions of shear cracks
+	ev,sources=eventlog.read('/tmp/run.evt')  # events saved in EventLog.fileName
+"""
+import numpy,struct,os
+
+#: record layout, must match EventLog::Event
+dtype=numpy.dtype([('iter','<i8'),('time','<f8'),('source','<i4'),('type','<i4'),('id1','<i4'),('id2','<i4'),('pos','<f8',(3,)),('normal','<f8',(3,)),('size','<f8'),('energy','<f8')])
+
+def arrays(source=None,log=None):
+	"""Return events stored in memory as numpy record array.
+
+	:param source: name of source (e.g. ``'JCFpm'``); all events if None.
+	:param log: :yref:`EventLog` instance; :yref:`O.events<Omega.events>` if None.
+	"""
+	from yade.wrapper import Omega
+	if log is None: log=Omega().events
+	idx=-1
+	if source is not None:
+		if source not in log.sources(): return numpy.zeros(0,dtype=dtype)
+		idx=log.sources().index(source)
+	return numpy.frombuffer(log._raw(idx),dtype=dtype).copy()
+
+def read(fileName,source=None):
+	"""Read events written to :yref:`EventLog.fileName`; return (events as numpy record array, list of source names). The file is memory-mapped, and an incomplete last record (written while reading) is skipped.
+
+	:param source: name of source; all events if None.
+	"""
+	f=open(fileName,'rb'); head=f.read(16); f.close()
+	if len(head)<16 or head[:8]!=b'YADEEVT1': raise ValueError(fileName+' is not an event file.')
+	version,recSize=struct.unpack('<II',head[8:16])
+	mm=numpy.memmap(fileName,dtype=numpy.uint8,mode='r')
+	if recSize!=dtype.itemsize: raise ValueError('%s: record size %d, expected %d.'%(fileName,recSize,dtype.itemsize))
+	n=(len(mm)-16)//recSize
+	ev=numpy.ndarray((n,),dtype=dtype,buffer=mm,offset=16)
+	sources=[l.rstrip('\n') for l in open(fileName+'.sources')] if os.path.exists(fileName+'.sources') else []
+	if source is not None:
+		if source not in sources: return numpy.zeros(0,dtype=dtype),sources
+		ev=ev[ev['source']==sources.index(source)]
+	return ev,sources
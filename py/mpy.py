@@ -0,0 +1,277 @@
+# encoding: utf-8
+# 2026 © Yade developers
+"""
+Spatial domain decomposition of simulations over MPI processes, using `mpi4py <http://mpi4py.scipy.org>`_.
+
+The root process (rank 0) builds the scene, then all processes call :yref:`decompose<yade.mpy.decompose>`, which cuts the space into slabs along one axis, each of them owned by one process, and sends every process only what it needs: dynamic bodies in its slab, *ghosts* -- copies of bodies owned by other processes which are closer than :yref:`halo<yade.mpy.halo>` to its slab -- and non-dynamic bodies (walls, facets, boundary spheres), which are replicated on all processes and have :yref:`Body.subdomain` equal to -1. The root keeps only its own part as well.
+
+Bodies have compact local ids on each process; :yref:`gids<yade.mpy.gids>` maps them to the ids they had in the root scene (global ids). Non-dynamic bodies get local ids from 0 in the order of their global ids, so that they keep their ids if they were created before all dynamic bodies.
+
+An exchange engine (:yref:`PyRunner`) is appended after :yref:`NewtonIntegrator`; at every step, it sends kinematic state of owned bodies to processes which have them as ghosts, ships bodies to processes which newly need them, and hands bodies over to the process owning the slab they moved into. Contacts between an owned body and a ghost are evaluated on both processes, from identical states; owned bodies therefore receive the same force as in a serial simulation and no force reduction is needed (the duplicate evaluation is the price for not communicating forces). Ghosts are moved by the local integrator, but their state is overwritten by that of the owner at the end of each step.
+
+Run scripts with e.g. ``mpirun -np 4 yade -n -x script.py``; a typical script looks like::
+
+	from yade import mpy
+	mpy.initialize()
+	# materials and engines on all processes, bodies only at the root
+	O.materials.append(FrictMat(young=1e7))
+	O.engines=[...]
+	if mpy.rank==0:
+		O.bodies.append(...)
+		O.dt=.5*utils.PWaveTimeStep()
+	mpy.decompose()
+	O.run(10000,True)
+	ids,states=mpy.gatherStates()  # full state at rank 0
+
+Limitations:
+
+* clumps are not supported (clumps and their members would have to migrate together);
+* :yref:`O.materials<Omega.materials>` must be the same on all processes, bodies arriving from other processes then share them;
+* :yref:`rebalance<yade.mpy.rebalance>` (and ownership transfers) do not carry contact history to processes which did not have the body before; ownership transfer does not lose it, since the new owner already holds the body as ghost;
+* slabs must be wider than :yref:`halo<yade.mpy.halo>`, so that only neighbour processes share bodies;
+* engines acting on dynamic bodies by their ids see local ids; use :yref:`sharedForce<yade.mpy.sharedForce>` and :yref:`unbalancedForce<yade.mpy.unbalancedForce>` instead of :yref:`O.forces<ForceContainer>` and :yref:`yade._utils.unbalancedForce` for global quantities.
+
+The check script :ysrc:`scripts/checks-and-tests/mpi-serial-compat.py` compares a decomposed simulation with its serial counterpart.
+"""
+
+import numpy
+from yade.wrapper import *
+from minieigen import *
+
+comm=None
+"mpi4py communicator (``MPI.COMM_WORLD``), set by :yref:`initialize<yade.mpy.initialize>`."
+rank=0
+"Rank of this process."
+numProcs=1
+"Number of processes."
+axis=0
+"Axis along which the space is cut into slabs."
+bounds=None
+"Coordinates of slab boundaries along :yref:`axis<yade.mpy.axis>` (``numProcs+1`` values, the outer ones infinite); slab *i* is owned by rank *i*."
+halo=0.
+"Bodies closer than this distance to a slab are present (as ghosts) on the process owning it."
+rebalancePeriod=0
+"If positive, call :yref:`rebalance<yade.mpy.rebalance>` every *rebalancePeriod* steps from :yref:`exchange<yade.mpy.exchange>`."
+
+gids=numpy.zeros(0,dtype=numpy.int64)
+"Global id of each local body (indexed by local :yref:`Body.id`), -1 for free ids."
+owned=numpy.zeros(0,dtype=numpy.int64)
+"Local ids of bodies owned by this process."
+sent={}
+"For every other rank, sorted global ids of owned bodies which are present on that rank as ghosts."
+_lastTime=0
+
+def initialize():
+	"Import mpi4py and set :yref:`comm<yade.mpy.comm>`, :yref:`rank<yade.mpy.rank>` and :yref:`numProcs<yade.mpy.numProcs>`. Called automatically by :yref:`decompose<yade.mpy.decompose>`."
+	global comm,rank,numProcs
+	from mpi4py import MPI
+	comm=MPI.COMM_WORLD
+	rank,numProcs=comm.Get_rank(),comm.Get_size()
+
+def _states(ids):
+	return O.bodies.stateArray(list(ids)) if len(ids)>0 else numpy.zeros((0,13))
+
+def _slabOf(x):
+	"Rank owning given coordinates along :yref:`axis<yade.mpy.axis>` (array)."
+	return numpy.clip(numpy.searchsorted(bounds,x,side='right')-1,0,numProcs-1)
+
+def _slabDist(x,r):
+	"Distance of coordinates *x* (array) from slab *r*."
+	return numpy.maximum(numpy.maximum(bounds[r]-x,x-bounds[r+1]),0.)
+
+def _defaultHalo(ids):
+	"2.2 × largest radius of dynamic spheres plus twice the collider's :yref:`verletDist<InsertionSortCollider.verletDist>`."
+	rr=numpy.array([O.bodies[i].shape.radius for i in ids if isinstance(O.bodies[i].shape,Sphere)])
+	if len(rr)==0: raise RuntimeError('yade.mpy: halo must be given explicitly when there are no dynamic spheres.')
+	verlet=0.
+	for e in O.engines:
+		if isinstance(e,InsertionSortCollider): verlet=(e.verletDist if e.verletDist>=0 else -e.verletDist*rr.min())
+	return 2.2*rr.max()+2*verlet
+
+def _local(g):
+	"Local ids of bodies with global ids *g* (array), -1 for those which are not on this process."
+	g=numpy.asarray(g,dtype=numpy.int64)
+	used=numpy.flatnonzero(gids>=0)
+	if len(used)==0: return -numpy.ones(len(g),dtype=numpy.int64)
+	order=used[numpy.argsort(gids[used])]
+	pos=numpy.minimum(numpy.searchsorted(gids[order],g),len(order)-1)
+	return numpy.where(gids[order[pos]]==g,order[pos],-1)
+
+def _insert(data,g,subdomain):
+	"Insert serialized bodies with global ids *g* at free local ids; return their local ids."
+	global gids
+	free=numpy.flatnonzero(gids<0)[:len(g)]
+	ids=numpy.concatenate([free,numpy.arange(len(gids),len(gids)+len(g)-len(free))]).astype(numpy.int64)
+	if len(ids)>0 and ids[-1]>=len(gids): gids=numpy.concatenate([gids,-numpy.ones(ids[-1]+1-len(gids),dtype=numpy.int64)])
+	O.bodies.deserialize(data,ids.tolist())
+	gids[ids]=g
+	for i,s in zip(ids.tolist(),numpy.broadcast_to(subdomain,len(ids)).tolist()): O.bodies[i].subdomain=int(s)
+	return ids
+
+def _erase(ids):
+	for i in ids.tolist(): O.bodies.erase(i)
+	gids[ids]=-1
+
+def _alltoallv(send,dtype):
+	"Send 1d array *send[r]* to every rank *r* and return the list of arrays received from all ranks."
+	from mpi4py import MPI
+	mpiType={numpy.int64:MPI.INT64_T,numpy.float64:MPI.DOUBLE,numpy.uint8:MPI.BYTE}[dtype]
+	counts=numpy.array([len(a) for a in send],dtype='i'); rcounts=numpy.empty(numProcs,dtype='i')
+	comm.Alltoall(counts,rcounts)
+	displ=numpy.concatenate([[0],numpy.cumsum(counts)[:-1]]).astype('i'); rdispl=numpy.concatenate([[0],numpy.cumsum(rcounts)[:-1]]).astype('i')
+	sbuf=numpy.concatenate([numpy.asarray(a,dtype=dtype) for a in send]); rbuf=numpy.empty(rcounts.sum(),dtype=dtype)
+	comm.Alltoallv([sbuf,(counts,displ),mpiType],[rbuf,(rcounts,rdispl),mpiType])
+	return [rbuf[rdispl[r]:rdispl[r]+rcounts[r]] for r in range(numProcs)]
+
+def decompose(axis=None,halo=None,rebalancePeriod=0,exchangeEngine=True):
+	"""Cut the scene built at the root process into slabs and distribute them; on return, every process holds only bodies it owns, its ghosts and replicated non-dynamic bodies.
+
+	:param axis: axis along which slabs are cut; if not given, the one with the largest extent of dynamic bodies.
+	:param halo: width of the ghost layer; by default computed by :yref:`yade.mpy._defaultHalo` (it must exceed the largest interaction range between dynamic bodies).
+	:param rebalancePeriod: see :yref:`rebalancePeriod<yade.mpy.rebalancePeriod>`.
+	:param exchangeEngine: append :yref:`PyRunner` calling :yref:`exchange<yade.mpy.exchange>` at every step to :yref:`O.engines<Omega.engines>`.
+
+	:yref:`O.dt<Omega.dt>` is taken from the root process.
+	"""
+	import sys; self=sys.modules[__name__]
+	global gids,owned
+	if comm is None: initialize()
+	if comm.bcast(len(O.materials),root=0)!=len(O.materials): raise RuntimeError('yade.mpy: O.materials must be the same on all processes.')
+	parts=None
+	if rank==0:
+		if any(b.isClump or b.isClumpMember for b in O.bodies): raise NotImplementedError('yade.mpy: clumps are not supported.')
+		ids=numpy.array(O.bodies.ids(),dtype=numpy.int64)
+		dyn=numpy.array([O.bodies[i].dynamic for i in ids.tolist()],dtype=bool)
+		fixed,ids=ids[~dyn],ids[dyn]
+		pos=_states(ids)[:,:3]
+		self.axis=(axis if axis!=None else int(numpy.argmax(pos.max(axis=0)-pos.min(axis=0))))
+		self.halo=(halo if halo!=None else _defaultHalo(ids))
+		x=numpy.sort(pos[:,self.axis])
+		self.bounds=numpy.array([-numpy.inf]+[x[(len(x)*i)//numProcs] for i in range(1,numProcs)]+[numpy.inf])
+		x=pos[:,self.axis]
+		owner=_slabOf(x)
+		parts=[]
+		for r in range(numProcs):
+			sel=(owner==r)|(_slabDist(x,r)<=self.halo)
+			g=numpy.concatenate([fixed,ids[sel]])
+			parts.append((g,numpy.concatenate([-numpy.ones(len(fixed),dtype=numpy.int64),owner[sel]]),O.bodies.serialize(g.tolist())))
+	self.axis,self.halo,self.bounds,O.dt=comm.bcast((self.axis,self.halo,self.bounds,O.dt),root=0)
+	self.rebalancePeriod=rebalancePeriod
+	_checkWidths()
+	g,subdomain,data=comm.scatter(parts,root=0)
+	parts=None
+	O.interactions.clear(); O.bodies.clear()
+	gids=numpy.zeros(0,dtype=numpy.int64)
+	ids=_insert(data,g,subdomain)
+	owned=ids[subdomain==rank]
+	x=_states(owned)[:,self.axis]
+	self.sent=dict((r,numpy.sort(gids[owned[_slabDist(x,r)<=self.halo]])) for r in range(numProcs) if r!=rank)
+	if exchangeEngine: O.engines=O.engines+[PyRunner(iterPeriod=1,command='from yade import mpy; mpy.exchange()',label='mpyExchange')]
+
+def _checkWidths():
+	for r in range(1,numProcs-1):
+		if bounds[r+1]-bounds[r]<=halo: raise RuntimeError('yade.mpy: slab %d is narrower (%g) than halo (%g); use fewer processes.'%(r,bounds[r+1]-bounds[r],halo))
+
+def exchange():
+	"""Synchronize ghosts with their owners and migrate bodies between processes; called after :yref:`NewtonIntegrator` at every step. Each process sends to every other one, as global ids:
+
+	* ``drop``: ghosts the receiver no longer needs (erased there);
+	* ``upd``: ghosts the receiver already has, with their :yref:`states<BodyContainer.stateArray>`;
+	* ``own``: bodies which moved into the receiver's slab (the receiver becomes their owner); ``kept`` lists those of them the sender keeps as ghosts;
+	* ``new``: bodies the receiver newly needs (inserted as ghosts), serialized.
+
+	Ids and states go in one integer and one float buffer per receiver, serialized bodies in a byte buffer; each kind is exchanged with a single ``Alltoallv``.
+	"""
+	global owned
+	if rebalancePeriod>0 and O.iter>0 and O.iter%rebalancePeriod==0: rebalance()
+	st=_states(owned)
+	x=st[:,axis]
+	g=gids[owned]
+	newOwner=_slabOf(x)
+	staying=(newOwner==rank)
+	leaving=~staying
+	keep=leaving&(_slabDist(x,rank)<=halo)
+	ints=[numpy.zeros(0,dtype=numpy.int64)]*numProcs; reals=[numpy.zeros(0)]*numProcs; raw=[numpy.zeros(0,dtype=numpy.uint8)]*numProcs
+	for r in range(numProcs):
+		if r==rank: continue
+		# bodies given away are sent to the new owner only; other processes drop them and the new owner ships them again if needed
+		need=(staying&(_slabDist(x,r)<=halo))|(newOwner==r)
+		had=numpy.in1d(g,sent[r],assume_unique=True)
+		upd,new,own=need&had,need&~had,(newOwner==r)
+		drop=numpy.setdiff1d(sent[r],g[need],assume_unique=True)
+		ints[r]=numpy.concatenate([[len(drop),upd.sum(),own.sum(),(keep&own).sum(),new.sum()],drop,g[upd],g[own],g[keep&own],g[new]]).astype(numpy.int64)
+		reals[r]=st[upd].ravel()
+		if new.any(): raw[r]=numpy.frombuffer(O.bodies.serialize(owned[new].tolist()),dtype=numpy.uint8)
+		sent[r]=numpy.sort(g[need&staying])
+	# bodies leaving this process entirely
+	for i,o in zip(owned[keep].tolist(),newOwner[keep].tolist()): O.bodies[i].subdomain=o
+	_erase(owned[leaving&~keep])
+	owned=owned[staying]
+	ints,reals,raw=_alltoallv(ints,numpy.int64),_alltoallv(reals,numpy.float64),_alltoallv(raw,numpy.uint8)
+	for src in range(numProcs):
+		if src==rank or len(ints[src])==0: continue
+		nDrop,nUpd,nOwn,nKept,nNew=ints[src][:5]
+		drop,upd,own,kept,new=numpy.split(ints[src][5:],numpy.cumsum([nDrop,nUpd,nOwn,nKept]))
+		if nDrop>0:
+			drop=_local(drop); drop=drop[drop>=0]
+			_erase(numpy.array([i for i in drop.tolist() if O.bodies[i].subdomain!=rank],dtype=numpy.int64))
+		if nNew>0: _insert(raw[src].tostring(),new,src)
+		if nUpd>0: O.bodies.setStateArray(_local(upd).tolist(),reals[src].reshape(nUpd,13))
+		if nOwn>0:
+			own=_local(own)
+			for i in own.tolist(): O.bodies[i].subdomain=rank
+			owned=numpy.concatenate([owned,own])
+			sent[src]=numpy.union1d(sent[src],kept)
+
+def rebalance():
+	"""Move slab boundaries so that every process has about the same amount of work. The cost of each process is its engine time since the last call (requires :yref:`O.timingEnabled<Omega.timingEnabled>`; otherwise, the number of owned bodies is balanced); it is spread evenly over its owned bodies and boundaries are put at weighted quantiles of all owned bodies' positions. Bodies are migrated by the next :yref:`exchange<yade.mpy.exchange>`."""
+	global _lastTime
+	from mpi4py import MPI
+	t=sum(e.execTime for e in O.engines) if O.timingEnabled else 0
+	cost,_lastTime=max(t-_lastTime,1),t
+	x=_states(owned)[:,axis]
+	w=numpy.ones(len(x))*(cost/float(max(len(x),1)) if O.timingEnabled else 1.)
+	counts=numpy.array(comm.allgather(len(x)),dtype='i'); displ=numpy.concatenate([[0],numpy.cumsum(counts)[:-1]]).astype('i')
+	xx,ww=numpy.empty(counts.sum()),numpy.empty(counts.sum())
+	comm.Allgatherv(numpy.ascontiguousarray(x),[xx,(counts,displ),MPI.DOUBLE]); comm.Allgatherv(w,[ww,(counts,displ),MPI.DOUBLE])
+	order=numpy.argsort(xx); xx,cw=xx[order],numpy.cumsum(ww[order])
+	splits=[xx[min(numpy.searchsorted(cw,cw[-1]*r/numProcs),len(xx)-1)] for r in range(1,numProcs)]
+	bounds[1:-1]=splits
+	_checkWidths()
+def ownsInteraction(i):
+	"Whether interaction *i* is accounted for by this process: it is owned by the owner of :yref:`id1<Interaction.id1>`, or of :yref:`id2<Interaction.id2>` if the former is replicated on all processes."
+	s=O.bodies[i.id1].subdomain
+	if s<0: s=O.bodies[i.id2].subdomain
+	return s==rank
+
+def sharedForce(ids):
+	"Total force from interactions exerted on replicated bodies *ids* (local ids, e.g. of walls), summed over all processes. Only interactions with :yref:`NormShearPhys` are considered."
+	F=Vector3.Zero
+	for id in ids:
+		for i in O.interactions.withBody(id):
+			if not i.isReal or not ownsInteraction(i): continue
+			f=i.phys.normalForce+i.phys.shearForce
+			F+=(-f if i.id1==id else f)
+	return Vector3(comm.allreduce(numpy.array(F),op=_sum()))
+
+def _sum():
+	from mpi4py import MPI
+	return MPI.SUM
+
+def unbalancedForce():
+	"Like :yref:`yade._utils.unbalancedForce`, over all processes (owned bodies and owned interactions only)."
+	ids=[int(i) for i in owned]
+	f=sum(O.forces.f(i).norm() for i in ids)
+	n=0; fi=0.
+	for i in O.interactions:
+		if i.isReal and ownsInteraction(i): fi+=(i.phys.normalForce+i.phys.shearForce).norm(); n+=1
+	f,nb,fi,n=comm.allreduce(numpy.array([f,len(ids),fi,n]),op=_sum())
+	return (f/nb)/(fi/n) if n>0 and nb>0 else float('nan')
+
+def gatherStates(root=0):
+	"Collect global ids and :yref:`states<BodyContainer.stateArray>` of all dynamic bodies at *root* (sorted by id); returns ``(ids,states)`` there and ``(None,None)`` on other processes."
+	data=comm.gather((gids[owned],_states(owned)),root=root)
+	if rank!=root: return None,None
+	ids=numpy.concatenate([d[0] for d in data]); st=numpy.concatenate([d[1] for d in data])
+	order=numpy.argsort(ids)
+	return ids[order],st[order]
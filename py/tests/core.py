@@ -79,9 +79,62 @@ class TestLoop(unittest.TestCase):
 		'Loop: dead engines are not run'
 		O.engines=[PyRunner(dead=True,initRun=True,iterPeriod=1,command='pass')]
 		O.step(); self.assert_(O.engines[0].nDone==0)
+	def testRunScenes(self):
+		'Loop: O.runScenes advances scenes concurrently, python engines see their own scene'
+		ids=[O.addScene() for i in range(4)]
+		for i in ids:
+			O.switchToScene(i)
+			O.bodies.append(utils.sphere((0,0,0),1))
+			O.engines=[ForceResetter(),NewtonIntegrator(damping=0,gravity=(0,0,-i)),PyRunner(iterPeriod=1,command='O.tags["iter"]=str(O.iter)')]
+			O.dt=1e-3
+		O.switchToScene(0)
+		O.runScenes(ids,nSteps=10,threads=2)
+		self.assert_(O.iter==0)
+		O.runScenes(ids,time=5.5e-3)
+		for i in ids:
+			O.switchToScene(i)
+			self.assert_(O.iter==16 and O.tags['iter']=='16')
+			self.assertAlmostEqual(O.bodies[0].state.vel[2],-i*16e-3)
+		O.switchToScene(0)
+		self.assertRaises(RuntimeError,lambda: O.runScenes(ids))
+		self.assertRaises(RuntimeError,lambda: O.runScenes([ids[0],ids[0]],nSteps=1))
 			
 
 
+class TestDeterministic(unittest.TestCase):
+	def setUp(self): O.reset()
+	def simulate(self,nThreads):
+		from yade import pack
+		O.reset()
+		O.bodies.append(utils.aabbWalls([(0,0,0),(1,1,1)],thickness=.1))
+		sp=pack.SpherePack(); sp.makeCloud((0,0,0),(1,1,1),rMean=.04,rRelFuzz=.3,seed=1)
+		sp.toSimulation()
+		O.engines=[
+			ForceResetter(),
+			InsertionSortCollider([Bo1_Sphere_Aabb(),Bo1_Box_Aabb()]),
+			InteractionLoop([Ig2_Sphere_Sphere_ScGeom(),Ig2_Box_Sphere_ScGeom()],[Ip2_FrictMat_FrictMat_FrictPhys()],[Law2_ScGeom_FrictPhys_CundallStrack()]),
+			NewtonIntegrator(damping=.2,gravity=(0,0,-9.81)),
+		]
+		for e in O.engines: e.ompThreads=nThreads
+		O.dt=.5*utils.PWaveTimeStep()
+		O.deterministic=True; O.trackEnergy=True
+		O.run(300,True)
+		return [b.state.pos for b in O.bodies],dict(O.energy.items()),len(O.interactions)
+	def testThreadIndependent(self):
+		"Deterministic: positions and energies are bitwise the same for 1 and all threads"
+		# engines cannot use more threads than OpenMP allows, which is 1 unless yade is run with -j
+		if O.numThreads<2: self.skipTest('needs at least 2 OpenMP threads, run as yade -j2 --test')
+		pos1,en1,n1=self.simulate(1)
+		posN,enN,nN=self.simulate(O.numThreads)
+		self.assert_(n1==nN)
+		self.assert_(all(p1==pN for p1,pN in zip(pos1,posN)))
+		self.assert_(en1==enN)
+	def testInteractionsSorted(self):
+		"Deterministic: interactions are traversed in the order of ids"
+		self.simulate(O.numThreads)
+		ids=[(min(i.id1,i.id2),max(i.id1,i.id2)) for i in O.interactions]
+		self.assert_(ids==sorted(ids))
+
 class TestIO(unittest.TestCase):
 	def testSaveAllClasses(self):
 		'I/O: All classes can be saved and loaded with boost::serialization'
@@ -97,6 +150,35 @@ class TestIO(unittest.TestCase):
 				failed.add(c)
 		failed=list(failed); failed.sort()
 		self.assert_(len(failed)==0,'Failed classes were: '+' '.join(failed))
+	def testPrefetchedTmp(self):
+		'I/O: loadTmp of a prefetched saveTmp restores the saved state every time'
+		O.reset()
+		O.bodies.append(utils.sphere((0,0,0),1))
+		O.engines=[ForceResetter(),NewtonIntegrator(gravity=(0,0,-10))]
+		O.dt=1e-3
+		O.saveTmp('prefetch',quiet=True,prefetch=True)
+		for i in range(3):
+			O.loadTmp('prefetch',quiet=True)
+			self.assert_(O.iter==0 and O.bodies[0].state.pos==Vector3(0,0,0))
+			O.run(10,True)
+			self.assert_(O.bodies[0].state.pos[2]<0)
+
+class TestPoolStats(unittest.TestCase):
+	def testCounters(self):
+		'Pool: O.poolStats counts allocations in the background simulation thread, and resets'
+		O.reset()
+		O.bodies.append([utils.sphere((0,0,0),.5),utils.sphere((0,0,1.2),.5)])
+		O.bodies[1].state.vel=(0,0,-1)
+		O.engines=[ForceResetter(),InsertionSortCollider([Bo1_Sphere_Aabb()]),InteractionLoop([Ig2_Sphere_Sphere_ScGeom()],[Ip2_FrictMat_FrictMat_FrictPhys()],[Law2_ScGeom_FrictPhys_CundallStrack()]),NewtonIntegrator()]
+		O.dt=1e-3
+		O.poolStats(reset=True)
+		# not waiting in run(), so that steps are computed by the ThreadRunner thread
+		O.run(500); O.wait()
+		stats=O.poolStats(reset=True)
+		self.assert_(sorted(stats.keys())==['allocated','freed','released','reused'])
+		# ScGeom of the contact is pooled
+		self.assert_(stats['allocated']+stats['reused']>=1)
+		self.assert_(all(v==0 for v in O.poolStats().values()))
 
 class TestMaterialStateAssociativity(unittest.TestCase):
 	def setUp(self): O.reset()
@@ -147,6 +229,69 @@ class TestBodies(unittest.TestCase):
 			if O.bodies[id]: O.bodies.erase(id);removed+=1
 		for b in O.bodies: counted+=1
 		self.assert_(counted==self.count-removed)
+	def testBulkAccessors(self):
+		"Bodies: numpy bulk accessors match per-body values, setters write them back"
+		O.bodies.erase(3)
+		ids=O.bodies.ids()
+		self.assert_(len(ids)==self.count-1 and 3 not in ids)
+		pos,rad=O.bodies.positions(),O.bodies.radii()
+		for row,id in enumerate(ids):
+			self.assert_(Vector3(pos[row])==O.bodies[id].state.pos)
+			self.assert_(rad[row]==O.bodies[id].shape.radius)
+		O.bodies.setVelocities(ids,pos)
+		self.assert_(O.bodies[ids[-1]].state.vel==Vector3(pos[-1]))
+		O.bodies.setBlockedDOFs(ids[:2],'xyz')
+		self.assert_(O.bodies[ids[1]].state.blockedDOFs=='xyz')
+	def testAppendSpheres(self):
+		"Bodies: appendSpheres creates the same bodies as utils.sphere"
+		import numpy
+		first,last=O.bodies.appendSpheres(numpy.array([[0,0,0],[1,2,3]]),numpy.array([.5,.25]),mask=5,dynamic=False)
+		self.assert_((first,last)==(self.count,self.count+2) and len(O.bodies)==self.count+2)
+		ref,b=utils.sphere((1,2,3),.25),O.bodies[last-1]
+		self.assert_(b.state.pos==Vector3(1,2,3) and b.shape.radius==.25 and b.mask==5 and not b.dynamic)
+		self.assertAlmostEqual(b.state.mass,ref.state.mass)
+		self.assert_(b.mat==O.bodies[0].mat)
+		self.assertRaises(ValueError,lambda: O.bodies.appendSpheres(numpy.zeros((2,3)),numpy.array([1.])))
+	def testStateArray(self):
+		"Bodies: setStateArray(stateArray()) round-trips, rows follow ids"
+		import numpy
+		ids=[5,2,7]
+		O.bodies[2].state.ori=Quaternion((0,0,1),.5); O.bodies[7].state.angVel=Vector3(1,2,3)
+		st=O.bodies.stateArray(ids)
+		self.assert_(st.shape==(3,13))
+		self.assert_(Vector3(st[1][:3])==O.bodies[2].state.pos and Vector3(st[2][10:])==Vector3(1,2,3))
+		self.assertAlmostEqual(st[1][3],cos(.25)); self.assertAlmostEqual(st[1][6],sin(.25)) # w,x,y,z
+		O.bodies.setStateArray(ids,numpy.zeros((3,13)))
+		self.assert_(O.bodies[5].state.pos==Vector3.Zero)
+		O.bodies.setStateArray(ids,st)
+		self.assert_((O.bodies.stateArray(ids)==st).all())
+		self.assertRaises(ValueError,lambda: O.bodies.setStateArray(ids,numpy.zeros((2,13))))
+	def testSerialize(self):
+		"Bodies: deserialize(serialize()) restores bodies under their ids, sharing materials"
+		data=O.bodies.serialize([3,4])
+		pos,rad=O.bodies[4].state.pos,O.bodies[4].shape.radius
+		O.bodies.erase(3); O.bodies.erase(4)
+		self.assert_(list(O.bodies.deserialize(data))==[3,4])
+		self.assert_(O.bodies[4].state.pos==pos and O.bodies[4].shape.radius==rad and O.bodies[4].id==4)
+		self.assert_(O.bodies[3].mat==O.bodies[0].mat)
+		# existing bodies are replaced
+		O.bodies[4].state.pos=Vector3(9,9,9)
+		O.bodies.deserialize(data)
+		self.assert_(O.bodies[4].state.pos==pos and len(O.bodies)==self.count)
+		# under other ids
+		self.assert_(list(O.bodies.deserialize(data,[self.count+1,self.count]))==[self.count+1,self.count])
+		self.assert_(O.bodies[self.count].state.pos==pos and O.bodies[self.count].id==self.count)
+		self.assertRaises(ValueError,lambda: O.bodies.deserialize(data,[1]))
+	def testInsertAtId(self):
+		"Bodies: insertAtId fills free ids (also past the end), refuses occupied ones"
+		O.bodies.erase(10)
+		pos0=O.bodies[0].state.pos
+		self.assert_(O.bodies.insertAtId(utils.sphere((1,1,1),.1),10)==10)
+		self.assert_(O.bodies[10].id==10 and O.bodies[10].shape.radius==.1)
+		self.assert_(O.bodies.insertAtId(utils.sphere((1,1,1),.1),self.count+5)==self.count+5)
+		self.assert_(O.bodies[self.count+5].id==self.count+5 and O.bodies[self.count]==None)
+		self.assertRaises(IndexError,lambda: O.bodies.insertAtId(utils.sphere((0,0,0),.1),0))
+		self.assert_(O.bodies[0].state.pos==pos0)
 	def testErasedAndNewlyCreatedSphere(self):
 		"Bodies: The bug is described in LP:1001194. If the new body was created after deletion of previous, it has no bounding box"
 		O.reset()
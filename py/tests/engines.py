@@ -55,3 +55,270 @@ class TestKinematicEngines(unittest.TestCase):
 			self.assertTrue(abs(O.bodies[id_nonfixed_helix].state.pos[1]-25.0 - O.iter)<tolerance)		#Check helixEngine of nonfixed bodies Z
 
 
+
+class TestEnergy(unittest.TestCase):
+	def testEnergyInterval(self):
+		'Engines: kinetic energy is evaluated only every EnergyTracker.interval steps'
+		O.reset()
+		id=O.bodies.append(utils.sphere((0,0,0),1.0))
+		O.engines=[ForceResetter(),NewtonIntegrator(damping=0)]
+		O.trackEnergy=True
+		O.energy.interval=2
+		O.dt=1e-3
+		m=O.bodies[id].state.mass
+		O.bodies[id].state.vel=(1,0,0)
+		O.step()
+		self.assertAlmostEqual(O.energy['kinetic'],.5*m)
+		O.bodies[id].state.vel=(2,0,0)
+		O.step() # not evaluated, the previous value is kept
+		self.assertAlmostEqual(O.energy['kinetic'],.5*m)
+		O.step()
+		self.assertAlmostEqual(O.energy['kinetic'],2*m)
+
+class TestMacroQuantities(unittest.TestCase):
+	def testMatchesUtils(self):
+		'Engines: MacroQuantities gives the same values as utils functions'
+		O.reset()
+		O.periodic=True
+		O.cell.hSize=Matrix3(2,0,0, 0,2,0, 0,0,2)
+		for i in range(5): O.bodies.append(utils.sphere((.5+.25*i,.5+.1*i,1),.3))
+		O.bodies[1].state.vel=(1,0,0)
+		mq=MacroQuantities(iterPeriod=1)
+		O.engines=[ForceResetter(),InsertionSortCollider([Bo1_Sphere_Aabb()]),InteractionLoop([Ig2_Sphere_Sphere_ScGeom()],[Ip2_FrictMat_FrictMat_FrictPhys()],[Law2_ScGeom_FrictPhys_CundallStrack()]),mq,NewtonIntegrator()]
+		O.dt=1e-5
+		O.step(); O.step()
+		self.assert_(mq.iterComputed==O.iter-1 and mq.numContacts==O.interactions.countReal())
+		mq.compute() # velocities changed in NewtonIntegrator
+		self.assert_(mq.iterComputed==O.iter)
+		self.assertAlmostEqual(mq.kineticEnergy,utils.kineticEnergy(),delta=1e-3*mq.kineticEnergy)
+		s=utils.getStress()
+		for i in range(3): self.assertAlmostEqual(mq.stress[i,i],s[i,i],delta=1e-6*abs(s[i,i]))
+		self.assertAlmostEqual(mq.fabric.trace(),1)
+
+class TestTrajectoryRecorder(unittest.TestCase):
+	def testRoundTrip(self):
+		'Engines: TrajectoryRecorder frames are read back by yade.trajectory, with and without compression'
+		import os,tempfile
+		from yade import trajectory
+		for compress,keyframe in (False,0),(True,3):
+			O.reset()
+			for i in range(4): O.bodies.append(utils.sphere((i,0,0),.1+.1*i))
+			O.bodies[2].state.vel=(0,1,0)
+			fName=tempfile.mktemp(suffix='.trj')
+			O.engines=[ForceResetter(),NewtonIntegrator(),TrajectoryRecorder(iterPeriod=1,fileName=fName,columns=['pos','vel','radius'],compress=compress,keyframeInterval=keyframe)]
+			O.dt=1e-2
+			O.run(5,True)
+			t=trajectory.Trajectory(fName)
+			self.assert_(len(t)==5 and list(t.iters)==[0,1,2,3,4])
+			f=t[-1]
+			self.assert_(list(f['id'])==[0,1,2,3] and f['pos'].shape==(4,3))
+			self.assert_(Vector3(f['vel'][2])==Vector3(0,1,0) and f['radius'][3,0]==O.bodies[3].shape.radius)
+			self.assertAlmostEqual(f['pos'][2,1],O.bodies[2].state.pos[1])
+			os.remove(fName); os.remove(fName+'.idx')
+
+class TestHydroForceEngine(unittest.TestCase):
+	def testLaminarFluidProfile(self):
+		'Engines: HydroForceEngine.fluidResolution converges to the laminar open-channel profile without particles'
+		O.reset()
+		h=HydroForceEngine(nCell=20,deltaZ=.01,zRef=0,vCell=1,kappa=0,viscoDyn=1,densFluid=1000,gravity=(.01,0,-9.81))
+		h.fluidResolution(2000,1.)
+		nu,H=1e-3,.2
+		for j in (0,10,19):
+			z=(j+.5)*h.deltaZ
+			self.assertAlmostEqual(h.vxFluid[j],.01/nu*(H*z-z**2/2),delta=.02*.01/nu*H**2/2)
+
+class TestSpatialRenumberer(unittest.TestCase):
+	def testConsistency(self):
+		'Engines: SpatialRenumberer keeps bodies, clumps and interactions consistent'
+		import random
+		O.reset()
+		random.seed(1)
+		O.bodies.append(utils.wall(0,axis=2,sense=1))
+		for i in range(60): O.bodies.append(utils.sphere((random.random(),random.random(),.05+.5*random.random()),.05))
+		O.bodies.appendClumped([utils.sphere((.5,.5,.8),.05),utils.sphere((.55,.5,.8),.05)])
+		O.bodies.erase(5)
+		O.engines=[ForceResetter(),InsertionSortCollider([Bo1_Sphere_Aabb(),Bo1_Wall_Aabb()]),InteractionLoop([Ig2_Sphere_Sphere_ScGeom(),Ig2_Wall_Sphere_ScGeom()],[Ip2_FrictMat_FrictMat_FrictPhys()],[Law2_ScGeom_FrictPhys_CundallStrack()]),NewtonIntegrator(gravity=(0,0,-9.81)),SpatialRenumberer(firstId=1,iterPeriod=1000,label='renumberer')]
+		O.dt=.5*utils.PWaveTimeStep()
+		O.run(20,True)
+		pos=dict((b.id,b.state.pos) for b in O.bodies)
+		nIntrs=len([i for i in O.interactions])
+		renumberer.renumber()
+		newIds=renumberer.newIds
+		self.assert_(newIds[0]==0 and newIds[5]==-1 and len(O.bodies)==len(pos))
+		for old,p in pos.items(): self.assert_(O.bodies[newIds[old]].state.pos==p and O.bodies[newIds[old]].id==newIds[old])
+		self.assert_(len([i for i in O.interactions])==nIntrs)
+		for i in O.interactions: self.assert_(O.interactions[i.id2,i.id1].id1==i.id1 and O.bodies[i.id1] and O.bodies[i.id2])
+		clump=[b for b in O.bodies if b.isClump][0]
+		members=clump.shape.members.keys()
+		self.assert_(len(members)==2 and all(O.bodies[m].clumpId==clump.id and m<clump.id for m in members))
+		O.run(20,True)
+	def testErasedBelowFirstId(self):
+		'Engines: SpatialRenumberer keeps collider bounds and per-body engine data of empty slots below firstId'
+		O.reset()
+		for i in range(20): O.bodies.append(utils.sphere((.1*(19-i),0,0),.06))
+		O.bodies.erase(2)
+		O.engines=[ForceResetter(),InsertionSortCollider([Bo1_Sphere_Aabb()],label='collider'),InteractionLoop([Ig2_Sphere_Sphere_ScGeom()],[Ip2_FrictMat_FrictMat_FrictPhys()],[Law2_ScGeom_FrictPhys_CundallStrack()],label='loop'),NewtonIntegrator(),SpatialRenumberer(firstId=5,iterPeriod=1000,label='renumberer')]
+		O.dt=.5*utils.PWaveTimeStep()
+		O.run(2,True)
+		loop.levels=range(20)
+		renumberer.renumber()
+		newIds=renumberer.newIds
+		self.assert_(newIds[2]==2 and len(O.bodies)==20)
+		self.assert_(all(loop.levels[newIds[i]]==i for i in range(20)))
+		loop.levels=[]
+		O.run(2,True)
+		self.assert_(all(len(bb)==2*len(O.bodies) for bb in collider.dumpBounds()))
+
+class TestSleepingEngine(unittest.TestCase):
+	def testSleepAndWake(self):
+		'Engines: SleepingEngine puts settled bodies to sleep and wakes them up on imposed motion'
+		O.reset()
+		O.bodies.append(utils.wall(0,axis=2,sense=1))
+		for i in range(4): O.bodies.append(utils.sphere((i,0,.1),.1))
+		O.engines=[ForceResetter(),InsertionSortCollider([Bo1_Sphere_Aabb(),Bo1_Wall_Aabb()]),InteractionLoop([Ig2_Wall_Sphere_ScGeom()],[Ip2_FrictMat_FrictMat_FrictPhys()],[Law2_ScGeom_FrictPhys_CundallStrack()]),SleepingEngine(velThreshold=1e-3,forceThreshold=.05,nQuiet=10,label='sleeper'),NewtonIntegrator(damping=.4,gravity=(0,0,-9.81))]
+		O.dt=.5*utils.PWaveTimeStep()
+		O.run(5000,True)
+		self.assert_(sleeper.nSleeping==4 and sleeper.nSleepingIslands==4 and all(O.bodies[i].sleeping for i in range(1,5)))
+		self.assert_(not O.bodies[0].sleeping)
+		pos=O.bodies[2].state.pos
+		O.run(10,True)
+		self.assert_(O.bodies[2].state.pos==pos)
+		O.bodies[1].state.vel=(1,0,0)
+		O.step()
+		self.assert_(not O.bodies[1].sleeping and O.bodies[2].sleeping and sleeper.nWoken==1)
+
+class TestMultiRateTimeStepper(unittest.TestCase):
+	def testLevelsAndMomentum(self):
+		'Engines: MultiRateTimeStepper puts large bodies to higher levels, held interactions conserve momentum'
+		O.reset()
+		big1=O.bodies.append(utils.sphere((0,0,0),1))
+		big2=O.bodies.append(utils.sphere((1.999,0,0),1))
+		small=O.bodies.append(utils.sphere((10,10,10),.1))
+		O.bodies[big1].state.vel=(1,0,0)
+		O.engines=[ForceResetter(),InsertionSortCollider([Bo1_Sphere_Aabb()]),InteractionLoop([Ig2_Sphere_Sphere_ScGeom()],[Ip2_FrictMat_FrictMat_FrictPhys()],[Law2_ScGeom_FrictPhys_CundallStrack()],label='loop'),MultiRateTimeStepper(nLevels=4,timeStepUpdateInterval=10,label='mrts'),NewtonIntegrator(damping=0)]
+		momentum=lambda: sum([b.state.mass*b.state.vel for b in O.bodies],Vector3.Zero)
+		p0=momentum()
+		O.run(500,True)
+		self.assert_(loop.levels[big1]==3 and loop.levels[big2]==3 and loop.levels[small]==0)
+		self.assert_(mrts.levelCounts==[1,0,0,2])
+		self.assert_(O.bodies[big2].state.vel[0]>0)
+		self.assertAlmostEqual((momentum()-p0).norm()/p0.norm(),0,delta=1e-9)
+
+class TestTriMesh(unittest.TestCase):
+	def testContacts(self):
+		'Engines: Ig2_TriMesh_Sphere_ScGeom gives one contact on flat parts regardless of tessellation, sums faces of concave corners'
+		O.reset()
+		n=8
+		vv=[(i/float(n),j/float(n),0) for i in range(n+1) for j in range(n+1)]+[(0,0,1),(0,1,1)]
+		tt=[]
+		for i in range(n):
+			for j in range(n):
+				a=i*(n+1)+j; b=a+n+1; tt+=[(a,b,b+1),(a,b+1,a+1)]
+		tt+=[(0,n,len(vv)-1),(0,len(vv)-1,len(vv)-2)] # wall at x=0
+		mesh=O.bodies.append(utils.triMesh(vv,tt))
+		self.assert_(O.bodies[mesh].shape.nNodes>1)
+		flat,vertex,corner=O.bodies.append([utils.sphere((.53,.41,.09),.1),utils.sphere((.5,.5,.09),.1),utils.sphere((.08,.5,.07),.1)])
+		O.engines=[ForceResetter(),InsertionSortCollider([Bo1_Sphere_Aabb(),Bo1_TriMesh_Aabb()]),InteractionLoop([Ig2_TriMesh_Sphere_ScGeom()],[Ip2_FrictMat_FrictMat_FrictPhys()],[Law2_ScGeom_FrictPhys_CundallStrack()]),NewtonIntegrator()]
+		O.dt=1e-8
+		O.step()
+		geom=lambda id: O.interactions[mesh,id].geom
+		for id in flat,vertex:
+			self.assertAlmostEqual(geom(id).penetrationDepth,.01)
+			self.assertAlmostEqual((geom(id).normal-Vector3(0,0,1)).norm(),0)
+		self.assertAlmostEqual(geom(corner).penetrationDepth,sqrt(.02**2+.03**2))
+		# moved mesh
+		O.bodies[mesh].state.pos=O.bodies[mesh].state.pos+Vector3(0,0,.005)
+		O.step()
+		self.assertAlmostEqual(geom(flat).penetrationDepth,.015)
+
+class TestVoxelPorosity(unittest.TestCase):
+	def testSolidFraction(self):
+		'Engines: VoxelPorosity gives sphere volume fraction, more accurately with partial volumes; utils.voxelPorosity agrees'
+		O.reset()
+		O.bodies.append(utils.sphere((.5,.5,.5),.4))
+		exact=(4/3.)*pi*.4**3
+		vp=VoxelPorosity(start=(0,0,0),end=(1,1,1),resolution=40,regions=(2,1,1))
+		vp.compute()
+		self.assert_(vp.gridSize==Vector3i(40,40,40) and vp.nBlocks>0)
+		self.assertAlmostEqual(vp.porosity,1-exact,delta=.01)
+		self.assertAlmostEqual(vp.solidFraction[0],vp.solidFraction[1],delta=1e-6)
+		err=abs(vp.porosity-(1-exact))
+		vp.partialVolumes=True; vp.compute()
+		self.assert_(abs(vp.porosity-(1-exact))<=err)
+		self.assertAlmostEqual(vp.porosity,1-exact,delta=.002)
+		self.assertAlmostEqual(utils.voxelPorosity(100,(0,0,0),(1,1,1)),1-exact,delta=.005)
+
+class TestEventLog(unittest.TestCase):
+	def testPushAndRead(self):
+		'Engines: EventLog merges events in deterministic order, keeps them in memory and writes them to file'
+		from yade import eventlog
+		import os
+		O.reset()
+		O.events.fileName=O.tmpFilename()
+		O.events.push('test',type=2,id1=5,id2=3,pos=(1,2,3),energy=4)
+		O.events.push('test',type=1,id1=1,id2=7)
+		O.events.push('other',id1=0)
+		O.step()
+		ev=eventlog.arrays('test')
+		self.assert_(len(O.events)==3 and O.events.sources()==['test','other'])
+		self.assert_(list(ev['id1'])==[1,5] and list(ev['type'])==[1,2] and all(ev['iter']==0))
+		self.assert_(tuple(ev['pos'][1])==(1,2,3) and ev['energy'][1]==4)
+		O.events.waitForWriter()
+		fromFile,sources=eventlog.read(O.events.fileName,'other')
+		self.assert_(sources==['test','other'] and len(fromFile)==1 and fromFile['id1'][0]==0)
+		self.assert_(len(eventlog.read(O.events.fileName)[0])==3)
+		O.events.clear()
+		self.assert_(len(eventlog.arrays())==0)
+		os.remove(O.events.fileName); os.remove(O.events.fileName+'.sources')
+	def testJCFpmCracks(self):
+		'Engines: broken JCFpm bonds are reported to O.events and written to the cracks file'
+		from yade import eventlog
+		import os
+		O.reset()
+		O.materials.append(JCFpmMat(young=1e8,poisson=.3,frictionAngle=.5,density=2600,tensileStrength=1e6,cohesion=1e6))
+		O.bodies.append([utils.sphere((0,0,0),1,fixed=True),utils.sphere((1.99,0,0),1,fixed=True)])
+		O.engines=[ForceResetter(),InsertionSortCollider([Bo1_Sphere_Aabb()]),InteractionLoop([Ig2_Sphere_Sphere_ScGeom()],[Ip2_JCFpmMat_JCFpmMat_JCFpmPhys(cohesiveTresholdIteration=1)],[Law2_ScGeom_JCFpmPhys_JointedCohesiveFrictionalPM(recordCracks=True,Key='eventLogTest')]),NewtonIntegrator()]
+		O.dt=1e-6
+		O.step()
+		self.assert_(O.interactions[0,1].phys.isCohesive and len(O.events)==0)
+		O.bodies[1].state.pos=(2.5,0,0)
+		O.step()
+		ev=eventlog.arrays('JCFpm')
+		self.assert_(len(ev)==1 and ev['type'][0]==0 and (ev['id1'][0],ev['id2'][0])==(0,1) and ev['iter'][0]==1)
+		self.assert_(ev['energy'][0]>0 and abs(ev['normal'][0][0])==1)
+		O.events.waitForWriter()
+		lines=open('cracks_eventLogTest.txt').readlines()
+		os.remove('cracks_eventLogTest.txt')
+		self.assert_(len(lines)==2 and lines[1].split()[0]=='1' and lines[1].split()[4]=='0')
+
+class TestTriaxialStateFiles(unittest.TestCase):
+	def testRoundTrip(self):
+		'Engines: TesselationWrapper state files are read back identically in text (any whitespace) and binary formats'
+		import os,tempfile,yade.config
+		if 'CGAL' not in yade.config.features: self.skipTest('needs CGAL')
+		O.reset()
+		for i in range(4): O.bodies.append(utils.sphere((.19*i,.05*(i%2),0),.1))
+		O.engines=[ForceResetter(),InsertionSortCollider([Bo1_Sphere_Aabb()]),InteractionLoop([Ig2_Sphere_Sphere_ScGeom()],[Ip2_FrictMat_FrictMat_FrictPhys()],[Law2_ScGeom_FrictPhys_CundallStrack()]),NewtonIntegrator()]
+		O.dt=1e-6
+		O.step()
+		self.assert_(len([i for i in O.interactions if i.isReal])==3)
+		tw=TesselationWrapper()
+		tw.setState(0)
+		names=[tempfile.mktemp() for i in range(6)]
+		def resave(src,dst,binary=False):
+			tw.loadState(src,bz2=False); tw.saveState(dst,bz2=False,binary=binary)
+		tw.saveState(names[0],bz2=False)
+		# normals are recomputed from rounded positions when text is read, compare from the second save on
+		resave(names[0],names[1]); resave(names[1],names[2])
+		text=open(names[2]).read()
+		self.assert_(open(names[1]).read()==text)
+		# records split and joined across lines
+		seps=[' ','\n','\t','  \n ']
+		open(names[3],'w').write(''.join(t+seps[i%4] for i,t in enumerate(text.split())))
+		resave(names[3],names[4])
+		self.assert_(open(names[4]).read()==text)
+		resave(names[1],names[5],binary=True)
+		self.assert_(open(names[5],'rb').read(8)=='YADETS01')
+		resave(names[5],names[4])
+		self.assert_(open(names[4]).read()==text)
+		for n in names: os.remove(n)
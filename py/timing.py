@@ -21,6 +21,7 @@ def _resetEngine(e):
 def reset():
 	"Zero all timing data."
 	for e in O.engines: _resetEngine(e)
+	O.poolStats(reset=True)
 
 _statCols={'label':40,'count':20,'time':20,'relTime':20}
 _maxLev=3
@@ -120,4 +121,8 @@ def stats():
 	print 'Name'.ljust(_statCols['label'])+' '+'Count'.rjust(_statCols['count'])+' '+'Time'.rjust(_statCols['time'])+' '+'Rel. time'.rjust(_statCols['relTime'])
 	print '-'*(sum([_statCols[k] for k in _statCols])+len(_statCols)-1)
 	_engines_stats(O.engines,sum([e.execTime for e in O.engines]),0)
+	pool=O.poolStats()
+	if pool['allocated'] or pool['reused']:
+		print
+		print 'IGeom/IPhys pool: %d blocks allocated, %d reused, %d released, %d freed'%(pool['allocated'],pool['reused'],pool['released'],pool['freed'])
 	print
@@ -0,0 +1,109 @@
+# encoding: utf-8
+# 2026 © Yade developers
+"""
+Read trajectory files written by :yref:`TrajectoryRecorder`.
+
+Uncompressed frames are returned as memory-mapped numpy arrays (no copy, only the pages actually used are read from disk); compressed and delta-encoded frames are decoded in memory::
+
+	from yade import trajectory
+	t=trajectory.Trajectory('/tmp/run.trj')
+	print len(t),t.iters[-1]
+	pos=t[-1]['pos']     # (n,3) array of the last frame
+	ids=t[-1]['id']      # body ids, in the same order as rows of all columns
+"""
+import numpy,struct,zlib,os
+
+_FILE_FLOAT32=1
+_FRAME_ZLIB,_FRAME_XOR=1,2
+_frameHead=struct.Struct('<4sIqdq')
+
+class Trajectory(object):
+	"""Random access to frames of a trajectory file.
+
+	:ivar columns: list of (name,number of components) as stored in the file
+	:ivar iters: numpy array of iteration numbers of all frames
+	:ivar times: numpy array of simulation times of all frames
+	"""
+	def __init__(self,fileName):
+		self.fileName=fileName
+		self._mm=numpy.memmap(fileName,dtype=numpy.uint8,mode='r')
+		buf=self._mm
+		if bytes(buf[:8])!='YADETRJ1': raise ValueError(fileName+' is not a trajectory file.')
+		version,flags,nCols=struct.unpack('<III',bytes(buf[8:20]))
+		self.dtype=numpy.dtype('<f4' if flags&_FILE_FLOAT32 else '<f8')
+		self.columns=[]
+		off=20
+		for i in range(nCols):
+			name=bytes(buf[off:off+16]).rstrip('\0'); k=struct.unpack('<I',bytes(buf[off+16:off+20]))[0]
+			self.columns.append((name,k)); off+=20
+		self._firstFrame=off
+		if os.path.exists(fileName+'.idx') and os.path.getsize(fileName+'.idx')>0:
+			idx=numpy.fromfile(fileName+'.idx',dtype=numpy.dtype([('offset','<i8'),('iter','<i8'),('time','<f8')]))
+			# the index is written after the frame; drop records of frames which are not (fully) in the file
+			idx=idx[idx['offset']<len(buf)]
+			self._offsets,self.iters,self.times=idx['offset'],idx['iter'],idx['time']
+			self._heads=[None]*len(self._offsets)
+		else: self._scan()
+		self._cache=(None,None) # last decoded raw frame, speeds up sequential access to delta-encoded frames
+	def _scan(self):
+		"Build the index by walking over frames, when the .idx file is missing."
+		offsets,iters,times,heads=[],[],[],[]
+		off=self._firstFrame
+		while off+_frameHead.size<=len(self._mm):
+			magic,flags,it,t,n=_frameHead.unpack(bytes(self._mm[off:off+_frameHead.size]))
+			if magic!='FRM1': raise ValueError('%s: corrupt frame at offset %d.'%(self.fileName,off))
+			end=off+_frameHead.size
+			for c in range(len(self.columns)+1):
+				end+=8+struct.unpack('<Q',bytes(self._mm[end:end+8]))[0]
+			if end>len(self._mm): break # incomplete last frame
+			offsets.append(off); iters.append(it); times.append(t); heads.append((flags,it,t,n))
+			off=end
+		self._offsets,self.iters,self.times=numpy.array(offsets,dtype=numpy.int64),numpy.array(iters,dtype=numpy.int64),numpy.array(times)
+		self._heads=heads
+	def __len__(self): return len(self._offsets)
+	def _head(self,i):
+		"Return (flags,iter,time,n) of frame *i*; each header is parsed only once."
+		if self._heads[i] is None:
+			off=int(self._offsets[i])
+			magic,flags,it,t,n=_frameHead.unpack(bytes(self._mm[off:off+_frameHead.size]))
+			if magic!='FRM1': raise ValueError('%s: corrupt frame at offset %d.'%(self.fileName,off))
+			self._heads[i]=(flags,it,t,n)
+		return self._heads[i]
+	def _readRaw(self,i):
+		"Return (flags,iter,time,n,list of stored byte arrays) of frame *i*."
+		flags,it,t,n=self._head(i)
+		off=int(self._offsets[i])+_frameHead.size
+		data=[]
+		for c in range(len(self.columns)+1):
+			size=struct.unpack('<Q',bytes(self._mm[off:off+8]))[0]; off+=8
+			d=self._mm[off:off+size]; off+=size
+			if flags&_FRAME_ZLIB: d=numpy.frombuffer(zlib.decompress(bytes(d)),dtype=numpy.uint8)
+			data.append(d)
+		return flags,it,t,n,data
+	def _decode(self,i):
+		"Return (iter,time,n,list of byte arrays) of frame *i* with delta encoding undone."
+		if self._cache[0]==i: return self._cache[1]
+		# walk back to the last key frame, or to the cached frame, then undo deltas going forward
+		start=i
+		while self._head(start)[0]&_FRAME_XOR and start-1!=self._cache[0]:
+			if start==0: raise ValueError('%s: first frame is delta-encoded.'%self.fileName)
+			start-=1
+		prev=self._cache[1][3] if self._head(start)[0]&_FRAME_XOR else None
+		for j in range(start,i+1):
+			flags,it,t,n,data=self._readRaw(j)
+			if flags&_FRAME_XOR: data=[numpy.bitwise_xor(d,p) for d,p in zip(data,prev)]
+			prev=data
+		ret=(it,t,n,prev)
+		self._cache=(i,ret)
+		return ret
+	def frame(self,i):
+		"""Return frame *i* (negative values count from the end) as dictionary with keys ``id``, ``iter``, ``time`` and names of recorded columns; columns are numpy arrays of shape (n,components)."""
+		if i<0: i+=len(self)
+		if i<0 or i>=len(self): raise IndexError('Frame index out of range.')
+		it,t,n,data=self._decode(i)
+		ret={'iter':int(it),'time':float(t),'id':data[0].view('<i4')}
+		for (name,k),d in zip(self.columns,data[1:]): ret[name]=d.view(self.dtype).reshape(n,k)
+		return ret
+	def __getitem__(self,i): return self.frame(i)
+	def __iter__(self):
+		for i in range(len(self)): yield self.frame(i)
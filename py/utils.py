@@ -342,6 +342,21 @@ def facet(vertices,dynamic=None,fixed=True,wire=True,color=None,highlight=False,
 	b.chain=chain
 	return b
 
+def triMesh(vertices,triangles,fixed=True,wire=True,color=None,highlight=False,noBound=False,material=-1,mask=1):
+	"""Create one body with :yref:`TriMesh` shape.
+
+	:param [Vector3,...] vertices: coordinates of vertices in the global coordinate system.
+	:param [Vector3i,...] triangles: vertex indices of triangles; neighbour triangles must share vertices.
+
+	See :yref:`yade.utils.facet`'s documentation for meaning of other parameters."""
+	b=Body()
+	center=sum((Vector3(v) for v in vertices),Vector3.Zero)/len(vertices)
+	b.shape=TriMesh(color=color if color else randomColor(),wire=wire,highlight=highlight,vertices=[Vector3(v)-center for v in vertices],triangles=triangles)
+	_commonBodySetup(b,0,Vector3(0,0,0),material,noBound=noBound,pos=center,fixed=fixed)
+	b.aspherical=False
+	b.mask=mask
+	return b
+
 def tetraPoly(vertices,dynamic=True,fixed=False,wire=True,color=None,highlight=False,noBound=False,material=-1,mask=1,chain=-1):
 	"""Create tetrahedron (actually simple Polyhedra) with given parameters.
 
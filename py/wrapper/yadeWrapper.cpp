@@ -16,10 +16,12 @@
 #include<lib/pyutil/gil.hpp>
 #include<lib/pyutil/raw_constructor.hpp>
 #include<lib/pyutil/doc_opts.hpp>
+#include<lib/pyutil/numpy.hpp>
 #include<core/Omega.hpp>
 #include<core/ThreadRunner.hpp>
 #include<core/FileGenerator.hpp>
 #include<core/EnergyTracker.hpp>
+#include<core/EventLog.hpp>
 
 #include<pkg/dem/STLImporter.hpp>
 
@@ -34,6 +36,10 @@
 
 #include <core/Clump.hpp>
 #include <pkg/common/Sphere.hpp>
+#include <pkg/common/Aabb.hpp>
+#include <pkg/dem/SpherePack.hpp>
+#include <pkg/common/NormShearPhys.hpp>
+#include <pkg/dem/DemXDofGeom.hpp>
 
 #if BOOST_VERSION>=104700
 	#include<boost/math/special_functions/nonfinite_num_facets.hpp>
@@ -52,6 +58,20 @@
 
 namespace py = boost::python;
 
+/* Bulk (numpy) access to scene data: arrays are allocated by numpy and filled in c++, rows are filled in parallel.
+The numpy_boost object keeps its own reference, hence the python object must be created from a borrowed one. */
+template<typename T, int NDims>
+py::object numpyToPython(const numpy_boost<T,NDims>& arr){ return py::object(py::handle<>(py::borrowed(arr.py_ptr()))); }
+
+// check that array passed from python has N rows and 3 columns
+template<typename T>
+void checkNx3(const numpy_boost<T,2>& arr, size_t N, const string& what){
+	if(arr.shape()[0]!=N || arr.shape()[1]!=3){
+		PyErr_SetString(PyExc_ValueError,(what+": array of shape ("+boost::lexical_cast<string>(N)+",3) expected, got ("+boost::lexical_cast<string>(arr.shape()[0])+","+boost::lexical_cast<string>(arr.shape()[1])+").").c_str());
+		py::throw_error_already_set();
+	}
+}
+
 /*
 Python normally iterates over object it is has __getitem__ and __len__, which BodyContainer does.
 However, it will not skip removed bodies automatically, hence this iterator which does just that.
@@ -387,6 +407,234 @@ class pyBodyContainer{
 	long length(){return proxee->size();}
 	void clear(){proxee->clear();}
 	bool erase(Body::id_t id, bool eraseClumpMembers){ return proxee->erase(id,eraseClumpMembers); }
+
+	/* bulk accessors; rows of returned arrays correspond to ids returned by ids(mask) with the same mask */
+	vector<Body::id_t> maskedIds(int mask){
+		vector<Body::id_t> ret; ret.reserve(proxee->size());
+		const BodyContainer& bodies(*proxee);
+		for(size_t id=0; id<bodies.size(); id++){ const shared_ptr<Body>& b=bodies[id]; if(b && b->maskOk(mask)) ret.push_back(id); }
+		return ret;
+	}
+	py::object ids(int mask){
+		const vector<Body::id_t> ii(maskedIds(mask)); const long N=ii.size();
+		int dim[]={(int)N}; numpy_boost<Body::id_t,1> ret(dim);
+		for(long i=0; i<N; i++) ret[i]=ii[i];
+		return numpyToPython(ret);
+	}
+	// fill N×3 array with a Vector3r attribute of State
+	py::object stateVectors(int mask, Vector3r State::*attr){
+		const vector<Body::id_t> ii(maskedIds(mask)); const long N=ii.size();
+		int dim[]={(int)N,3}; numpy_boost<double,2> ret(dim);
+		const BodyContainer& bodies(*proxee);
+		#ifdef YADE_OPENMP
+			#pragma omp parallel for schedule(static)
+		#endif
+		for(long i=0; i<N; i++){ const Vector3r& v(bodies[ii[i]]->state.get()->*attr); VECTOR3R_TO_NUMPY(v,ret[i]); }
+		return numpyToPython(ret);
+	}
+	py::object positions(int mask){
+		const vector<Body::id_t> ii(maskedIds(mask)); const long N=ii.size();
+		int dim[]={(int)N,3}; numpy_boost<double,2> ret(dim);
+		const BodyContainer& bodies(*proxee);
+		#ifdef YADE_OPENMP
+			#pragma omp parallel for schedule(static)
+		#endif
+		for(long i=0; i<N; i++){ const Vector3r& pos(bodies[ii[i]]->state->pos); VECTOR3R_TO_NUMPY(pos,ret[i]); }
+		return numpyToPython(ret);
+	}
+	py::object velocities(int mask){ return stateVectors(mask,&State::vel); }
+	py::object angularVelocities(int mask){ return stateVectors(mask,&State::angVel); }
+	py::object radii(int mask){
+		const vector<Body::id_t> ii(maskedIds(mask)); const long N=ii.size();
+		int dim[]={(int)N}; numpy_boost<double,1> ret(dim);
+		const BodyContainer& bodies(*proxee);
+		#ifdef YADE_OPENMP
+			#pragma omp parallel for schedule(static)
+		#endif
+		for(long i=0; i<N; i++){ const Sphere* s=dynamic_cast<const Sphere*>(bodies[ii[i]]->shape.get()); ret[i]=(s ? s->radius : NaN); }
+		return numpyToPython(ret);
+	}
+	// check that all ids exist, to avoid crashes in the parallel section
+	void checkIds(const vector<Body::id_t>& ii){
+		FOREACH(Body::id_t id, ii){ if(!proxee->exists(id)){ PyErr_SetString(PyExc_IndexError,("No body with id "+boost::lexical_cast<string>(id)+".").c_str()); py::throw_error_already_set(); } }
+	}
+	void setStateVectors(const vector<Body::id_t>& ii, py::object arr, Vector3r State::*attr, const string& what){
+		checkIds(ii);
+		numpy_boost<double,2> a(arr.ptr()); checkNx3(a,ii.size(),what);
+		const long N=ii.size();
+		const BodyContainer& bodies(*proxee);
+		#ifdef YADE_OPENMP
+			#pragma omp parallel for schedule(static)
+		#endif
+		for(long i=0; i<N; i++){ (bodies[ii[i]]->state.get()->*attr)=Vector3r(a[i][0],a[i][1],a[i][2]); }
+	}
+	void setPositions(const vector<Body::id_t>& ii, py::object arr){
+		checkIds(ii);
+		numpy_boost<double,2> a(arr.ptr()); checkNx3(a,ii.size(),"setPositions");
+		const long N=ii.size();
+		const BodyContainer& bodies(*proxee);
+		#ifdef YADE_OPENMP
+			#pragma omp parallel for schedule(static)
+		#endif
+		for(long i=0; i<N; i++){ bodies[ii[i]]->state->pos=Vector3r(a[i][0],a[i][1],a[i][2]); }
+	}
+	void setVelocities(const vector<Body::id_t>& ii, py::object arr){ setStateVectors(ii,arr,&State::vel,"setVelocities"); }
+	void setAngularVelocities(const vector<Body::id_t>& ii, py::object arr){ setStateVectors(ii,arr,&State::angVel,"setAngularVelocities"); }
+	/* full kinematic state (pos, ori as w,x,y,z, vel, angVel) as (N,13) array, for exchanging states between processes (see yade.mpy) */
+	py::object stateArray(const vector<Body::id_t>& ii){
+		checkIds(ii);
+		const long N=ii.size();
+		int dim[]={(int)N,13}; numpy_boost<double,2> ret(dim);
+		const BodyContainer& bodies(*proxee);
+		#ifdef YADE_OPENMP
+			#pragma omp parallel for schedule(static)
+		#endif
+		for(long i=0; i<N; i++){
+			const State* s=bodies[ii[i]]->state.get();
+			for(int j=0; j<3; j++){ ret[i][j]=s->pos[j]; ret[i][7+j]=s->vel[j]; ret[i][10+j]=s->angVel[j]; }
+			ret[i][3]=s->ori.w(); ret[i][4]=s->ori.x(); ret[i][5]=s->ori.y(); ret[i][6]=s->ori.z();
+		}
+		return numpyToPython(ret);
+	}
+	void setStateArray(const vector<Body::id_t>& ii, py::object arr){
+		checkIds(ii);
+		numpy_boost<double,2> a(arr.ptr());
+		if(a.shape()[0]!=ii.size() || a.shape()[1]!=13){ PyErr_SetString(PyExc_ValueError,("setStateArray: array of shape ("+boost::lexical_cast<string>(ii.size())+",13) expected.").c_str()); py::throw_error_already_set(); }
+		const long N=ii.size();
+		const BodyContainer& bodies(*proxee);
+		#ifdef YADE_OPENMP
+			#pragma omp parallel for schedule(static)
+		#endif
+		for(long i=0; i<N; i++){
+			State* s=bodies[ii[i]]->state.get();
+			s->pos=Vector3r(a[i][0],a[i][1],a[i][2]);
+			s->ori=Quaternionr(a[i][3],a[i][4],a[i][5],a[i][6]);
+			s->vel=Vector3r(a[i][7],a[i][8],a[i][9]);
+			s->angVel=Vector3r(a[i][10],a[i][11],a[i][12]);
+		}
+	}
+	/* bodies to/from binary string, keeping their ids (interactions are not included) */
+	py::object serialize(const vector<Body::id_t>& ii){
+		checkIds(ii);
+		vector<shared_ptr<Body> > bb; bb.reserve(ii.size());
+		vector<Body::MapId2IntrT> intrs(ii.size());
+		for(size_t i=0; i<ii.size(); i++){ bb.push_back((*proxee)[ii[i]]); bb.back()->intrs.swap(intrs[i]); }
+		std::ostringstream oss;
+		yade::ObjectIO::save<decltype(bb),boost::archive::binary_oarchive>(oss,"bodies",bb);
+		for(size_t i=0; i<ii.size(); i++) bb[i]->intrs.swap(intrs[i]);
+		const string data=oss.str();
+		return py::str(data.data(),data.size());
+	}
+	vector<Body::id_t> deserialize(const string& data, const vector<Body::id_t>& ids){
+		vector<shared_ptr<Body> > bb;
+		std::istringstream iss(data);
+		yade::ObjectIO::load<decltype(bb),boost::archive::binary_iarchive>(iss,"bodies",bb);
+		if(!ids.empty() && ids.size()!=bb.size()){ PyErr_SetString(PyExc_ValueError,("deserialize: "+boost::lexical_cast<string>(bb.size())+" ids expected.").c_str()); py::throw_error_already_set(); }
+		const shared_ptr<Scene>& scene=Omega::instance().getScene();
+		vector<Body::id_t> ret; ret.reserve(bb.size());
+		for(size_t i=0; i<bb.size(); i++){
+			const shared_ptr<Body>& b=bb[i];
+			// share materials of this scene instead of the deserialized copies
+			if(b->material && b->material->id>=0 && (size_t)b->material->id<scene->materials.size()) b->material=scene->materials[b->material->id];
+			const Body::id_t id=(ids.empty() ? b->id : ids[i]);
+			if(proxee->exists(id)) proxee->erase(id,false);
+			ret.push_back(proxee->insertAtId(b,id));
+		}
+		return ret;
+	}
+	Body::id_t insertAtId(shared_ptr<Body> b, Body::id_t id){
+		if(proxee->exists(id)){ PyErr_SetString(PyExc_IndexError,("Body #"+boost::lexical_cast<string>(id)+" already exists.").c_str()); py::throw_error_already_set(); }
+		return proxee->insertAtId(b,id);
+	}
+	void setBlockedDOFs(const vector<Body::id_t>& ii, const string& dofs){
+		checkIds(ii);
+		// parse only once, then assign the bitmask
+		State tmp; tmp.blockedDOFs_vec_set(dofs);
+		const unsigned blocked=tmp.blockedDOFs;
+		FOREACH(Body::id_t id, ii) (*proxee)[id]->state->blockedDOFs=blocked;
+	}
+
+	/* bulk creation of spheres, equivalent to O.bodies.append([utils.sphere(c,r,material=material,mask=mask,dynamic=dynamic) for c,r in zip(centers,radii)]) */
+	// material given as Material instance, label or id; -1 with no materials defined adds utils.defaultMaterial(), as utils.sphere does
+	shared_ptr<Material> bulkMaterial(py::object material){
+		const shared_ptr<Scene>& scene=Omega::instance().getScene();
+		py::extract<shared_ptr<Material> > mat(material);
+		if(mat.check() && mat()) return mat();
+		py::extract<string> label(material);
+		if(label.check()){
+			try { return Material::byLabel(label(),scene); }
+			catch (std::runtime_error& e){ PyErr_SetString(PyExc_KeyError,e.what()); py::throw_error_already_set(); }
+		}
+		py::extract<int> id(material);
+		if(!id.check()){ PyErr_SetString(PyExc_TypeError,"The 'material' argument must be string (for shared material label), int (for shared material id) or Material instance."); py::throw_error_already_set(); }
+		int i=id();
+		if(i<0 && scene->materials.empty()){
+			shared_ptr<Material> m=py::extract<shared_ptr<Material> >(py::import("yade.utils").attr("defaultMaterial")());
+			scene->materials.push_back(m); m->id=scene->materials.size()-1;
+		}
+		if(i<0) i+=scene->materials.size();
+		if(i<0 || (size_t)i>=scene->materials.size()){ PyErr_SetString(PyExc_IndexError,"Material id out of range."); py::throw_error_already_set(); }
+		return scene->materials[i];
+	}
+	py::tuple appendSpheres(py::object centers, py::object radii, py::object material, int mask, bool dynamic){
+		// read input into plain vectors first, the parallel section below must not touch python
+		vector<Vector3r> cc; vector<Real> rr;
+		py::extract<const SpherePack&> sp(centers);
+		if(sp.check()){
+			if(!radii.is_none()){ PyErr_SetString(PyExc_ValueError,"radii must not be given when centers is a SpherePack."); py::throw_error_already_set(); }
+			const SpherePack& pack(sp());
+			cc.reserve(pack.pack.size()); rr.reserve(pack.pack.size());
+			FOREACH(const SpherePack::Sph& s, pack.pack){ cc.push_back(s.c); rr.push_back(s.r); }
+		} else {
+			numpy_boost<double,2> c(centers.ptr());
+			const size_t N=c.shape()[0]; checkNx3(c,N,"appendSpheres");
+			cc.resize(N); rr.resize(N);
+			for(size_t i=0; i<N; i++) cc[i]=Vector3r(c[i][0],c[i][1],c[i][2]);
+			py::extract<Real> r0(radii);
+			if(r0.check()) std::fill(rr.begin(),rr.end(),r0());
+			else {
+				numpy_boost<double,1> r(radii.ptr());
+				if(r.shape()[0]!=N){ PyErr_SetString(PyExc_ValueError,("appendSpheres: radii must have the same length as centers ("+boost::lexical_cast<string>(N)+"), got "+boost::lexical_cast<string>(r.shape()[0])+".").c_str()); py::throw_error_already_set(); }
+				for(size_t i=0; i<N; i++) rr[i]=r[i];
+			}
+		}
+		const shared_ptr<Material> mat=bulkMaterial(material);
+		const long N=cc.size();
+		// random colors as in utils.sphere; rand() is not reentrant, hence generated here
+		vector<Vector3r> colors(N);
+		for(long i=0; i<N; i++) colors[i]=Vector3r(Mathr::UnitRandom(),Mathr::UnitRandom(),Mathr::UnitRandom());
+		// class indices are assigned lazily by the first instance; do it before threads race for them
+		{ Sphere s; Aabb a; shared_ptr<State> st=mat->newAssocState(); }
+		vector<shared_ptr<Body> > bb(N);
+		#ifdef YADE_OPENMP
+			#pragma omp parallel for schedule(static)
+		#endif
+		for(long i=0; i<N; i++){
+			const Real r=rr[i];
+			shared_ptr<Body> b(new Body);
+			shared_ptr<Sphere> s(new Sphere(r)); s->color=colors[i];
+			b->shape=s;
+			// bound is filled by BoundDispatcher, creating it here spares one allocation per body in the first step
+			b->bound=shared_ptr<Bound>(new Aabb);
+			b->material=mat;
+			b->state=mat->newAssocState();
+			const Real V=(4./3)*Mathr::PI*pow(r,3);
+			b->state->mass=V*mat->density;
+			b->state->inertia=Vector3r::Constant((2./5.)*V*r*r*mat->density);
+			b->state->pos=b->state->refPos=cc[i];
+			b->setDynamic(dynamic);
+			b->setAspherical(false);
+			b->groupMask=mask;
+			bb[i]=b;
+		}
+		#if BOOST_VERSION<103500
+			boost::try_mutex::scoped_try_lock lock(Omega::instance().renderMutex,true);
+		#else
+			boost::mutex::scoped_lock lock(Omega::instance().renderMutex);
+		#endif
+		const Body::id_t first=proxee->insertBulk(bb);
+		return py::make_tuple(first,first+N);
+	}
 };
 
 
@@ -467,6 +715,33 @@ class pyInteractionContainer{
 		void serializeSorted_set(bool ss){proxee->serializeSorted=ss;}
 		void eraseNonReal(){ proxee->eraseNonReal(); }
 		void erase(Body::id_t id1, Body::id_t id2){ proxee->requestErase(id1,id2); }
+		// real interactions as dictionary of numpy arrays; normal is NaN for non-GenericSpheresContact geometries, forces are NaN for phys not deriving from NormPhys (shear force is zero for NormPhys)
+		py::dict arrays(){
+			const InteractionContainer& intrs(*proxee);
+			vector<const Interaction*> ii; ii.reserve(proxee->size());
+			for(size_t i=0; i<proxee->size(); i++){ const Interaction* I=intrs[i].get(); if(I->isReal()) ii.push_back(I); }
+			const long N=ii.size();
+			int dim1[]={(int)N}; int dim2[]={(int)N,3};
+			numpy_boost<Body::id_t,1> id1(dim1), id2(dim1);
+			numpy_boost<double,2> normal(dim2), fn(dim2), fs(dim2);
+			const Vector3r nan3(Vector3r::Constant(NaN));
+			#ifdef YADE_OPENMP
+				#pragma omp parallel for schedule(static)
+			#endif
+			for(long i=0; i<N; i++){
+				const Interaction* I=ii[i];
+				id1[i]=I->getId1(); id2[i]=I->getId2();
+				const GenericSpheresContact* gsc=dynamic_cast<const GenericSpheresContact*>(I->geom.get());
+				const NormPhys* np=dynamic_cast<const NormPhys*>(I->phys.get());
+				const NormShearPhys* nsp=dynamic_cast<const NormShearPhys*>(np);
+				const Vector3r n(gsc ? gsc->normal : nan3), nf(np ? np->normalForce : nan3), sf(nsp ? nsp->shearForce : (np ? Vector3r::Zero() : nan3));
+				VECTOR3R_TO_NUMPY(n,normal[i]); VECTOR3R_TO_NUMPY(nf,fn[i]); VECTOR3R_TO_NUMPY(sf,fs[i]);
+			}
+			py::dict ret;
+			ret["id1"]=numpyToPython(id1); ret["id2"]=numpyToPython(id2);
+			ret["normal"]=numpyToPython(normal); ret["fn"]=numpyToPython(fn); ret["fs"]=numpyToPython(fs);
+			return ret;
+		}
 };
 
 class pyForceContainer{
@@ -488,6 +763,20 @@ class pyForceContainer{
 		long syncCount_get(){ return scene->forces.syncCount;}
 		void syncCount_set(long count){ scene->forces.syncCount=count;}
 		bool getPermForceUsed() {return scene->forces.getPermForceUsed();}
+		// forces and torques on all bodies (rows indexed by body id), synchronized first
+		py::tuple all(){
+			scene->forces.sync();
+			const long N=scene->bodies->size();
+			int dim[]={(int)N,3}; numpy_boost<double,2> f(dim), t(dim);
+			#ifdef YADE_OPENMP
+				#pragma omp parallel for schedule(static)
+			#endif
+			for(long id=0; id<N; id++){
+				const Vector3r& ff(scene->forces.getForce(id)); VECTOR3R_TO_NUMPY(ff,f[id]);
+				const Vector3r& tt(scene->forces.getTorque(id)); VECTOR3R_TO_NUMPY(tt,t[id]);
+			}
+			return py::make_tuple(numpyToPython(f),numpyToPython(t));
+		}
 };
 
 class pyMaterialContainer{
@@ -630,7 +919,7 @@ class pyOmega{
 		mapLabeledEntitiesToVariables();
 	}
 	void reload(bool quiet=false){	load(OMEGA.sceneFile,quiet);}
-	void saveTmp(string mark="", bool quiet=false){ save(":memory:"+mark,quiet);}
+	void saveTmp(string mark="", bool quiet=false, bool prefetch=false){ save(":memory:"+mark,quiet); if(prefetch) OMEGA.prefetchMemSaved(":memory:"+mark); }
 	void loadTmp(string mark="", bool quiet=false){ load(":memory:"+mark,quiet);}
 	py::list lsTmp(){ py::list ret; typedef pair<std::string,string> strstr; FOREACH(const strstr& sim,OMEGA.memSavedSimulations){ string mark=sim.first; boost::algorithm::replace_first(mark,":memory:",""); ret.append(mark); } return ret; }
 	void tmpToFile(string mark, string filename){
@@ -656,6 +945,14 @@ class pyOmega{
 	shared_ptr<Scene> scene_get(){ return OMEGA.getScene(); }
 	int addScene(){return OMEGA.addScene();}
 	void switchToScene(int i){OMEGA.switchToScene(i);}
+	void runScenes(const vector<int>& ids, long nSteps, Real time, int threads){
+		// exceptions must not propagate with the GIL released
+		string err;
+		Py_BEGIN_ALLOW_THREADS;
+			try{ OMEGA.runScenes(ids,nSteps,time,threads); } catch(std::exception& e){ err=e.what(); }
+		Py_END_ALLOW_THREADS;
+		if(!err.empty()) throw runtime_error(err);
+	}
 	string sceneToString(){
 		ostringstream oss;
 		yade::ObjectIO::save<decltype(OMEGA.getScene()),boost::archive::binary_oarchive>(oss,"scene",OMEGA.getScene());
@@ -665,6 +962,7 @@ class pyOmega{
 	void stringToScene(const string &sstring, string mark=""){
 		Py_BEGIN_ALLOW_THREADS; OMEGA.stop(); Py_END_ALLOW_THREADS;
 		assertScene();
+		OMEGA.dropMemPrefetch(":memory:"+mark);
 		OMEGA.memSavedSimulations[":memory:"+mark]=sstring;
 		OMEGA.sceneFile=":memory:"+mark;
 		load(OMEGA.sceneFile,true);
@@ -759,8 +1057,17 @@ class pyOmega{
 	void periodic_set(bool v){ OMEGA.getScene()->isPeriodic=v; }
 
 	shared_ptr<EnergyTracker> energy_get(){ return OMEGA.getScene()->energy; }
+	shared_ptr<EventLog> events_get(){ return OMEGA.getScene()->events; }
 	bool trackEnergy_get(void){ return OMEGA.getScene()->trackEnergy; }
 	void trackEnergy_set(bool e){ OMEGA.getScene()->trackEnergy=e; }
+	bool deterministic_get(void){ return OMEGA.getScene()->deterministic; }
+	void deterministic_set(bool d){ OMEGA.getScene()->deterministic=d; }
+	py::dict poolStats(bool reset){
+		PoolStats& s(PoolStats::instance());
+		py::dict ret; ret["allocated"]=s.get(PoolStats::ALLOCATED); ret["reused"]=s.get(PoolStats::REUSED); ret["released"]=s.get(PoolStats::RELEASED); ret["freed"]=s.get(PoolStats::FREED);
+		if(reset) s.reset();
+		return ret;
+	}
 
 	void disableGdb(){
 		signal(SIGSEGV,SIG_DFL);
@@ -783,6 +1090,8 @@ class pyOmega{
 BOOST_PYTHON_MODULE(wrapper)
 {
 	py::scope().attr("__doc__")="Wrapper for c++ internals of yade.";
+	// numpy C API must be initialized in module init, otherwise bulk accessors will crash
+	import_array();
 
 	YADE_SET_DOCSTRING_OPTS;
 
@@ -809,7 +1118,7 @@ BOOST_PYTHON_MODULE(wrapper)
 		.def("reload",&pyOmega::reload,(py::arg("quiet")=false),"Reload current simulation")
 		.def("save",&pyOmega::save,(py::arg("file"),py::arg("quiet")=false),"Save current simulation to file (should be .xml or .xml.bz2 or .yade or .yade.gz). .xml files are bigger than .yade, but can be more or less easily (due to their size) opened and edited, e.g. with text editors. .bz2 and .gz correspond both to compressed versions. All saved files should be :yref:`loaded<Omega.load>` in the same version of Yade, otherwise compatibility is not guaranteed.")
 		.def("loadTmp",&pyOmega::loadTmp,(py::arg("mark")="",py::arg("quiet")=false),"Load simulation previously stored in memory by saveTmp. *mark* optionally distinguishes multiple saved simulations")
-		.def("saveTmp",&pyOmega::saveTmp,(py::arg("mark")="",py::arg("quiet")=false),"Save simulation to memory (disappears at shutdown), can be loaded later with loadTmp. *mark* optionally distinguishes different memory-saved simulations.")
+		.def("saveTmp",&pyOmega::saveTmp,(py::arg("mark")="",py::arg("quiet")=false,py::arg("prefetch")=false),"Save simulation to memory (disappears at shutdown), can be loaded later with loadTmp. *mark* optionally distinguishes different memory-saved simulations. With *prefetch*, a copy of the simulation is also deserialized right away and kept, so that the next :yref:`loadTmp<Omega.loadTmp>` only swaps it in; this moves the loading time out of a time-critical moment (later loads deserialize as usual), at the cost of keeping one more copy of the simulation in memory until then.")
 		.def("lsTmp",&pyOmega::lsTmp,"Return list of all memory-saved simulations.")
 		.def("tmpToFile",&pyOmega::tmpToFile,(py::arg("fileName"),py::arg("mark")=""),"Save XML of :yref:`saveTmp<Omega.saveTmp>`'d simulation into *fileName*.")
 		.def("tmpToString",&pyOmega::tmpToString,(py::arg("mark")=""),"Return XML of :yref:`saveTmp<Omega.saveTmp>`'d simulation as string.")
@@ -825,6 +1134,7 @@ BOOST_PYTHON_MODULE(wrapper)
 		.def("resetAllScenes",&pyOmega::resetAllScenes,"Reset all scenes.")
 		.def("addScene",&pyOmega::addScene,"Add new scene to Omega, returns its number")
 		.def("switchToScene",&pyOmega::switchToScene,"Switch to defined scene. Default scene has number 0, other scenes have to be created by addScene method.")
+		.def("runScenes",&pyOmega::runScenes,(py::arg("scenes"),py::arg("nSteps")=-1,py::arg("time")=-1,py::arg("threads")=0),"Advance scenes with given numbers (see :yref:`addScene<Omega.addScene>`) concurrently, one scene per thread, by *nSteps* steps or by *time* of simulation time, whichever is reached first; returns when all scenes are done. *threads* is the number of worker threads (all cores if not positive). OpenMP is not used inside the scenes. The GIL is released meanwhile; python code run by engines (e.g. :yref:`PyRunner`) sees the scene it belongs to as ``O``. The simulation must not be running (:yref:`O.run<Omega.run>`).")
 		.def("switchScene",&pyOmega::switchScene,"Switch to alternative simulation (while keeping the old one). Calling the function again switches back to the first one. Note that most variables from the first simulation will still refer to the first simulation even after the switch\n(e.g. b=O.bodies[4]; O.switchScene(); [b still refers to the body in the first simulation here])")
 		.add_property("thisScene",&pyOmega::thisScene,"Return current scene's id.")
 		.def("sceneToString",&pyOmega::sceneToString,"Return the entire scene as a string. Equivalent to using O.save(...) except that the scene goes to a string instead of a file. (see also stringToScene())")
@@ -842,7 +1152,10 @@ BOOST_PYTHON_MODULE(wrapper)
 		.add_property("materials",&pyOmega::materials_get,"Shared materials; they can be accessed by id or by label")
 		.add_property("forces",&pyOmega::forces_get,":yref:`ForceContainer` (forces, torques, displacements) in the current simulation.")
 		.add_property("energy",&pyOmega::energy_get,":yref:`EnergyTracker` of the current simulation. (meaningful only with :yref:`O.trackEnergy<Omega.trackEnergy>`)")
+		.add_property("events",&pyOmega::events_get,":yref:`EventLog` of the current simulation, with events (such as broken bonds) reported by engines and functors.")
 		.add_property("trackEnergy",&pyOmega::trackEnergy_get,&pyOmega::trackEnergy_set,"When energy tracking is enabled or disabled in this simulation.")
+		.add_property("deterministic",&pyOmega::deterministic_get,&pyOmega::deterministic_set,"Deterministic parallel mode: trajectories and energies are bitwise the same for any number of threads (and the same as in a serial run with the same setting). Forces from interactions are summed for each body in the order of interaction ids, interactions are kept sorted by ids and energies are summed exactly. The overhead is recording and ordering of force contributions, linear in the number of interactions, and exact summation of energies if :yref:`O.trackEnergy<Omega.trackEnergy>` is set; scripts/checks-and-tests/deterministic-benchmark.py measures it on a full step with given number of threads. Forces added from parallel loops of other engines must be tagged with ForceContainer::setOrderKey; a warning is printed otherwise. Takes effect at the beginning of the next step.")
+		.def("poolStats",&pyOmega::poolStats,(py::arg("reset")=false),"Return counters of pooled allocations of :yref:`IGeom` and :yref:`IPhys` instances (summed over all types and threads), as dictionary with keys *allocated* (new memory blocks), *reused* (blocks taken from the pool) *released* (blocks returned to the pool) and *freed* (blocks deleted because the per-thread pool was full or its thread exited). Counters are zeroed afterwards if *reset* is True. Reported by :yref:`yade.timing.stats`.")
 		.add_property("tags",&pyOmega::tags_get,"Tags (string=string dictionary) of the current simulation (container supporting string-index access/assignment)")
 		.def("childClassesNonrecursive",&pyOmega::listChildClassesNonrecursive,"Return list of all classes deriving from given class, as registered in the class factory")
 		.def("isChildClassOf",&pyOmega::isChildClassOf,"Tells whether the first class derives from the second one (both given as strings).")
@@ -876,7 +1189,22 @@ BOOST_PYTHON_MODULE(wrapper)
 		.def("getRoundness",&pyBodyContainer::getRoundness,(py::arg("excludeList")=py::list()),"Returns roundness coefficient RC = R2/R1. R1 is the equivalent sphere radius of a clump. R2 is the minimum radius of a sphere, that imbeds the clump. If just spheres are present RC = 1. If clumps are present 0 < RC < 1. Bodies can be excluded from the calculation by giving a list of ids: *O.bodies.getRoundness([ids])*.\n\nSee :ysrc:`examples/clumps/replaceByClumps-example.py` for an example script.")
 		.def("clear", &pyBodyContainer::clear,"Remove all bodies (interactions not checked)")
 		.def("erase", &pyBodyContainer::erase,(py::arg("eraseClumpMembers")=0),"Erase body with the given id; all interaction will be deleted by InteractionLoop in the next step. If a clump is erased use *O.bodies.erase(clumpId,True)* to erase the clump AND its members.")
-		.def("replace",&pyBodyContainer::replace);
+		.def("replace",&pyBodyContainer::replace)
+		.def("ids",&pyBodyContainer::ids,(py::arg("mask")=0),"Return ids of all existing bodies matching *mask* (all bodies for mask=0) as numpy array. Rows of arrays returned by :yref:`positions<BodyContainer.positions>`, :yref:`velocities<BodyContainer.velocities>`, :yref:`angularVelocities<BodyContainer.angularVelocities>` and :yref:`radii<BodyContainer.radii>` called with the same *mask* correspond to those ids.")
+		.def("positions",&pyBodyContainer::positions,(py::arg("mask")=0),"Return positions of bodies matching *mask* as (N,3) numpy array, filled in c++ (in parallel). Much faster than iterating over bodies in python.")
+		.def("velocities",&pyBodyContainer::velocities,(py::arg("mask")=0),"Return linear velocities of bodies matching *mask* as (N,3) numpy array.")
+		.def("angularVelocities",&pyBodyContainer::angularVelocities,(py::arg("mask")=0),"Return angular velocities of bodies matching *mask* as (N,3) numpy array.")
+		.def("radii",&pyBodyContainer::radii,(py::arg("mask")=0),"Return radii of bodies matching *mask* as numpy array; NaN is returned for bodies which are not :yref:`spheres<Sphere>`.")
+		.def("setPositions",&pyBodyContainer::setPositions,(py::arg("ids"),py::arg("pos")),"Set positions of bodies given by *ids* from (len(ids),3) array *pos*.")
+		.def("setVelocities",&pyBodyContainer::setVelocities,(py::arg("ids"),py::arg("vel")),"Set linear velocities of bodies given by *ids* from (len(ids),3) array *vel*.")
+		.def("setAngularVelocities",&pyBodyContainer::setAngularVelocities,(py::arg("ids"),py::arg("angVel")),"Set angular velocities of bodies given by *ids* from (len(ids),3) array *angVel*.")
+		.def("stateArray",&pyBodyContainer::stateArray,(py::arg("ids")),"Return kinematic state of bodies given by *ids* as (len(ids),13) numpy array; columns are position (3), orientation quaternion as *w,x,y,z* (4), velocity (3) and angular velocity (3).")
+		.def("setStateArray",&pyBodyContainer::setStateArray,(py::arg("ids"),py::arg("states")),"Set kinematic state of bodies given by *ids* from array in the format of :yref:`stateArray<BodyContainer.stateArray>`.")
+		.def("serialize",&pyBodyContainer::serialize,(py::arg("ids")),"Return bodies given by *ids* (without their interactions) as binary string, which can be passed to :yref:`deserialize<BodyContainer.deserialize>`, possibly in another process (see :yref:`yade.mpy`).")
+		.def("deserialize",&pyBodyContainer::deserialize,(py::arg("data"),py::arg("ids")=vector<Body::id_t>()),"Insert bodies from string returned by :yref:`serialize<BodyContainer.serialize>`, with their original ids, or with *ids* if given (bodies with the same ids are replaced); materials are replaced by materials with the same :yref:`id<Material.id>` in this simulation. Returns list of ids.")
+		.def("insertAtId",&pyBodyContainer::insertAtId,(py::arg("body"),py::arg("id")),"Insert body with given *id*; the id must not be used by an existing body. Returns the id.")
+		.def("setBlockedDOFs",&pyBodyContainer::setBlockedDOFs,(py::arg("ids"),py::arg("dofs")),"Set :yref:`State.blockedDOFs` of bodies given by *ids* to *dofs* (string containing 'xyzXYZ').")
+		.def("appendSpheres",&pyBodyContainer::appendSpheres,(py::arg("centers"),py::arg("radii")=py::object(),py::arg("material")=-1,py::arg("mask")=1,py::arg("dynamic")=true),"Create and append many spheres at once; bodies are created in c++ (in parallel), which is much faster than appending :yref:`yade.utils.sphere` objects. *centers* is either (N,3) array with *radii* being array of length N or a single number, or a :yref:`SpherePack` (*radii* not given; clump information is ignored). *material* is a :yref:`Material` instance, label or id, shared by all spheres (defaults as in :yref:`yade.utils.sphere`). Returns ``(first,last+1)`` range of ids of the new bodies.");
 	py::class_<pyBodyIterator>("BodyIterator",py::init<pyBodyIterator&>())
 		.def("__iter__",&pyBodyIterator::pyIter)
 		.def("next",&pyBodyIterator::pyNext);
@@ -891,6 +1219,7 @@ BOOST_PYTHON_MODULE(wrapper)
 		.def("eraseNonReal",&pyInteractionContainer::eraseNonReal,"Erase all interactions that are not :yref:`real <InteractionContainer.isReal>`.")
 		.def("erase",&pyInteractionContainer::erase,"Erase one interaction, given by id1, id2 (internally, ``requestErase`` is called -- the interaction might still exist as potential, if the :yref:`Collider` decides so).")
 		.add_property("serializeSorted",&pyInteractionContainer::serializeSorted_get,&pyInteractionContainer::serializeSorted_set)
+		.def("arrays",&pyInteractionContainer::arrays,"Return real interactions as dictionary of numpy arrays with keys ``id1``, ``id2`` (ids of bodies), ``normal`` (:yref:`GenericSpheresContact.normal`), ``fn`` (:yref:`NormPhys.normalForce`) and ``fs`` (:yref:`NormShearPhys.shearForce`); vectors are (N,3) arrays. NaN is used where the geometry or physics does not provide the quantity.")
 		.def("clear",&pyInteractionContainer::clear,"Remove all interactions, and invalidate persistent collider data (if the collider supports it).");
 	py::class_<pyInteractionIterator>("InteractionIterator",py::init<pyInteractionIterator&>())
 		.def("__iter__",&pyInteractionIterator::pyIter)
@@ -910,6 +1239,7 @@ BOOST_PYTHON_MODULE(wrapper)
 		.def("addRot",&pyForceContainer::rot_add,(py::arg("id"),py::arg("r")),"Apply rotation on body (accumulates).")
 		.def("reset",&pyForceContainer::reset,(py::arg("resetAll")=true),"Reset the force container, including user defined permanent forces/torques. resetAll=False will keep permanent forces/torques unchanged.")
 		.def("getPermForceUsed",&pyForceContainer::getPermForceUsed,"Check wether permanent forces are present.")
+		.def("all",&pyForceContainer::all,"Return tuple of (forces,torques) on all bodies, as (len(O.bodies),3) numpy arrays indexed by body id. The container is synchronized first.")
 		.add_property("syncCount",&pyForceContainer::syncCount_get,&pyForceContainer::syncCount_set,"Number of synchronizations  of ForceContainer (cummulative); if significantly higher than number of steps, there might be unnecessary syncs hurting performance.")
 		;
 
@@ -921,7 +1251,7 @@ BOOST_PYTHON_MODULE(wrapper)
 		.def("__getitem__",&pyMaterialContainer::getitem_label)
 		.def("__len__",&pyMaterialContainer::len);
 
-	py::class_<STLImporter>("STLImporter").def("ymport",&STLImporter::import);
+	py::class_<STLImporter>("STLImporter").def("ymport",&STLImporter::import).def("ymportMesh",&STLImporter::importMesh);
 
 //////////////////////////////////////////////////////////////
 ///////////// proxyless wrappers 
@@ -114,6 +114,16 @@ def stl(file, dynamic=None,fixed=True,wire=True,color=None,highlight=False,noBou
 		b.aspherical=False
 	return facets
 
+def stlMesh(file,fixed=True,wire=True,color=None,highlight=False,noBound=False,material=-1):
+	"""Import geometry from stl file as one body with :yref:`TriMesh` shape (rather than one :yref:`Facet` per triangle, as :yref:`yade.ymport.stl` does), and return it. Use :yref:`Bo1_TriMesh_Aabb` and :yref:`Ig2_TriMesh_Sphere_ScGeom` with it."""
+	b=STLImporter().ymportMesh(file)
+	b.shape.color=color if color else utils.randomColor()
+	b.shape.wire=wire
+	b.shape.highlight=highlight
+	utils._commonBodySetup(b,0,Vector3(0,0,0),material=material,pos=b.state.pos,noBound=noBound,fixed=fixed)
+	b.aspherical=False
+	return b
+
 def gts(meshfile,shift=(0,0,0),scale=1.0,**kw):
 	""" Read given meshfile in gts format.
 
@@ -0,0 +1,26 @@
+# encoding: utf-8
+# measure the cost of O.deterministic on a full step (collider, interaction loop, integrator) with all threads
+# usage: yade -jN -x deterministic-benchmark.py [number of spheres] [number of steps]
+import sys,time
+from yade import pack,utils
+nSpheres=int(sys.argv[1]) if len(sys.argv)>1 else 20000
+nSteps=int(sys.argv[2]) if len(sys.argv)>2 else 500
+times={}
+for deterministic in (False,True):
+	O.reset()
+	O.bodies.append(utils.aabbWalls([(0,0,0),(1,1,1)],thickness=.1))
+	sp=pack.SpherePack(); sp.makeCloud((0,0,0),(1,1,1),num=nSpheres,rRelFuzz=.3,seed=1)
+	sp.toSimulation()
+	O.engines=[
+		ForceResetter(),
+		InsertionSortCollider([Bo1_Sphere_Aabb(),Bo1_Box_Aabb()]),
+		InteractionLoop([Ig2_Sphere_Sphere_ScGeom(),Ig2_Box_Sphere_ScGeom()],[Ip2_FrictMat_FrictMat_FrictPhys()],[Law2_ScGeom_FrictPhys_CundallStrack()]),
+		NewtonIntegrator(damping=.2,gravity=(0,0,-9.81)),
+	]
+	O.dt=.5*utils.PWaveTimeStep()
+	O.deterministic=deterministic
+	# let the packing settle into contact first
+	O.run(nSteps,True)
+	t0=time.time(); O.run(nSteps,True); times[deterministic]=(time.time()-t0)/nSteps
+	print 'deterministic=%s: %.3f ms/step, %d interactions'%(deterministic,times[deterministic]*1e3,len(O.interactions))
+print '%d threads, %d spheres: deterministic step takes %.2f times longer'%(O.numThreads,nSpheres,times[True]/times[False])
@@ -0,0 +1,43 @@
+"""
+Check that simulation decomposed with yade.mpy follows the serial one. Run as
+
+	mpirun -np 4 yade -n -x scripts/checks-and-tests/mpi-serial-compat.py
+
+Rank 0 runs the simulation serially first, then all processes run it decomposed;
+final positions are gathered at rank 0 and compared. Differences come only from
+different summation order of forces and must stay small over the (short) run.
+"""
+import sys
+from yade import pack,mpy
+mpy.initialize()
+
+nSteps,tolerance=2000,1e-6
+
+def buildScene(withBodies):
+	O.reset()
+	O.engines=[
+		ForceResetter(),
+		InsertionSortCollider([Bo1_Sphere_Aabb(),Bo1_Wall_Aabb()]),
+		InteractionLoop([Ig2_Sphere_Sphere_ScGeom(),Ig2_Wall_Sphere_ScGeom()],[Ip2_FrictMat_FrictMat_FrictPhys()],[Law2_ScGeom_FrictPhys_CundallStrack()]),
+		NewtonIntegrator(damping=.2,gravity=(1,0,-9.81))
+	]
+	if not withBodies: return
+	sp=pack.SpherePack(); sp.makeCloud((0,0,0),(4,1,1),rMean=.04,rRelFuzz=.2,seed=1)
+	O.bodies.append([utils.wall(0,axis=2,sense=1),utils.wall(0,axis=1,sense=1),utils.wall(1,axis=1,sense=-1)])
+	O.bodies.append([utils.sphere(c,r) for c,r in sp])
+	O.dt=.5*utils.PWaveTimeStep()
+
+if mpy.rank==0:
+	buildScene(True)
+	O.run(nSteps,True)
+	ref=dict((b.id,b.state.pos) for b in O.bodies if b.dynamic)
+# bodies are built at the root only, decompose sends every process its part
+buildScene(mpy.rank==0)
+mpy.decompose(axis=0)
+O.run(nSteps,True)
+ids,states=mpy.gatherStates()
+if mpy.rank==0:
+	if len(ids)!=len(ref): raise RuntimeError('Gathered %d bodies, %d expected.'%(len(ids),len(ref)))
+	err=max((Vector3(s[:3])-ref[int(i)]).norm() for i,s in zip(ids,states))
+	print 'Decomposed over %d processes: max position difference %g after %d steps.'%(mpy.numProcs,err,nSteps)
+	if err>tolerance: sys.exit(1)
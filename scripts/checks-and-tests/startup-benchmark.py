@@ -0,0 +1,16 @@
+# measure how long it takes to start yade and exit immediately
+# usage: python startup-benchmark.py path/to/yade-executable [number of runs]
+import sys,subprocess,time,os
+if len(sys.argv)<2: raise SystemExit('usage: %s yade-executable [runs]'%sys.argv[0])
+yade=sys.argv[1]
+runs=int(sys.argv[2]) if len(sys.argv)>2 else 10
+script=os.path.abspath('startup-benchmark-empty.py')
+open(script,'w').write('pass\n')
+times=[]
+for i in range(runs):
+	t0=time.time()
+	subprocess.check_call([yade,'-n','-x',script],stdout=open(os.devnull,'w'),stderr=subprocess.STDOUT)
+	times.append(time.time()-t0)
+os.remove(script)
+times.sort()
+print '%d runs of %s: min %.3fs, median %.3fs, max %.3fs'%(runs,yade,times[0],times[len(times)/2],times[-1])